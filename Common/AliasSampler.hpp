@@ -0,0 +1,224 @@
+/*
+ Copyright (c) 2012, Esteban Pellegrino
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright
+ notice, this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+ * Neither the name of the <organization> nor the
+ names of its contributors may be used to endorse or promote products
+ derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ALIASSAMPLER_HPP_
+#define ALIASSAMPLER_HPP_
+
+#include <algorithm>
+#include <map>
+#include <vector>
+#include <cassert>
+
+namespace Helios {
+
+	/*
+	 * Sample objects from discrete distributions that are fixed after setup (i.e. don't depend
+	 * on the energy of the particle, like a source or a multigroup transfer row). It uses the alias
+	 * method (Walker / Vose) : each row is split into equiprobable bins that contain at most two
+	 * outcomes, so a sample is taken in O(1) with a single random number and without a search.
+	 *
+	 * The constructors accept the same inputs than the Sampler class. The rows of the table (index
+	 * on the sample method) are the "energies" of the Sampler.
+	 */
+	template<class TypeReaction>
+	class AliasSampler {
+
+		/* Bin of the alias table */
+		struct Bin {
+			double probability; /* Probability of picking the outcome of this bin */
+			int alias;          /* Outcome picked otherwise */
+		};
+
+		/* Dimension of the table */
+		int nreaction;
+		int nenergy;
+
+		/* Container of reactions */
+		std::vector<TypeReaction> reactions;
+
+		/* Alias table (nenergy rows of nreaction bins) */
+		std::vector<Bin> table;
+
+		/* Probabilities of each reaction (nenergy rows of nreaction values) */
+		std::vector<double> probabilities;
+
+		/* Factor to map the value passed to sample into the bins of each row */
+		std::vector<double> scale;
+		/* If false, the value passed to sample is on [0,total weight of the row] */
+		bool normalize;
+
+		/* Get value in an index from different containers types */
+		static inline double getArrayIndex(int index,const std::vector<double>& stl_array) {
+			return stl_array[index];
+		}
+		static inline double getArrayIndex(int index,const std::vector<double>* stl_array_ptr) {
+			return stl_array_ptr->at(index);
+		}
+		/* In case is not a container (just a value) */
+		static inline double getArrayIndex(int index,const double& single_value) {
+			assert(index == 0);
+			return single_value;
+		}
+
+		/* Get size different containers types */
+		static inline int getArraySize(const std::vector<double>& stl_array) {
+			return stl_array.size();
+		}
+		static inline int getArraySize(const std::vector<double>* stl_array_ptr) {
+			return stl_array_ptr->size();
+		}
+		/* In case is not a container (just a value) */
+		static inline int getArraySize(const double& single_value) {
+			return 1;
+		}
+
+		/* Build the table from the (non normalized) weights of each row */
+		template<class ProbTable>
+		void setTable(const std::vector<ProbTable>& xs_container) {
+			table.resize(nreaction * nenergy);
+			probabilities.resize(nreaction * nenergy);
+			scale.resize(nenergy);
+			for(int nerg = 0 ; nerg < nenergy ; ++nerg) {
+				std::vector<double> row(nreaction);
+				for(int nrea = 0 ; nrea < nreaction ; ++nrea)
+					row[nrea] = getArrayIndex(nerg,xs_container[nrea]);
+				setRow(nerg, row);
+			}
+		}
+
+		/* Vose's algorithm on one row */
+		void setRow(int nerg, const std::vector<double>& weights);
+
+	public:
+
+		template<class ProbTable>
+		AliasSampler(const std::map<TypeReaction,ProbTable>& reaction_map) :
+			nreaction(reaction_map.size()), nenergy(getArraySize(reaction_map.begin()->second)), normalize(true) {
+			/* Separate the reactions from the cross sections */
+			std::vector<ProbTable> xs_container;
+			typename std::map<TypeReaction,ProbTable>::const_iterator it_rea = reaction_map.begin();
+			for(; it_rea != reaction_map.end() ; ++it_rea) {
+				reactions.push_back((*it_rea).first);
+				xs_container.push_back((*it_rea).second);
+			}
+			setTable(xs_container);
+		}
+
+		/*
+		 * If the table is normalized, the value passed to sample should be on [0,1]. Otherwise,
+		 * it should be on [0,total] where total is the sum of the weights of the row.
+		 */
+		template<class ProbTable>
+		AliasSampler(const std::vector<TypeReaction>& reactions, const std::vector<ProbTable>& xs_container, bool normalize = true) :
+			nreaction(reactions.size()), nenergy(getArraySize(*xs_container.begin())), reactions(reactions), normalize(normalize) {
+			/* Sanity check */
+			assert(xs_container.size() == reactions.size());
+			setTable(xs_container);
+		}
+
+		/*
+		 * Sample a reaction
+		 * index : row on the table
+		 * value : uniform random number on [0,1] (or [0,total] if the table is not normalized)
+		 */
+		TypeReaction sample(int index, double value) const {
+			/* The integer part selects the bin and the fractional part the outcome inside it */
+			double scaled = value * scale[index];
+			int bin = std::min((int)scaled, nreaction - 1);
+			const Bin& entry = table[index * nreaction + bin];
+			return reactions[(scaled - bin < entry.probability) ? bin : entry.alias];
+		}
+
+		/* Get reaction container */
+		const std::vector<TypeReaction>& getReactions() const {return reactions;}
+
+		/* Get number of energies */
+		int getEnergyNumber() const {return nenergy;}
+
+		/* Get probability of each reaction on a row */
+		const double* getProbabilities(int index = 0) const {return &probabilities[index * nreaction];}
+
+		~AliasSampler() {/* */};
+
+	};
+
+	template<class TypeReaction>
+	void AliasSampler<TypeReaction>::setRow(int nerg, const std::vector<double>& weights) {
+		Bin* bins = &table[nerg * nreaction];
+		double* prob = &probabilities[nerg * nreaction];
+
+		double total = 0.0;
+		for(int nrea = 0 ; nrea < nreaction ; ++nrea)
+			total += weights[nrea];
+
+		/* Map of the value passed to sample into the bins */
+		scale[nerg] = (normalize || total <= 0.0) ? nreaction : nreaction / total;
+
+		/* A row without weights (i.e. not fissile material) is left uniform, it shouldn't be sampled */
+		if(total <= 0.0) {
+			for(int nrea = 0 ; nrea < nreaction ; ++nrea) {
+				prob[nrea] = 0.0;
+				bins[nrea].probability = 1.0;
+				bins[nrea].alias = nrea;
+			}
+			return;
+		}
+
+		/* Probabilities scaled by the number of bins, split on bins under and over the average */
+		std::vector<double> scaled(nreaction);
+		std::vector<int> small, large;
+		for(int nrea = 0 ; nrea < nreaction ; ++nrea) {
+			prob[nrea] = weights[nrea] / total;
+			scaled[nrea] = weights[nrea] * nreaction / total;
+			if(scaled[nrea] < 1.0) small.push_back(nrea);
+			else large.push_back(nrea);
+		}
+
+		/* Fill each small bin with the excess of a large one */
+		while(!small.empty() && !large.empty()) {
+			int less = small.back(); small.pop_back();
+			int more = large.back(); large.pop_back();
+			bins[less].probability = scaled[less];
+			bins[less].alias = more;
+			scaled[more] = (scaled[more] + scaled[less]) - 1.0;
+			if(scaled[more] < 1.0) small.push_back(more);
+			else large.push_back(more);
+		}
+
+		/* Remaining bins are full (the ones on the small list are there because of round-off) */
+		for(std::vector<int>::const_iterator it = large.begin() ; it != large.end() ; ++it) {
+			bins[*it].probability = 1.0;
+			bins[*it].alias = *it;
+		}
+		for(std::vector<int>::const_iterator it = small.begin() ; it != small.end() ; ++it) {
+			bins[*it].probability = 1.0;
+			bins[*it].alias = *it;
+		}
+	}
+
+} /* namespace Helios */
+#endif /* ALIASSAMPLER_HPP_ */
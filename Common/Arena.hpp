@@ -0,0 +1,142 @@
+/*
+ Copyright (c) 2012, Esteban Pellegrino
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright
+ notice, this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+ * Neither the name of the <organization> nor the
+ names of its contributors may be used to endorse or promote products
+ derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ARENA_HPP_
+#define ARENA_HPP_
+
+#include <vector>
+#include <tbb/enumerable_thread_specific.h>
+
+namespace Helios {
+
+	/*
+	 * Contiguous storage of the (read-only) sampling tables of an isotope.
+	 *
+	 * Tables push their values while they are constructed and keep the offset of the data
+	 * on the arena (instead of a pointer), so the arena could grow during the construction and
+	 * the data is relocatable. Once an isotope is created the arena should not be modified.
+	 *
+	 * The arena used by the tables is the active one of the thread, set with a Scope object. If
+	 * none is active, a default arena of the thread is used.
+	 */
+	class Arena {
+		/* Data of the tables */
+		std::vector<double> data;
+
+		/* Active arena of the thread (isotopes could be created on parallel) */
+		static Arena*& current() {
+			static tbb::enumerable_thread_specific<Arena*> arena(static_cast<Arena*>(0));
+			return arena.local();
+		}
+
+		/* Default arena of the thread (used when no other is active) */
+		static Arena& global() {
+			static tbb::enumerable_thread_specific<Arena> arena;
+			return arena.local();
+		}
+
+		/* Prevent copy */
+		Arena(const Arena& other);
+		Arena& operator= (const Arena& other);
+
+	public:
+		Arena() {/* */}
+
+		/* Set the active arena while this object is alive */
+		class Scope {
+			Arena* previous;
+		public:
+			Scope(Arena* arena) : previous(current()) {current() = arena;}
+			~Scope() {current() = previous;}
+		};
+
+		/* Get the active arena */
+		static Arena& active() {
+			return current() ? *current() : global();
+		}
+
+		/* Push values into the arena and return the offset */
+		template<class Iterator>
+		size_t push(Iterator begin, Iterator end) {
+			size_t offset = data.size();
+			data.insert(data.end(), begin, end);
+			return offset;
+		}
+
+		/* Get pointer to the data at some offset */
+		const double* get(size_t offset) const {
+			return data.data() + offset;
+		}
+
+		/* Number of values on the arena */
+		size_t size() const {return data.size();}
+
+		/* Size of the arena (in bytes) */
+		size_t bytes() const {return data.capacity() * sizeof(double);}
+
+		/* Release the extra memory reserved during the construction */
+		void shrink() {
+			std::vector<double>(data).swap(data);
+		}
+
+		~Arena() {/* */}
+	};
+
+	/* Read only array stored on an arena (with the same interface of a constant vector) */
+	class ArenaArray {
+		/* Arena where the data is stored */
+		const Arena* arena;
+		/* Offset and number of values */
+		size_t offset;
+		size_t length;
+	public:
+		typedef double value_type;
+		typedef const double* const_iterator;
+
+		/* Empty array (on the active arena, so the data is always there) */
+		ArenaArray() : arena(&Arena::active()), offset(0), length(0) {/* */}
+
+		/* Push the values on the active arena */
+		ArenaArray(const std::vector<double>& values) : arena(&Arena::active()),
+			offset(Arena::active().push(values.begin(), values.end())), length(values.size()) {/* */}
+
+		const_iterator begin() const {return arena->get(offset);}
+		const_iterator end() const {return begin() + length;}
+
+		const double& operator[](size_t i) const {return *(begin() + i);}
+
+		size_t size() const {return length;}
+		bool empty() const {return length == 0;}
+
+		/* Copy the values into a vector */
+		std::vector<double> values() const {return std::vector<double>(begin(), end());}
+
+		~ArenaArray() {/* */}
+	};
+
+} /* namespace Helios */
+#endif /* ARENA_HPP_ */
@@ -34,6 +34,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <cmath>
 #include <algorithm>
 
+#include "GuideTable.hpp"
+
 namespace Helios {
 
 	/* Class to interpolate values using ENDF laws */
@@ -48,9 +50,9 @@ namespace Helios {
 			assert(nbt.size() == aint.size());
 		}
 
-		/* Return interpolated value */
+		/* Return interpolated value (the guide table is optional) */
 		template<class Iterator, class T>
-		double interpolate(Iterator xbegin, Iterator xend, Iterator ybegin, Iterator yend, const T& value) const {
+		double interpolate(Iterator xbegin, Iterator xend, Iterator ybegin, Iterator yend, const T& value, const GuideTable* guide) const {
 			typedef typename std::iterator_traits<Iterator>::value_type ValueType;
 			typedef typename std::iterator_traits<Iterator>::difference_type DistanceType;
 
@@ -68,7 +70,7 @@ namespace Helios {
 			/* Check size of ENDF parameters */
 			if(nbt.size() == 0) {
 				/* Linear - Linear assumed */
-				DistanceType idx = std::upper_bound(xbegin, xend, value) - xbegin - 1;
+				DistanceType idx = guide ? guide->index(xbegin, xend, value) : std::upper_bound(xbegin, xend, value) - xbegin - 1;
 				/* Get bounds values */
 				double y1 = *(ybegin + idx + 1) , y0 = *(ybegin + idx);
 				double x1 = *(xbegin + idx + 1) , x0 = *(xbegin + idx);
@@ -86,8 +88,9 @@ namespace Helios {
 					size_t high = nbt[i];
 					/* Check if we are inside this range */
 					if(value > *(xbegin + lower) && value <= *(xbegin + high - 1)) {
-						/* Binary search (get lower index) */
-						DistanceType idx = std::upper_bound(xbegin + lower, xbegin + high, value) - xbegin - 1;
+						/* Binary search (get lower index), the index on the whole grid is clamped to the region */
+						DistanceType idx = guide ? std::min(guide->index(xbegin, xend, value), high - 1) :
+								std::upper_bound(xbegin + lower, xbegin + high, value) - xbegin - 1;
 						/* Get interpolation type */
 						int type = aint[i];
 
@@ -142,6 +145,16 @@ namespace Helios {
 			return 0.0;
 		}
 
+		template<class Iterator, class T>
+		double interpolate(Iterator xbegin, Iterator xend, Iterator ybegin, Iterator yend, const T& value) const {
+			return interpolate(xbegin, xend, ybegin, yend, value, (const GuideTable*)0);
+		}
+
+		template<class Iterator, class T>
+		double interpolate(Iterator xbegin, Iterator xend, Iterator ybegin, Iterator yend, const T& value, const GuideTable& guide) const {
+			return interpolate(xbegin, xend, ybegin, yend, value, &guide);
+		}
+
 		~EndfInterpolate() {/* */}
 	};
 
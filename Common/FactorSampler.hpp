@@ -61,9 +61,26 @@ namespace Helios {
 	template<class TypeReaction>
 	class FactorSampler : public Sampler<TypeReaction> {
 
-		/* Get the index of the reaction after a binary search */
+		/* Number of reactions below which the linear scan is used instead of the binary search */
+		static const int linear_search = 64;
+
+		/* Get the index of the reaction */
 		int getIndex(const double* dat, double val, double factor);
 
+		/*
+		 * Same result as the binary search, counting the interpolated values lower than <val>. The
+		 * two rows are contiguous on memory and the loop is branch free, so it gets vectorized.
+		 */
+		int linearScan(const double* dat, double val, double factor) const {
+			int size = Sampler<TypeReaction>::nreaction - 1;
+			const double* low = dat;
+			const double* high = dat + size;
+			int count = 0;
+			for(int i = 0 ; i < size ; ++i)
+				count += (factor * (high[i] - low[i]) + low[i] < val);
+			return count;
+		}
+
 		/*
 		 * How reactions are specified
 		 *
@@ -89,7 +106,7 @@ namespace Helios {
 		 *
 		 * The sample method takes as an argument the lowest index (e-1) and the interpolation
 		 * factor (=0.50). This effect is accomplished combining the eval_lower_bound algorithm
-		 * and the Interpolate functor.
+		 * and the Interpolate functor (or with a linear scan over both rows for small tables).
 		 *
 		 */
 
@@ -155,6 +172,9 @@ namespace Helios {
 		const double* hi = dat + (Sampler<TypeReaction>::nreaction - 2);
 		if(val < interpolator(lo)) return 0;
 		if(val > interpolator(hi)) return Sampler<TypeReaction>::nreaction - 1;
+		/* Small materials, interpolate the whole row */
+		if(Sampler<TypeReaction>::nreaction <= linear_search)
+			return linearScan(dat, val, factor);
 		const double* value = eval_lower_bound(lo, hi + 1, val, interpolator);
 		return value - lo;
 	}
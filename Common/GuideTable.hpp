@@ -0,0 +1,113 @@
+/*
+ Copyright (c) 2012, Esteban Pellegrino
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright
+ notice, this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+ * Neither the name of the <organization> nor the
+ names of its contributors may be used to endorse or promote products
+ derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GUIDETABLE_HPP_
+#define GUIDETABLE_HPP_
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+namespace Helios {
+
+	/*
+	 * Guide table (Chen-Asau hashed index) over a sorted grid.
+	 *
+	 * The range of the grid is divided on equal bins (linear or logarithmic) and, for each bin,
+	 * the table keeps the first grid point that falls on it. A search is a hash of the value
+	 * followed by a binary search restricted to the (few) points of the bin. The index returned
+	 * is the same of std::upper_bound(begin, end, value) - begin - 1.
+	 */
+	class GuideTable {
+		/* Lower bound and inverse width of the bins */
+		double min_value;
+		double inv_width;
+		/* Logarithmic bins (for energy grids) */
+		bool logarithmic;
+		/* First grid point on each bin (plus one extra value, the size of the grid) */
+		std::vector<size_t> guide;
+
+		/* Bin of a value, clamped to the range of the table */
+		size_t bin(double value) const {
+			double x = logarithmic ? ((value > 0.0) ? log(value) : min_value) : value;
+			double scaled = (x - min_value) * inv_width;
+			if(!(scaled > 0.0)) return 0;
+			size_t nbins = guide.size() - 1;
+			if(scaled >= (double)nbins) return nbins - 1;
+			return (size_t)scaled;
+		}
+
+	public:
+		GuideTable() : min_value(0.0), inv_width(0.0), logarithmic(false) {/* */}
+
+		/* Build the table over a sorted grid (by default, one bin for each grid point) */
+		template<class Iterator>
+		GuideTable(Iterator begin, Iterator end, bool logarithmic = false, size_t nbins = 0) :
+			min_value(0.0), inv_width(0.0), logarithmic(logarithmic) {
+			size_t size = end - begin;
+			if(size == 0) return;
+			if(nbins == 0) nbins = size;
+
+			/* Range of the grid */
+			double low = *begin;
+			double high = *(end - 1);
+			if(logarithmic) {
+				/* Only positive values on a logarithmic grid */
+				Iterator first = std::upper_bound(begin, end, 0.0);
+				low = (first != end) ? log(*first) : 0.0;
+				high = (high > 0.0) ? log(high) : 0.0;
+			}
+			min_value = low;
+			inv_width = (high > low) ? (double)nbins / (high - low) : 0.0;
+
+			/*
+			 * Since bin() is monotonic, all the points before guide[i] are on lower bins and the
+			 * ones after guide[i + 1] on higher bins.
+			 */
+			guide.resize(nbins + 1, size);
+			guide[0] = 0;
+			size_t ipoint = 0;
+			for(size_t i = 1 ; i < nbins ; ++i) {
+				while(ipoint < size && bin(*(begin + ipoint)) < i) ++ipoint;
+				guide[i] = ipoint;
+			}
+		}
+
+		/* Get the lower index of the interval that contains the value */
+		template<class Iterator>
+		size_t index(Iterator begin, Iterator end, double value) const {
+			if(guide.empty())
+				return std::upper_bound(begin, end, value) - begin - 1;
+			size_t i = bin(value);
+			return std::upper_bound(begin + guide[i], begin + guide[i + 1], value) - begin - 1;
+		}
+
+		~GuideTable() {/* */}
+	};
+
+} /* namespace Helios */
+#endif /* GUIDETABLE_HPP_ */
@@ -30,6 +30,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <algorithm>
 
+#include "GuideTable.hpp"
+
 namespace Helios {
 
 	/* Interpolate a value and returns the interpolation factor (floating point) and the index (unsigned integer) */
@@ -62,6 +64,36 @@ namespace Helios {
 		return std::pair<size_t,double>(idx,(value - low) / (high - low));
 	}
 
+	/* Same as above, but the lower index is found using a guide table built over the grid */
+	template<class Iterator, class T>
+	std::pair<size_t, double> interpolate(Iterator begin, Iterator end, const T& value, const GuideTable& guide) {
+		typedef typename std::iterator_traits<Iterator>::value_type ValueType;
+		typedef typename std::iterator_traits<Iterator>::difference_type DistanceType;
+
+		/* Maximum and minimum values */
+		ValueType min_value = *begin;
+		ValueType max_value = *(end - 1);
+
+		/* Size of the grid */
+		DistanceType size = end - begin;
+
+		/* First check if the given energy is out of bound */
+		if(value <= min_value)
+			return std::pair<size_t,double>(0,0.0);
+		else if(value >= max_value)
+			return std::pair<size_t,double>(size - 2,1.0);
+
+		/* Get lower index */
+		DistanceType idx = guide.index(begin, end, value);
+
+		/* Energy bounds */
+		ValueType low = *(begin + idx);
+		ValueType high = *(begin + idx + 1);
+
+		/* Return factor */
+		return std::pair<size_t,double>(idx,(value - low) / (high - low));
+	}
+
 }
 
 #endif /* INTERPOLATE_HPP_ */
@@ -120,6 +120,7 @@ Log::Log() : messages(cout), oerror(cout), rank(0), current_map(with_color_map)
 
 /* Set output file */
 void Log::setOutput(const std::string& out_file) {
+	logger.output_name = out_file;
 	if(logger.rank == 0) {
 		/* Set output file */
 		Log::msg() << left << "Output file set to " << out_file << Log::endl;
@@ -145,6 +146,10 @@ void Log::nonColor() {
 	crst = "";
 }
 
+const std::string& Log::getOutput() {
+	return logger.output_name;
+}
+
 void Log::closeOutput() {
 	logger.output.close();
 }
@@ -84,6 +84,8 @@ public:
 
 	/* Set output file */
 	static void setOutput(const std::string& out_file);
+	/* Get name of the output file */
+	static const std::string& getOutput();
 
 	/* Set rank */
 	static void setRank(int rank);
@@ -147,6 +149,8 @@ private:
 	std::ostream& oerror;
 	/* Output file */
 	std::ofstream output;
+	/* Name of the output file */
+	std::string output_name;
 	/* Rank of this process */
 	int rank;
 	/* Map of colors */
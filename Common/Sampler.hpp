@@ -250,6 +250,11 @@ namespace Helios {
 		/* Get reaction matrix */
 		const double* getReactionMatrix() const {return reaction_matrix;}
 
+		/* Memory used by the reaction matrix and the reactions (in bytes) */
+		size_t getMemory() const {
+			return (nreaction - 1) * nenergy * sizeof(double) + reactions.capacity() * sizeof(TypeReaction);
+		}
+
 		~Sampler() {delete [] reaction_matrix;};
 
 	};
@@ -0,0 +1,79 @@
+/*
+ Copyright (c) 2012, Esteban Pellegrino
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright
+ notice, this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+ * Neither the name of the <organization> nor the
+ names of its contributors may be used to endorse or promote products
+ derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef THREADCOUNTERS_HPP_
+#define THREADCOUNTERS_HPP_
+
+#include <vector>
+#include <tbb/enumerable_thread_specific.h>
+
+namespace Helios {
+
+	/*
+	 * Event counters accumulated by each thread without synchronization.
+	 *
+	 * The transport could run on OpenMP or TBB threads, so each thread increments its own
+	 * copy of the counters and the copies are added when the gathering stops. The storage of
+	 * the threads only exists while the counters are active. A copy of the object starts
+	 * inactive.
+	 */
+	class ThreadCounters {
+		typedef tbb::enumerable_thread_specific<std::vector<size_t> > Counters;
+		/* Counters of each thread (null if not active) */
+		Counters* counters;
+	public:
+		ThreadCounters() : counters(0) {/* */}
+		ThreadCounters(const ThreadCounters& other) : counters(0) {/* */}
+		ThreadCounters& operator= (const ThreadCounters& other) {return *this;}
+
+		/* Check if the counters are active */
+		bool active() const {return counters != 0;}
+
+		/* Start counting on a number of counters (set to zero) */
+		void start(size_t size) {
+			delete counters;
+			counters = new Counters(std::vector<size_t>(size, 0));
+		}
+
+		/* Counters of the calling thread */
+		std::vector<size_t>& local() const {return counters->local();}
+
+		/* Stop counting and add the counts of all the threads to the totals (with the same size) */
+		void stop(std::vector<size_t>& totals) {
+			if(!counters) return;
+			for(Counters::const_iterator it = counters->begin() ; it != counters->end() ; ++it)
+				for(size_t i = 0 ; i < it->size() ; ++i)
+					totals[i] += (*it)[i];
+			delete counters;
+			counters = 0;
+		}
+
+		~ThreadCounters() {delete counters;}
+	};
+
+} /* namespace Helios */
+#endif /* THREADCOUNTERS_HPP_ */
@@ -75,25 +75,37 @@ namespace Helios {
 		 *
 		 * e-mn is the energy index of the particle (not the value). e-m0 (emin) is the smallest index from all
 		 * input cross section arrays.
+		 *
+		 * The jagged rows are stored one after the other on a single contiguous buffer, the row <i> lives
+		 * in the range [row_offset[i], row_offset[i + 1]).
 		 */
-		std::vector<std::vector<double> > reaction_matrix;
+		std::vector<double> reaction_matrix;
+		std::vector<size_t> row_offset;
+
+		/* Number of reactions below which the linear scan is used instead of the binary search */
+		static const size_t linear_search = 40;
 
-		/* Get the index of the reaction after a binary search */
-		size_t getIndex(size_t nrow, double val, double factor);
+		/* Get the index of the reaction */
+		size_t getIndex(size_t nrow, double val, double factor) const;
+
+		/* Number of values stored on a row */
+		size_t getRowSize(size_t nerg) const {
+			return row_offset[nerg + 1] - row_offset[nerg];
+		}
 
 		/* Get a value on the matrix */
-		double getMatrixValue(size_t nerg, size_t nrea) {
-			/* Get row */
-			std::vector<double>& row = reaction_matrix[nerg];
+		double getMatrixValue(size_t nerg, size_t nrea) const {
+			/* Get row size */
+			size_t size = getRowSize(nerg);
 			/* Get local coordinate */
-			int li = nrea - ((nreaction - 1) - row.size());
+			int li = nrea - ((nreaction - 1) - size);
 			/* Check out of range index */
 			if(li < 0) return 0.0;
-			else return row[li];
+			else return reaction_matrix[row_offset[nerg] + li];
 		}
 
 		/* Interpolate a value between two energies on the grid */
-		double intepolateMatrixValue(size_t nerg, size_t nrea, double factor) {
+		double intepolateMatrixValue(size_t nerg, size_t nrea, double factor) const {
 			/* Get limits */
 			double low_value = getMatrixValue(nerg,nrea);
 			double high_value = getMatrixValue(nerg + 1,nrea);
@@ -102,14 +114,9 @@ namespace Helios {
 		}
 
 		/* Extension of the STL lower_bound algorithm using a functor for evaluation */
-		size_t reaction_lower_bound(size_t nrow, double val, double factor) {
-			/* Low row */
-			std::vector<double>& low = reaction_matrix[nrow];
-			/* High row */
-			std::vector<double>& high = reaction_matrix[nrow + 1];
-
+		size_t reaction_lower_bound(size_t nrow, double val, double factor) const {
 			/* Get lower reaction index */
-			size_t first = ((nreaction - 1) - std::max(low.size(), high.size()));
+			size_t first = ((nreaction - 1) - std::max(getRowSize(nrow), getRowSize(nrow + 1)));
 			/* Last reaction index */
 			size_t last = nreaction - 1;
 			/* Initial length */
@@ -131,6 +138,46 @@ namespace Helios {
 			return first;
 		}
 
+		/*
+		 * Same result as reaction_lower_bound, but counting the interpolated partial sums lower than
+		 * the value. The loops are branch free and run over contiguous memory, so the compiler can
+		 * vectorize them.
+		 */
+		size_t reaction_linear_scan(size_t nrow, double val, double factor) const {
+			/* Rows sizes */
+			size_t low_size = getRowSize(nrow);
+			size_t high_size = getRowSize(nrow + 1);
+			/* Pointers to the end of each row (rows are aligned to the right) */
+			const double* low = &reaction_matrix[0] + row_offset[nrow + 1];
+			const double* high = &reaction_matrix[0] + row_offset[nrow + 2];
+
+			/* Get lower reaction index */
+			size_t first = ((nreaction - 1) - std::max(low_size, high_size));
+			size_t count = 0;
+			if(low_size <= high_size) {
+				/* Reactions with a zero value on the low energy */
+				const double* hp = high - high_size;
+				for(size_t i = 0 ; i < high_size - low_size ; ++i)
+					count += (factor * hp[i] < val);
+				/* Reactions defined on both energies */
+				const double* lp = low - low_size;
+				hp = high - low_size;
+				for(size_t i = 0 ; i < low_size ; ++i)
+					count += (lp[i] + factor * (hp[i] - lp[i]) < val);
+			} else {
+				/* Reactions with a zero value on the high energy */
+				const double* lp = low - low_size;
+				for(size_t i = 0 ; i < low_size - high_size ; ++i)
+					count += (lp[i] - factor * lp[i] < val);
+				/* Reactions defined on both energies */
+				lp = low - high_size;
+				const double* hp = high - high_size;
+				for(size_t i = 0 ; i < high_size ; ++i)
+					count += (lp[i] + factor * (hp[i] - lp[i]) < val);
+			}
+			return first + count;
+		}
+
 	public:
 
 		/* Functor to sort the cross sections */
@@ -174,9 +221,6 @@ namespace Helios {
 			/* Initialize the offset array */
 			offsets.resize(nenergy - emin);
 
-			/* Initialize reaction matrix */
-			reaction_matrix.resize(nenergy - emin);
-
 			for(size_t i = 0 ; i < offsets.size() ; ++i) {
 				offsets[i] = 0;
 				/* Loop to calculate offsets */
@@ -192,25 +236,30 @@ namespace Helios {
 				}
 			}
 
+			/* Initialize row offsets and the reaction matrix */
+			row_offset.resize(offsets.size() + 1);
+			row_offset[0] = 0;
+			for(size_t i = 0 ; i < offsets.size() ; ++i)
+				row_offset[i + 1] = row_offset[i] + (offsets[i] - 1);
+			reaction_matrix.resize(row_offset.back());
+
 			/* Loop over energies */
 			for(size_t i = 0 ; i < offsets.size() ; ++i) {
-				/* Get row */
-				std::vector<double>& row = reaction_matrix[i];
-				/* Resize matrix row */
-				row.resize(offsets[i] - 1);
+				/* Get row size */
+				size_t size = getRowSize(i);
 				/* Get absolute value of energy */
 				int nerg = emin + (int)i;
 				/* Calculate partial sums */
 				double partial_sum = 0.0;
-				for(size_t j = 0 ; j < row.size(); ++j) {
+				for(size_t j = 0 ; j < size; ++j) {
 					/* Get absolute index */
-					size_t rea = j + ((nreaction - 1) - row.size());
+					size_t rea = j + ((nreaction - 1) - size);
 					/* Cross section */
 					const Ace::CrossSection* xs = reas[rea].second;
 					/* Accumulate partial sum */
 					partial_sum += (*xs)[nerg];
 					/* Set value on the matrix */
-					row[j] = partial_sum;
+					reaction_matrix[row_offset[i] + j] = partial_sum;
 				}
 			}
 		}
@@ -222,24 +271,33 @@ namespace Helios {
 		 * is normalized, xs_min = 0.0 and xs_max = 1.0. <factor> is used to get an interpolated
 		 * value when doing the binary search.
 		 */
-		TypeReaction sample(int index, double value, double factor);
+		TypeReaction sample(int index, double value, double factor) const;
 
 		/* Get reaction container */
 		const std::vector<TypeReaction>& getReactions() const {return reactions;}
 
+		/* Memory used by the reaction matrix and the reactions (in bytes) */
+		size_t getMemory() const {
+			return reaction_matrix.capacity() * sizeof(double) + row_offset.capacity() * sizeof(size_t) +
+				   offsets.capacity() * sizeof(int) + reactions.capacity() * sizeof(TypeReaction);
+		}
+
 		~XsSampler() {/* */};
 	};
 
 	template<class TypeReaction>
-	size_t XsSampler<TypeReaction>::getIndex(size_t nrow, double val, double factor) {
+	size_t XsSampler<TypeReaction>::getIndex(size_t nrow, double val, double factor) const {
 		/* Initial boundaries */
 		if(val < intepolateMatrixValue(nrow, 0, factor)) return 0;
 		if(val > intepolateMatrixValue(nrow, nreaction - 2, factor)) return nreaction - 1;
+		/* Small set of reactions, a linear scan is faster than the binary search */
+		if((size_t)nreaction <= linear_search)
+			return reaction_linear_scan(nrow, val, factor);
 		return reaction_lower_bound(nrow, val, factor);
 	}
 
 	template<class TypeReaction>
-	TypeReaction XsSampler<TypeReaction>::sample(int index, double value, double factor) {
+	TypeReaction XsSampler<TypeReaction>::sample(int index, double value, double factor) const {
 		/* Check number of reactions */
 		if(nreaction == 1) return reactions[0];
 		/* Check index */
@@ -0,0 +1,139 @@
+/*
+ Copyright (c) 2012, Esteban Pellegrino
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright
+ notice, this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+ * Neither the name of the <organization> nor the
+ names of its contributors may be used to endorse or promote products
+ derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <time.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
+#include "../../Common/Common.hpp"
+#include "Benchmark.hpp"
+
+using namespace std;
+
+namespace Helios {
+
+/* Result of the kernels (to prevent dead code elimination) */
+static volatile double benchmark_sink = 0.0;
+
+/* Monotonic clock in nanoseconds */
+static inline uint64_t nanoseconds() {
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+BenchmarkSuite::Results BenchmarkSuite::run(const std::string& filter, size_t nops, size_t repetitions) const {
+	Results results;
+	for(vector<Benchmark*>::const_iterator it = benchmarks.begin() ; it != benchmarks.end() ; ++it) {
+		/* Check the filter */
+		if((*it)->getName().find(filter) == string::npos) continue;
+
+		/* Warm up */
+		benchmark_sink = benchmark_sink + (*it)->run(nops / 10 + 1);
+
+		/* Time each repetition */
+		vector<double> times;
+		for(size_t i = 0 ; i < repetitions ; ++i) {
+			uint64_t start = nanoseconds();
+			double value = (*it)->run(nops);
+			uint64_t end = nanoseconds();
+			benchmark_sink = benchmark_sink + value;
+			times.push_back((double)(end - start) / (double)nops);
+		}
+
+		/* Get the median */
+		sort(times.begin(), times.end());
+		results[(*it)->getName()] = times[times.size() / 2];
+	}
+	return results;
+}
+
+void BenchmarkSuite::print(std::ostream& out, const Results& results, const Results& baseline) {
+	out << left << setw(40) << "Benchmark" << right << setw(15) << "ns/op";
+	if(baseline.size() > 0)
+		out << setw(15) << "baseline" << setw(12) << "change";
+	out << endl;
+	Log::printLine(out, "-", baseline.size() > 0 ? 82 : 55);
+	out << endl;
+
+	for(Results::const_iterator it = results.begin() ; it != results.end() ; ++it) {
+		out << left << setw(40) << it->first << right << setw(15) << fixed << setprecision(2) << it->second;
+		Results::const_iterator it_base = baseline.find(it->first);
+		if(it_base != baseline.end()) {
+			double change = 100.0 * (it->second - it_base->second) / it_base->second;
+			out << setw(15) << it_base->second << setw(11) << showpos << change << noshowpos << "%";
+		}
+		out << endl;
+	}
+}
+
+std::vector<std::string> BenchmarkSuite::regressions(const Results& results, const Results& baseline, double tolerance) {
+	vector<string> slower;
+	for(Results::const_iterator it = results.begin() ; it != results.end() ; ++it) {
+		Results::const_iterator it_base = baseline.find(it->first);
+		if(it_base == baseline.end()) continue;
+		if(it->second > (1.0 + tolerance) * it_base->second)
+			slower.push_back(it->first);
+	}
+	return slower;
+}
+
+void BenchmarkSuite::save(const std::string& filename, const Results& results) {
+	ofstream out(filename.c_str());
+	if(!out.is_open())
+		throw(GeneralError("Cannot open the baseline file " + filename));
+	out << "# Helios++ micro-benchmarks (nanoseconds per operation)" << endl;
+	for(Results::const_iterator it = results.begin() ; it != results.end() ; ++it)
+		out << it->first << " " << setprecision(6) << it->second << endl;
+}
+
+BenchmarkSuite::Results BenchmarkSuite::load(const std::string& filename) {
+	ifstream in(filename.c_str());
+	if(!in.is_open())
+		throw(GeneralError("Cannot open the baseline file " + filename));
+	Results results;
+	string line;
+	while(getline(in, line)) {
+		/* Skip comments and empty lines */
+		if(line.empty() || line[0] == '#') continue;
+		/* Value is the last token of the line */
+		size_t pos = line.find_last_of(' ');
+		if(pos == string::npos) continue;
+		results[line.substr(0, pos)] = fromString<double>(line.substr(pos + 1));
+	}
+	return results;
+}
+
+BenchmarkSuite::~BenchmarkSuite() {
+	purgePointers(benchmarks);
+}
+
+} /* namespace Helios */
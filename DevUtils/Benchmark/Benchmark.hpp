@@ -0,0 +1,99 @@
+/*
+ Copyright (c) 2012, Esteban Pellegrino
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright
+ notice, this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+ * Neither the name of the <organization> nor the
+ names of its contributors may be used to endorse or promote products
+ derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BENCHMARK_HPP_
+#define BENCHMARK_HPP_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <iostream>
+
+namespace Helios {
+
+/*
+ * Micro-benchmark of a kernel. The setup is done on the constructor (it's not timed) and the
+ * run method should execute nops operations of the kernel, returning some value that depends
+ * on the result of each operation (so the compiler can't remove the work).
+ */
+class Benchmark {
+	/* Name of the benchmark */
+	std::string name;
+public:
+	Benchmark(const std::string& name) : name(name) {/* */}
+
+	/* Get name of this benchmark */
+	const std::string& getName() const {return name;}
+
+	/* Execute nops operations of the kernel */
+	virtual double run(size_t nops) = 0;
+
+	virtual ~Benchmark() {/* */}
+};
+
+/* Container of benchmarks, with the timing harness and the baseline comparison */
+class BenchmarkSuite {
+	/* Benchmarks (owned by the suite) */
+	std::vector<Benchmark*> benchmarks;
+public:
+	/* Result of each benchmark, in nanoseconds per operation */
+	typedef std::map<std::string,double> Results;
+
+	BenchmarkSuite() {/* */}
+
+	/* Push a new benchmark into the suite (the suite is responsible of deleting it) */
+	void pushBenchmark(Benchmark* benchmark) {benchmarks.push_back(benchmark);}
+
+	/*
+	 * Run benchmarks whose name contains the filter string. Each benchmark executes nops operations
+	 * several times (repetitions) and the median is reported.
+	 */
+	Results run(const std::string& filter, size_t nops, size_t repetitions) const;
+
+	/* Print the results (and the comparison against the baseline, if any) */
+	static void print(std::ostream& out, const Results& results, const Results& baseline = Results());
+
+	/*
+	 * Compare results against a baseline. Returns the names of the benchmarks that are slower than the
+	 * baseline by more than the given tolerance (relative).
+	 */
+	static std::vector<std::string> regressions(const Results& results, const Results& baseline, double tolerance);
+
+	/* Save and load results (plain text, one benchmark per line) */
+	static void save(const std::string& filename, const Results& results);
+	static Results load(const std::string& filename);
+
+	~BenchmarkSuite();
+
+private:
+	/* Prevent copy */
+	BenchmarkSuite(const BenchmarkSuite& other);
+	BenchmarkSuite& operator=(const BenchmarkSuite& other);
+};
+
+} /* namespace Helios */
+#endif /* BENCHMARK_HPP_ */
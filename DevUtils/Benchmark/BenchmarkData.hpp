@@ -0,0 +1,71 @@
+/*
+ Copyright (c) 2012, Esteban Pellegrino
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright
+ notice, this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+ * Neither the name of the <organization> nor the
+ names of its contributors may be used to endorse or promote products
+ derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BENCHMARKDATA_HPP_
+#define BENCHMARKDATA_HPP_
+
+#include <cmath>
+#include <algorithm>
+#include <vector>
+
+#include "../../Common/Common.hpp"
+#include "Benchmark.hpp"
+
+namespace Helios {
+
+namespace BenchmarkData {
+
+	/* Number of pre-sampled inputs on each benchmark (power of two) */
+	const size_t nsamples = 4096;
+
+	/* Sorted grid with npoints log-uniform values between emin and emax */
+	static inline std::vector<double> logGrid(Random& random, size_t npoints, double emin, double emax) {
+		std::vector<double> grid(npoints);
+		grid[0] = emin;
+		grid[npoints - 1] = emax;
+		for(size_t i = 1 ; i < npoints - 1 ; ++i)
+			grid[i] = emin * std::pow(emax / emin, random.uniform());
+		std::sort(grid.begin(), grid.end());
+		return grid;
+	}
+
+	/* Energies (log-uniform) to be used on the lookups */
+	static inline std::vector<double> logEnergies(Random& random, double emin, double emax) {
+		std::vector<double> energies(nsamples);
+		for(size_t i = 0 ; i < nsamples ; ++i)
+			energies[i] = emin * std::pow(emax / emin, random.uniform());
+		return energies;
+	}
+
+	/* Minimum and maximum energies of the synthetic grids */
+	const double emin = 1e-11;
+	const double emax = 20.0;
+
+}
+
+} /* namespace Helios */
+#endif /* BENCHMARKDATA_HPP_ */
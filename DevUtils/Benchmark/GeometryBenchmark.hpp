@@ -0,0 +1,183 @@
+/*
+ Copyright (c) 2012, Esteban Pellegrino
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright
+ notice, this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+ * Neither the name of the <organization> nor the
+ names of its contributors may be used to endorse or promote products
+ derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GEOMETRYBENCHMARK_HPP_
+#define GEOMETRYBENCHMARK_HPP_
+
+#include <sstream>
+
+#include "../../Common/Common.hpp"
+#include "../../Geometry/Geometry.hpp"
+#include "../../Geometry/Cell.hpp"
+#include "../../Geometry/Surface.hpp"
+#include "../../Material/Material.hpp"
+#include "BenchmarkData.hpp"
+
+namespace Helios {
+
+namespace BenchmarkData {
+
+	/* Pin cell of nrings concentric cylinders (pitch 0.1) inside a box with vacuum boundaries */
+	static inline Geometry* pinGeometry(size_t nrings) {
+		std::vector<McObject*> definitions;
+		double half = 0.1 * (nrings + 1);
+		/* Cylinders */
+		for(size_t i = 1 ; i <= nrings ; ++i)
+			definitions.push_back(new SurfaceObject(toString(i), "cz", std::vector<double>(1, 0.1 * i)));
+		/* Box */
+		const char* planes[3] = {"px", "py", "pz"};
+		for(size_t i = 0 ; i < 3 ; ++i) {
+			definitions.push_back(new SurfaceObject(toString(nrings + 2 * i + 1), planes[i],
+					std::vector<double>(1, -half), Surface::VACUUM));
+			definitions.push_back(new SurfaceObject(toString(nrings + 2 * i + 2), planes[i],
+					std::vector<double>(1, half), Surface::VACUUM));
+		}
+		/* Rings */
+		definitions.push_back(new CellObject("1", "-1", Cell::NONE, Universe::BASE, Universe::BASE, Material::VOID, Transformation()));
+		for(size_t i = 2 ; i <= nrings ; ++i)
+			definitions.push_back(new CellObject(toString(i), toString(i - 1) + " -" + toString(i), Cell::NONE,
+					Universe::BASE, Universe::BASE, Material::VOID, Transformation()));
+		/* Moderator */
+		std::ostringstream moderator;
+		moderator << nrings;
+		for(size_t i = 0 ; i < 3 ; ++i)
+			moderator << " " << nrings + 2 * i + 1 << " -" << nrings + 2 * i + 2;
+		definitions.push_back(new CellObject(toString(nrings + 1), moderator.str(), Cell::NONE,
+				Universe::BASE, Universe::BASE, Material::VOID, Transformation()));
+		Geometry* geometry = new Geometry(definitions, 0);
+		purgePointers(definitions);
+		return geometry;
+	}
+
+	/* Random point inside the box of the pin geometry */
+	static inline Coordinate pinPoint(Random& random, size_t nrings) {
+		double half = 0.1 * (nrings + 1);
+		return Coordinate(half * (2.0 * random.uniform() - 1.0), half * (2.0 * random.uniform() - 1.0),
+				          half * (2.0 * random.uniform() - 1.0));
+	}
+
+	/* Isotropic direction */
+	static inline Direction isotropic(Random& random) {
+		double mu = 2.0 * random.uniform() - 1.0;
+		double phi = 2.0 * M_PI * random.uniform();
+		double sq = std::sqrt(1.0 - mu * mu);
+		return Direction(sq * std::cos(phi), sq * std::sin(phi), mu);
+	}
+
+}
+
+/* Search of a point from the base universe */
+class GeometryFindCell : public Benchmark {
+	Geometry* geometry;
+	std::vector<Coordinate> points;
+public:
+	GeometryFindCell(size_t nrings) : Benchmark("Geometry::findCell") {
+		Random random(5);
+		geometry = BenchmarkData::pinGeometry(nrings);
+		for(size_t i = 0 ; i < BenchmarkData::nsamples ; ++i)
+			points.push_back(BenchmarkData::pinPoint(random, nrings));
+	}
+	double run(size_t nops) {
+		double acc = 0.0;
+		for(size_t i = 0 ; i < nops ; ++i)
+			acc += geometry->findCell(points[i & (BenchmarkData::nsamples - 1)])->getInternalId();
+		return acc;
+	}
+	~GeometryFindCell() {delete geometry;}
+};
+
+/* Distance to the closest surface of the cell */
+class CellIntersect : public Benchmark {
+	Geometry* geometry;
+	std::vector<const Cell*> cells;
+	std::vector<Coordinate> points;
+	std::vector<Direction> directions;
+public:
+	CellIntersect(size_t nrings) : Benchmark("Cell::intersect") {
+		Random random(6);
+		geometry = BenchmarkData::pinGeometry(nrings);
+		for(size_t i = 0 ; i < BenchmarkData::nsamples ; ++i) {
+			points.push_back(BenchmarkData::pinPoint(random, nrings));
+			directions.push_back(BenchmarkData::isotropic(random));
+			cells.push_back(geometry->findCell(points.back()));
+		}
+	}
+	double run(size_t nops) {
+		double acc = 0.0;
+		Surface* surface(0);
+		bool sense(true);
+		double distance(0.0);
+		for(size_t i = 0 ; i < nops ; ++i) {
+			size_t n = i & (BenchmarkData::nsamples - 1);
+			cells[n]->intersect(points[n], directions[n], surface, sense, distance);
+			acc += distance;
+		}
+		return acc;
+	}
+	~CellIntersect() {delete geometry;}
+};
+
+/* Search of the next cell after crossing an internal surface */
+class SurfaceCross : public Benchmark {
+	Geometry* geometry;
+	std::vector<const Surface*> surfaces;
+	std::vector<Coordinate> points;
+	std::vector<bool> senses;
+public:
+	SurfaceCross(size_t nrings) : Benchmark("Surface::cross") {
+		Random random(7);
+		geometry = BenchmarkData::pinGeometry(nrings);
+		while(surfaces.size() < BenchmarkData::nsamples) {
+			Coordinate position = BenchmarkData::pinPoint(random, nrings);
+			Direction direction = BenchmarkData::isotropic(random);
+			Surface* surface(0);
+			bool sense(true);
+			double distance(0.0);
+			geometry->findCell(position)->intersect(position, direction, surface, sense, distance);
+			/* Only surfaces that lead to another cell */
+			if(surface->getFlags() & Surface::VACUUM) continue;
+			surfaces.push_back(surface);
+			points.push_back(position + distance * direction);
+			senses.push_back(sense);
+		}
+	}
+	double run(size_t nops) {
+		double acc = 0.0;
+		for(size_t i = 0 ; i < nops ; ++i) {
+			size_t n = i & (BenchmarkData::nsamples - 1);
+			const Cell* cell(0);
+			bool sense(senses[n]);
+			surfaces[n]->cross(points[n], sense, cell);
+			if(cell) acc += cell->getInternalId();
+		}
+		return acc;
+	}
+	~SurfaceCross() {delete geometry;}
+};
+
+} /* namespace Helios */
+#endif /* GEOMETRYBENCHMARK_HPP_ */
@@ -0,0 +1,183 @@
+/*
+ Copyright (c) 2012, Esteban Pellegrino
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright
+ notice, this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+ * Neither the name of the <organization> nor the
+ names of its contributors may be used to endorse or promote products
+ derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GRIDBENCHMARK_HPP_
+#define GRIDBENCHMARK_HPP_
+
+#include "../../Common/Common.hpp"
+#include "../../Material/AceTable/AceReader/CrossSection.hpp"
+#include "../../Material/Grid/MasterGrid.hpp"
+#include "../../Common/FactorSampler.hpp"
+#include "../../Common/XsSampler.hpp"
+#include "BenchmarkData.hpp"
+
+namespace Helios {
+
+/* Lookup of an energy on the unionized grid (from scratch) */
+class MasterGridInterpolate : public Benchmark {
+	MasterGrid master;
+	std::vector<double> energies;
+public:
+	MasterGridInterpolate(size_t nchilds, size_t npoints) : Benchmark("MasterGrid::interpolate") {
+		Random random(1);
+		for(size_t i = 0 ; i < nchilds ; ++i) {
+			std::vector<double> grid = BenchmarkData::logGrid(random, npoints, BenchmarkData::emin, BenchmarkData::emax);
+			master.pushGrid(grid.begin(), grid.end());
+		}
+		master.setup();
+		energies = BenchmarkData::logEnergies(random, BenchmarkData::emin, BenchmarkData::emax);
+	}
+	double run(size_t nops) {
+		double acc = 0.0;
+		for(size_t i = 0 ; i < nops ; ++i) {
+			std::pair<size_t,double> energy(0, energies[i & (BenchmarkData::nsamples - 1)]);
+			acc += master.interpolate(energy);
+		}
+		return acc;
+	}
+};
+
+/* Mapping of a master index into each child grid */
+class ChildGridIndex : public Benchmark {
+	MasterGrid master;
+	std::vector<ChildGrid*> childs;
+	std::vector<std::pair<size_t,double> > energies;
+public:
+	ChildGridIndex(size_t nchilds, size_t npoints) : Benchmark("ChildGrid::index") {
+		Random random(2);
+		for(size_t i = 0 ; i < nchilds ; ++i) {
+			std::vector<double> grid = BenchmarkData::logGrid(random, npoints, BenchmarkData::emin, BenchmarkData::emax);
+			childs.push_back(master.pushGrid(grid.begin(), grid.end()));
+		}
+		master.setup();
+		/* Energies with the index on the master grid already set */
+		std::vector<double> values = BenchmarkData::logEnergies(random, BenchmarkData::emin, BenchmarkData::emax);
+		for(size_t i = 0 ; i < values.size() ; ++i) {
+			std::pair<size_t,double> energy(0, values[i]);
+			master.setIndex(energy);
+			energies.push_back(energy);
+		}
+	}
+	double run(size_t nops) {
+		double acc = 0.0;
+		size_t nchilds = childs.size();
+		for(size_t i = 0 ; i < nops ; ++i) {
+			std::pair<size_t,double> energy(energies[i & (BenchmarkData::nsamples - 1)]);
+			double factor(0.0);
+			acc += childs[i % nchilds]->index(energy, factor) + factor;
+		}
+		return acc;
+	}
+};
+
+/* Sampling of an isotope on a material (normalized table of nisotopes x npoints) */
+class FactorSamplerSample : public Benchmark {
+	FactorSampler<int>* sampler;
+	std::vector<int> indexes;
+	std::vector<double> factors;
+	std::vector<double> values;
+public:
+	FactorSamplerSample(size_t nisotopes, size_t npoints) : Benchmark("FactorSampler::sample") {
+		setup(nisotopes, npoints);
+	}
+	/* Same benchmark with a tag on the name (i.e. materials with a large number of isotopes) */
+	FactorSamplerSample(size_t nisotopes, size_t npoints, const std::string& tag) : Benchmark("FactorSampler::sample[" + tag + "]") {
+		setup(nisotopes, npoints);
+	}
+	void setup(size_t nisotopes, size_t npoints) {
+		Random random(3);
+		std::vector<int> isotopes;
+		std::vector<std::vector<double> > xs(nisotopes, std::vector<double>(npoints));
+		for(size_t i = 0 ; i < nisotopes ; ++i) {
+			isotopes.push_back(i);
+			for(size_t j = 0 ; j < npoints ; ++j)
+				xs[i][j] = random.uniform();
+		}
+		sampler = new FactorSampler<int>(isotopes, xs);
+		for(size_t i = 0 ; i < BenchmarkData::nsamples ; ++i) {
+			indexes.push_back((int)(random.uniform() * (npoints - 1)) % (npoints - 1));
+			factors.push_back(random.uniform());
+			values.push_back(random.uniform());
+		}
+	}
+	double run(size_t nops) {
+		double acc = 0.0;
+		for(size_t i = 0 ; i < nops ; ++i) {
+			size_t n = i & (BenchmarkData::nsamples - 1);
+			acc += sampler->sample(indexes[n], values[n], factors[n]);
+		}
+		return acc;
+	}
+	~FactorSamplerSample() {delete sampler;}
+};
+
+/* Sampling of a reaction on an isotope (cross sections with thresholds) */
+class XsSamplerSample : public Benchmark {
+	std::vector<Ace::CrossSection> cross_sections;
+	XsSampler<int>* sampler;
+	std::vector<int> indexes;
+	std::vector<double> factors;
+	std::vector<double> values;
+public:
+	XsSamplerSample(size_t nreactions, size_t npoints) : Benchmark("XsSampler::sample") {
+		Random random(4);
+		std::vector<double> total(npoints, 0.0);
+		/* First reaction covers the whole grid, the rest have a threshold on the lower half */
+		for(size_t i = 0 ; i < nreactions ; ++i) {
+			int ie = (i == 0) ? 1 : 1 + (int)(random.uniform() * (npoints / 2));
+			std::vector<double> xs(npoints - ie + 1);
+			for(size_t j = 0 ; j < xs.size() ; ++j) {
+				xs[j] = random.uniform();
+				total[j + ie - 1] += xs[j];
+			}
+			cross_sections.push_back(Ace::CrossSection(ie, xs));
+		}
+		std::vector<std::pair<int,const Ace::CrossSection*> > reactions;
+		for(size_t i = 0 ; i < nreactions ; ++i)
+			reactions.push_back(std::pair<int,const Ace::CrossSection*>(i, &cross_sections[i]));
+		sampler = new XsSampler<int>(reactions);
+		for(size_t i = 0 ; i < BenchmarkData::nsamples ; ++i) {
+			int index = (int)(random.uniform() * (npoints - 1)) % (npoints - 1);
+			double factor = random.uniform();
+			indexes.push_back(index);
+			factors.push_back(factor);
+			values.push_back(random.uniform() * (total[index] + factor * (total[index + 1] - total[index])));
+		}
+	}
+	double run(size_t nops) {
+		double acc = 0.0;
+		for(size_t i = 0 ; i < nops ; ++i) {
+			size_t n = i & (BenchmarkData::nsamples - 1);
+			acc += sampler->sample(indexes[n], values[n], factors[n]);
+		}
+		return acc;
+	}
+	~XsSamplerSample() {delete sampler;}
+};
+
+} /* namespace Helios */
+#endif /* GRIDBENCHMARK_HPP_ */
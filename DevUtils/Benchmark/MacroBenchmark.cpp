@@ -0,0 +1,275 @@
+/*
+ Copyright (c) 2012, Esteban Pellegrino
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright
+ notice, this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+ * Neither the name of the <organization> nor the
+ names of its contributors may be used to endorse or promote products
+ derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#include <cstdio>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <boost/mpi.hpp>
+#include <boost/program_options.hpp>
+
+#include "../../Parser/ParserTypes.hpp"
+#include "../../Environment/McEnvironment.hpp"
+
+using namespace std;
+using namespace Helios;
+namespace mpi = boost::mpi;
+namespace po = boost::program_options;
+
+/* Directory of the benchmark problems (set by the build system) */
+#ifndef HELIOS_PROBLEMS
+#define HELIOS_PROBLEMS "."
+#endif
+
+/* Result of running a problem with some multithreading policy */
+struct Run {
+	string problem;
+	string policy;
+	int threads;
+	double seconds;     /* Time on the simulation (setup not included) */
+	double neutrons;    /* Number of histories simulated */
+	long memory;        /* Memory high-water mark (kB) */
+	double rate() const {return neutrons / seconds;}
+};
+
+/*
+ * Run a problem on a child process, so each run starts from a clean address space (and
+ * the memory high-water mark is the one of this run only).
+ */
+static bool runProblem(int argc, char** argv, const vector<string>& input_files, const map<string,string>& criticality,
+		               Run& run) {
+	/* Pipe to get the timing from the child */
+	int fd[2];
+	if(pipe(fd) != 0) return false;
+
+	/* Flush before fork, so the child doesn't print the buffered output again */
+	cout.flush();
+	fflush(stdout);
+
+	pid_t pid = fork();
+	if(pid < 0) return false;
+
+	if(pid == 0) {
+		close(fd[0]);
+		/* The output of the simulation goes into a log file */
+		string prefix = run.problem + "-" + run.policy + "-" + toString(run.threads);
+		if(!freopen((prefix + ".log").c_str(), "w", stdout)) exit(1);
+
+		double result[2] = {0.0, 0.0};
+		try {
+			XmlParser parser;
+			McEnvironment environment(argc, argv, &parser);
+			Log::setOutput(prefix + ".output");
+			environment.parseFiles(input_files);
+			/* Settings of this run (replace the ones of the input files) */
+			environment.pushObject(new SettingsObject("multithread", run.policy));
+			environment.pushObject(new SettingsObject("threads", toString(run.threads)));
+			if(criticality.size() > 0)
+				environment.pushObject(new SettingsObject("criticality", criticality));
+			environment.setup();
+
+			/* Time only the simulation */
+			mpi::timer timer;
+			environment.simulate();
+			result[0] = timer.elapsed();
+			result[1] = (double) environment.getSetting<size_t>("criticality", "particles")
+					  * (double) environment.getSetting<size_t>("criticality", "batches");
+		} catch(exception& error) {
+			Log::error() << error.what() << Log::endl;
+			exit(1);
+		}
+
+		if(write(fd[1], result, sizeof(result)) != sizeof(result)) exit(1);
+		close(fd[1]);
+		Log::closeOutput();
+		exit(0);
+	}
+
+	close(fd[1]);
+	double result[2] = {0.0, 0.0};
+	ssize_t nread = read(fd[0], result, sizeof(result));
+	close(fd[0]);
+
+	/* Wait for the child and get the resources it used */
+	int status(0);
+	struct rusage usage;
+	wait4(pid, &status, 0, &usage);
+	if(nread != sizeof(result) || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+		return false;
+
+	run.seconds = result[0];
+	run.neutrons = result[1];
+	run.memory = usage.ru_maxrss;
+	return true;
+}
+
+int main(int argc, char **argv) {
+
+	/* Print header, always */
+	cout << endl;
+	Log::header();
+
+	/* Map of command line values */
+	po::variables_map vm;
+
+	/* Default thread counts (powers of two up to the available cores) */
+	vector<int> default_threads;
+	int ncores = sysconf(_SC_NPROCESSORS_ONLN);
+	for(int n = 1 ; n < ncores ; n *= 2)
+		default_threads.push_back(n);
+	default_threads.push_back(ncores > 0 ? ncores : 1);
+
+	/* Declare a group of options that configure the benchmarks */
+	po::options_description config("Allowed options");
+	config.add_options()
+		("help", "produce help message")
+		("path,p", po::value<string>()->default_value(HELIOS_PROBLEMS),
+			 "directory of the benchmark problems")
+		("problem", po::value<vector<string> >()->multitoken(),
+			 "problems to run (pin, assembly, core)")
+		("policy", po::value<vector<string> >()->multitoken(),
+			 "multithreading policies (single, omp, tbb)")
+		("threads,t", po::value<vector<int> >()->multitoken(),
+			 "thread counts (default : powers of two up to the number of cores)")
+		("particles", po::value<size_t>(),
+			 "particles per batch (overrides the problem settings)")
+		("batches", po::value<size_t>(),
+			 "number of batches (overrides the problem settings)")
+		("inactive", po::value<size_t>(),
+			 "number of inactive batches (overrides the problem settings)")
+		("report,r", po::value<string>()->default_value("macrobench.csv"),
+			 "file where the report is saved (CSV)")
+		;
+
+	try {
+		po::store(po::parse_command_line(argc, argv, config), vm);
+		po::notify(vm);
+	} catch(exception& e) {
+		cout << e.what() << endl;
+		return 1;
+	}
+
+	if (vm.count("help")) {
+		Log::msg() << config << endl;
+		return 0;
+	}
+
+	string path = vm["path"].as<string>();
+	vector<string> problems;
+	if(vm.count("problem")) problems = vm["problem"].as<vector<string> >();
+	else {
+		problems.push_back("pin");
+		problems.push_back("assembly");
+		problems.push_back("core");
+	}
+	vector<string> policies;
+	if(vm.count("policy")) policies = vm["policy"].as<vector<string> >();
+	else {
+		policies.push_back("single");
+		policies.push_back("omp");
+		policies.push_back("tbb");
+	}
+	vector<int> threads = vm.count("threads") ? vm["threads"].as<vector<int> >() : default_threads;
+
+	/* Criticality settings given by the user */
+	map<string,string> criticality;
+	const char* keys[3] = {"particles", "batches", "inactive"};
+	for(size_t i = 0 ; i < 3 ; ++i)
+		if(vm.count(keys[i])) criticality[keys[i]] = toString(vm[keys[i]].as<size_t>());
+	/* The setting is replaced as a whole, so all the values should be given */
+	if(criticality.size() > 0 && criticality.size() < 3) {
+		Log::error() << "The options particles, batches and inactive should be given together" << Log::endl;
+		return 1;
+	}
+
+	/* Run each problem */
+	vector<Run> runs;
+	for(vector<string>::const_iterator it_problem = problems.begin() ; it_problem != problems.end() ; ++it_problem) {
+		/* Input files of the problem */
+		vector<string> input_files;
+		input_files.push_back(path + "/materials.xml");
+		input_files.push_back(path + "/" + (*it_problem) + ".xml");
+		input_files.push_back(path + "/" + (*it_problem) + "-source.xml");
+		input_files.push_back(path + "/" + (*it_problem) + "-settings.xml");
+
+		for(vector<string>::const_iterator it_policy = policies.begin() ; it_policy != policies.end() ; ++it_policy) {
+			/* The single thread policy is run only once */
+			vector<int> policy_threads = ((*it_policy) == "single") ? vector<int>(1, 1) : threads;
+			for(vector<int>::const_iterator it_threads = policy_threads.begin() ; it_threads != policy_threads.end() ; ++it_threads) {
+				Run run;
+				run.problem = *it_problem;
+				run.policy = *it_policy;
+				run.threads = *it_threads;
+
+				Log::msg() << left << " - Running " << setw(10) << run.problem << " policy = " << setw(8) << run.policy
+						   << " threads = " << run.threads << Log::endl;
+
+				if(!runProblem(argc, argv, input_files, criticality, run)) {
+					Log::error() << "Problem " << run.problem << " failed (see " << run.problem << "-" << run.policy
+							     << "-" << run.threads << ".log)" << Log::endl;
+					continue;
+				}
+				runs.push_back(run);
+			}
+		}
+	}
+
+	/* Reference rate (per thread) of each problem : single thread policy, or the first run if it is not available */
+	map<string,double> reference;
+	for(vector<Run>::const_iterator it = runs.begin() ; it != runs.end() ; ++it)
+		if(reference.find(it->problem) == reference.end() || it->policy == "single")
+			reference[it->problem] = it->rate() / it->threads;
+
+	/* Report */
+	ofstream out(vm["report"].as<string>().c_str());
+	out << "problem,policy,threads,neutrons,seconds,neutrons_per_second,efficiency,memory_kb" << endl;
+	cout << endl << left << setw(10) << "problem" << setw(8) << "policy" << right << setw(8) << "threads"
+		 << setw(16) << "neutrons/sec" << setw(12) << "efficiency" << setw(14) << "memory (MB)" << endl;
+	Log::printLine(cout, "-", 68);
+	cout << endl;
+	for(vector<Run>::const_iterator it = runs.begin() ; it != runs.end() ; ++it) {
+		/* Scaling efficiency with respect to the reference */
+		double efficiency = it->rate() / (it->threads * reference[it->problem]);
+		out << it->problem << "," << it->policy << "," << it->threads << "," << it->neutrons << "," << it->seconds
+			<< "," << it->rate() << "," << efficiency << "," << it->memory << endl;
+		cout << left << setw(10) << it->problem << setw(8) << it->policy << right << setw(8) << it->threads
+			 << setw(16) << fixed << setprecision(1) << it->rate() << setw(12) << setprecision(3) << efficiency
+			 << setw(14) << setprecision(1) << it->memory / 1024.0 << endl;
+	}
+
+	Log::msg() << endl << "Report saved on " << vm["report"].as<string>() << Log::endl;
+
+	return 0;
+}
@@ -0,0 +1,129 @@
+/*
+ Copyright (c) 2012, Esteban Pellegrino
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright
+ notice, this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+ * Neither the name of the <organization> nor the
+ names of its contributors may be used to endorse or promote products
+ derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <boost/program_options.hpp>
+
+#include "../../Common/Common.hpp"
+#include "Benchmark.hpp"
+#include "GridBenchmark.hpp"
+#include "GeometryBenchmark.hpp"
+#include "ReactionBenchmark.hpp"
+
+using namespace std;
+using namespace Helios;
+namespace po = boost::program_options;
+
+/* Energy laws with a benchmark */
+static const int energy_laws[] = {1, 3, 4, 7, 9, 11, 44, 61, 66};
+static const int heavy_laws[] = {4, 44, 61};
+
+int main(int argc, char **argv) {
+
+	/* Print header, always */
+	cout << endl;
+	Log::header();
+
+	/* Map of command line values */
+	po::variables_map vm;
+
+	/* Declare a group of options that configure the benchmarks */
+	po::options_description config("Allowed options");
+	config.add_options()
+		("help", "produce help message")
+		("filter,f", po::value<string>()->default_value(""),
+			 "run only benchmarks whose name contains this string")
+		("operations,n", po::value<size_t>()->default_value(1000000),
+			 "number of operations on each repetition")
+		("repetitions,r", po::value<size_t>()->default_value(7),
+			 "number of repetitions (the median is reported)")
+		("save,s", po::value<string>(),
+			 "save the results on this file")
+		("baseline,b", po::value<string>(),
+			 "compare the results against a baseline file")
+		("tolerance,t", po::value<double>()->default_value(0.10),
+			 "relative slowdown (with respect to the baseline) considered as a regression")
+		;
+
+	try {
+		po::store(po::parse_command_line(argc, argv, config), vm);
+		po::notify(vm);
+	} catch(exception& e) {
+		cout << e.what() << endl;
+		return 1;
+	}
+
+	if (vm.count("help")) {
+		Log::msg() << config << endl;
+		return 0;
+	}
+
+	/* Setup the benchmarks (synthetic data, sizes of a typical continuous energy problem) */
+	BenchmarkSuite suite;
+	suite.pushBenchmark(new MasterGridInterpolate(50, 10000));
+	suite.pushBenchmark(new ChildGridIndex(50, 10000));
+	suite.pushBenchmark(new FactorSamplerSample(50, 100000));
+	suite.pushBenchmark(new FactorSamplerSample(200, 20000, "large"));
+	suite.pushBenchmark(new XsSamplerSample(30, 10000));
+	suite.pushBenchmark(new GeometryFindCell(10));
+	suite.pushBenchmark(new CellIntersect(10));
+	suite.pushBenchmark(new SurfaceCross(10));
+	for(size_t i = 0 ; i < sizeof(energy_laws) / sizeof(int) ; ++i)
+		suite.pushBenchmark(new EnergyLawSetEnergy(energy_laws[i]));
+	/* Inelastic scattering on heavy nuclides (large tabular distributions) */
+	for(size_t i = 0 ; i < sizeof(heavy_laws) / sizeof(int) ; ++i)
+		suite.pushBenchmark(new EnergyLawSetEnergy(heavy_laws[i], BenchmarkData::heavy_nein, BenchmarkData::heavy_neout, "heavy"));
+	suite.pushBenchmark(new ElasticScatteringCollision());
+
+	/* Run */
+	BenchmarkSuite::Results results = suite.run(vm["filter"].as<string>(), vm["operations"].as<size_t>(),
+			                                    vm["repetitions"].as<size_t>());
+
+	/* Baseline */
+	BenchmarkSuite::Results baseline;
+	if(vm.count("baseline")) {
+		try {
+			baseline = BenchmarkSuite::load(vm["baseline"].as<string>());
+		} catch(exception& error) {
+			Log::error() << error.what() << Log::endl;
+			return 1;
+		}
+	}
+
+	BenchmarkSuite::print(cout, results, baseline);
+
+	if(vm.count("save"))
+		BenchmarkSuite::save(vm["save"].as<string>(), results);
+
+	/* Check regressions */
+	vector<string> slower = BenchmarkSuite::regressions(results, baseline, vm["tolerance"].as<double>());
+	for(vector<string>::const_iterator it = slower.begin() ; it != slower.end() ; ++it)
+		Log::warn() << "Regression on " << (*it) << Log::endl;
+
+	return slower.empty() ? 0 : 2;
+}
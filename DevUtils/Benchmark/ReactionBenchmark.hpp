@@ -0,0 +1,274 @@
+/*
+ Copyright (c) 2012, Esteban Pellegrino
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright
+ notice, this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+ * Neither the name of the <organization> nor the
+ names of its contributors may be used to endorse or promote products
+ derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef REACTIONBENCHMARK_HPP_
+#define REACTIONBENCHMARK_HPP_
+
+#include <cmath>
+
+#include "../../Common/Common.hpp"
+#include "../../Transport/Particle.hpp"
+#include "../../Material/AceTable/AceReader/EnergyDistribution.hpp"
+#include "../../Material/AceTable/AceReader/AngularDistribution.hpp"
+#include "../../Material/AceTable/AceReaction/EnergyLaws/EnergyLaws.hpp"
+#include "../../Material/AceTable/AceReaction/MuSampler.hpp"
+#include "../../Material/AceTable/AceReaction/ElasticScattering.hpp"
+#include "BenchmarkData.hpp"
+
+namespace Helios {
+
+namespace BenchmarkData {
+
+	/* Incident energies (MeV) of the synthetic laws */
+	static inline std::vector<double> incidentGrid(size_t npoints, double emin, double emax) {
+		std::vector<double> grid(npoints);
+		for(size_t i = 0 ; i < npoints ; ++i)
+			grid[i] = emin * std::pow(emax / emin, (double)i / (double)(npoints - 1));
+		return grid;
+	}
+
+	/* Maxwellian shaped (lin-lin) tabular distribution on [0,emax] */
+	template<class EnergyData>
+	static inline void maxwellTable(size_t npoints, double emax, EnergyData& data) {
+		double temperature = emax / 4.0;
+		data.intt = 2;
+		data.eout.resize(npoints);
+		data.pdf.resize(npoints);
+		data.cdf.resize(npoints);
+		for(size_t i = 0 ; i < npoints ; ++i) {
+			data.eout[i] = emax * (double)i / (double)(npoints - 1);
+			data.pdf[i] = std::sqrt(data.eout[i]) * std::exp(-data.eout[i] / temperature);
+		}
+		/* Integrate and normalize */
+		data.cdf[0] = 0.0;
+		for(size_t i = 1 ; i < npoints ; ++i)
+			data.cdf[i] = data.cdf[i - 1] + 0.5 * (data.pdf[i] + data.pdf[i - 1]) * (data.eout[i] - data.eout[i - 1]);
+		double total = data.cdf[npoints - 1];
+		for(size_t i = 0 ; i < npoints ; ++i) {
+			data.pdf[i] /= total;
+			data.cdf[i] /= total;
+		}
+	}
+
+	/* Common data of all the synthetic laws (single law with probability one) */
+	template<class AceLaw>
+	static inline AceLaw* aceLaw() {
+		std::vector<double> range(2);
+		range[0] = 1e-11; range[1] = 20.0;
+		return new AceLaw(0, 0, 0, std::vector<int>(), std::vector<int>(), 2, range, std::vector<double>(2, 1.0));
+	}
+
+	/* Number of incident energies and outgoing points on the synthetic tables */
+	const size_t nein = 20;
+	const size_t neout = 32;
+
+	/* Sizes of the continuum inelastic tables of a heavy nuclide (i.e. U-238) */
+	const size_t heavy_nein = 100;
+	const size_t heavy_neout = 400;
+
+	/* Construct each energy law (Helios) from synthetic ACE data */
+	static inline AceReaction::AceEnergyLaw* energyLaw(int law, size_t nein = BenchmarkData::nein, size_t neout = BenchmarkData::neout) {
+		typedef Ace::EnergyDistribution AceLaws;
+		std::vector<double> ein = incidentGrid(nein, 1e-5, 20.0);
+		AceReaction::AceEnergyLaw* energy_law(0);
+		switch(law) {
+		case 1: {
+			AceLaws::Law1* ace = aceLaw<AceLaws::Law1>();
+			ace->ein = ein;
+			for(size_t i = 0 ; i < nein ; ++i) {
+				std::vector<double> bins(neout + 1);
+				for(size_t j = 0 ; j <= neout ; ++j)
+					bins[j] = ein[i] * std::pow((double)j / (double)neout, 2);
+				ace->eout.push_back(bins);
+			}
+			energy_law = new AceReaction::EnergyLaw1(ace);
+			delete ace;
+			break;
+		}
+		case 3: {
+			AceLaws::Law3* ace = aceLaw<AceLaws::Law3>();
+			ace->ldat1 = 1.0;
+			ace->ldat2 = 0.9;
+			energy_law = new AceReaction::EnergyLaw3(ace);
+			delete ace;
+			break;
+		}
+		case 4: {
+			AceLaws::Law4* ace = aceLaw<AceLaws::Law4>();
+			ace->ein = ein;
+			for(size_t i = 0 ; i < nein ; ++i) {
+				AceLaws::Law4::EnergyData data;
+				maxwellTable(neout, ein[i], data);
+				data.np = neout;
+				ace->eout_dist.push_back(data);
+			}
+			energy_law = new AceReaction::EnergyLaw4(ace);
+			delete ace;
+			break;
+		}
+		case 7:
+		case 9: {
+			/* Maxwell fission spectrum and evaporation spectrum share the same data */
+			std::vector<double> t(nein);
+			for(size_t i = 0 ; i < nein ; ++i)
+				t[i] = 1.0 + 0.02 * ein[i];
+			if(law == 7) {
+				AceLaws::Law7* ace = aceLaw<AceLaws::Law7>();
+				ace->ein = ein; ace->t = t; ace->u = -20.0;
+				energy_law = new AceReaction::EnergyLaw7(ace);
+				delete ace;
+			} else {
+				AceLaws::Law9* ace = aceLaw<AceLaws::Law9>();
+				ace->ein = ein; ace->t = t; ace->u = -20.0;
+				energy_law = new AceReaction::EnergyLaw9(ace);
+				delete ace;
+			}
+			break;
+		}
+		case 11: {
+			AceLaws::Law11* ace = aceLaw<AceLaws::Law11>();
+			ace->eina = ein; ace->einb = ein;
+			ace->a = std::vector<double>(nein, 0.988);
+			ace->b = std::vector<double>(nein, 2.249);
+			ace->u = -20.0;
+			energy_law = new AceReaction::EnergyLaw11(ace);
+			delete ace;
+			break;
+		}
+		case 44: {
+			AceLaws::Law44* ace = aceLaw<AceLaws::Law44>();
+			ace->ein = ein;
+			for(size_t i = 0 ; i < nein ; ++i) {
+				AceLaws::Law44::EnergyData data;
+				maxwellTable(neout, ein[i], data);
+				data.np = neout;
+				data.r = std::vector<double>(neout, 0.3);
+				data.a = std::vector<double>(neout, 1.5);
+				ace->eout_dist.push_back(data);
+			}
+			energy_law = new AceReaction::EnergyLaw44(ace);
+			delete ace;
+			break;
+		}
+		case 61: {
+			AceLaws::Law61* ace = aceLaw<AceLaws::Law61>();
+			ace->ein = ein;
+			for(size_t i = 0 ; i < nein ; ++i) {
+				AceLaws::Law4::EnergyData data;
+				maxwellTable(neout, ein[i], data);
+				/* XSS array of the table (isotropic cosine on each outgoing bin) */
+				std::vector<double> xss;
+				xss.push_back(data.intt);
+				xss.push_back(neout);
+				xss.insert(xss.end(), data.eout.begin(), data.eout.end());
+				xss.insert(xss.end(), data.pdf.begin(), data.pdf.end());
+				xss.insert(xss.end(), data.cdf.begin(), data.cdf.end());
+				xss.insert(xss.end(), neout, 0.0);
+				ace->eout_dist.push_back(AceLaws::Law61::EnergyData(xss.begin()));
+			}
+			energy_law = new AceReaction::EnergyLaw61(ace);
+			delete ace;
+			break;
+		}
+		case 66: {
+			AceLaws::Law66* ace = aceLaw<AceLaws::Law66>();
+			ace->npxs = 3;
+			ace->ap = 2.0;
+			energy_law = new AceReaction::EnergyLaw66(ace, 0.0, 1.99);
+			delete ace;
+			break;
+		}
+		}
+		return energy_law;
+	}
+
+	/* Particles with energies (log-uniform) between emin and emax */
+	static inline std::vector<Particle> particles(Random& random, double emin, double emax) {
+		std::vector<double> energies = logEnergies(random, emin, emax);
+		std::vector<Particle> particles;
+		for(size_t i = 0 ; i < energies.size() ; ++i)
+			particles.push_back(Particle(Coordinate(0,0,0), Direction(0,0,1), Energy(0, energies[i]), 1.0));
+		return particles;
+	}
+
+}
+
+/* Sampling of the outgoing energy and cosine of an energy law */
+class EnergyLawSetEnergy : public Benchmark {
+	AceReaction::AceEnergyLaw* law;
+	std::vector<Particle> particles;
+	Random random;
+public:
+	EnergyLawSetEnergy(int number) : Benchmark("EnergyLaw" + toString(number) + "::setEnergy"),
+		law(BenchmarkData::energyLaw(number)), random(8) {
+		/* Energies above the threshold of the synthetic laws */
+		particles = BenchmarkData::particles(random, 1.0, 20.0);
+	}
+	/* Law with tables of the given size */
+	EnergyLawSetEnergy(int number, size_t nein, size_t neout, const std::string& tag) :
+		Benchmark("EnergyLaw" + toString(number) + "::setEnergy[" + tag + "]"),
+		law(BenchmarkData::energyLaw(number, nein, neout)), random(8) {
+		/* Energies above the threshold of the synthetic laws */
+		particles = BenchmarkData::particles(random, 1.0, 20.0);
+	}
+	double run(size_t nops) {
+		double acc = 0.0;
+		for(size_t i = 0 ; i < nops ; ++i) {
+			double energy(0.0), mu(0.0);
+			law->setEnergy(particles[i & (BenchmarkData::nsamples - 1)], random, energy, mu);
+			acc += energy + mu;
+		}
+		return acc;
+	}
+	~EnergyLawSetEnergy() {delete law;}
+};
+
+/* Elastic scattering on hydrogen (free gas treatment on low energies) */
+class ElasticScatteringCollision : public Benchmark {
+	AceReaction::ElasticScattering<AceReaction::MuIsotropic>* elastic;
+	std::vector<Particle> particles;
+	Random random;
+public:
+	ElasticScatteringCollision() : Benchmark("ElasticScattering::operator()"), random(9) {
+		Ace::AngularDistribution isotropic(Ace::AngularDistribution::isotropic);
+		elastic = new AceReaction::ElasticScattering<AceReaction::MuIsotropic>(0.9991673, 2.53e-8, isotropic);
+		particles = BenchmarkData::particles(random, BenchmarkData::emin, BenchmarkData::emax);
+	}
+	double run(size_t nops) {
+		double acc = 0.0;
+		for(size_t i = 0 ; i < nops ; ++i) {
+			Particle particle(particles[i & (BenchmarkData::nsamples - 1)]);
+			(*elastic)(particle, random);
+			acc += particle.getEnergy().second;
+		}
+		return acc;
+	}
+	~ElasticScatteringCollision() {delete elastic;}
+};
+
+} /* namespace Helios */
+#endif /* REACTIONBENCHMARK_HPP_ */
@@ -40,7 +40,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "../../../Material/AceTable/AceReader/Conf.hpp"
 #include "../../../Material/AceTable/AceReaction/ElasticScattering.hpp"
 #include "../../../Material/AceTable/AceReaction/FissionReaction.hpp"
+#include "../../../Material/AceTable/AceReaction/EnergyLaws/EnergyLaws.hpp"
 #include "../../../Tallies/Histogram.hpp"
+#include "../../../Common/AliasSampler.hpp"
 
 #include "../../Utils.hpp"
 #include "../TestCommon.hpp"
@@ -286,4 +288,208 @@ TEST_F(SimpleReactionTest, ChanceFission) {
 	delete environment;
 }
 
+/* Spectrum laws (Maxwell, evaporation and Watt) with synthetic data and some restriction energy */
+static Helios::AceReaction::AceEnergyLaw* spectrumLaw(int law, double u) {
+	using namespace std;
+	using namespace Helios;
+	typedef Ace::EnergyDistribution AceLaws;
+	/* Common data */
+	vector<double> range(2);
+	range[0] = 1e-11; range[1] = 20.0;
+	vector<double> ein(3);
+	ein[0] = 1e-5; ein[1] = 1.0; ein[2] = 20.0;
+	vector<double> t(3);
+	t[0] = 1.2; t[1] = 1.3; t[2] = 1.6;
+	AceReaction::AceEnergyLaw* energy_law(0);
+	if(law == 7) {
+		AceLaws::Law7 ace(0, 0, 0, vector<int>(), vector<int>(), 2, range, vector<double>(2, 1.0));
+		ace.ein = ein; ace.t = t; ace.u = u;
+		energy_law = new AceReaction::EnergyLaw7(&ace);
+	} else if(law == 9) {
+		AceLaws::Law9 ace(0, 0, 0, vector<int>(), vector<int>(), 2, range, vector<double>(2, 1.0));
+		ace.ein = ein; ace.t = t; ace.u = u;
+		energy_law = new AceReaction::EnergyLaw9(&ace);
+	} else if(law == 11) {
+		AceLaws::Law11 ace(0, 0, 0, vector<int>(), vector<int>(), 2, range, vector<double>(2, 1.0));
+		ace.eina = ein; ace.einb = ein;
+		ace.a = vector<double>(3, 0.988);
+		ace.b = vector<double>(3, 2.249);
+		ace.u = u;
+		energy_law = new AceReaction::EnergyLaw11(&ace);
+	}
+	return energy_law;
+}
+
+/* Compare the tabulated inverse cumulative against the rejection sampling */
+TEST_F(SimpleReactionTest, SpectrumTables) {
+	using namespace std;
+	using namespace Helios;
+
+	/* The evaporation spectrum is also checked close to the threshold of the reaction */
+	int laws[] = {7, 9, 9, 11};
+	double restriction[] = {-20.0, 0.5, 1.8, -20.0};
+	double energies[] = {0.8, 2.0, 2.5, 14.0};
+	size_t nsamples = 1000000;
+
+	for(size_t i = 0 ; i < sizeof(laws) / sizeof(int) ; ++i) {
+		AceReaction::AceEnergyLaw::spectrum_points = 0;
+		AceReaction::AceEnergyLaw* rejection = spectrumLaw(laws[i], restriction[i]);
+		AceReaction::AceEnergyLaw::spectrum_points = 1024;
+		AceReaction::AceEnergyLaw* tabulated = spectrumLaw(laws[i], restriction[i]);
+		AceReaction::AceEnergyLaw::spectrum_points = 0;
+
+		for(size_t j = 0 ; j < sizeof(energies) / sizeof(double) ; ++j) {
+			Particle particle(Coordinate(0,0,0), Direction(0,0,1), Energy(0, energies[j]), 1.0);
+			Random random(10 + j);
+			vector<double> rejection_samples(nsamples), tabulated_samples(nsamples);
+			for(size_t k = 0 ; k < nsamples ; ++k) {
+				double mu(0.0);
+				rejection->setEnergy(particle, random, rejection_samples[k], mu);
+				tabulated->setEnergy(particle, random, tabulated_samples[k], mu);
+			}
+			sort(rejection_samples.begin(), rejection_samples.end());
+			sort(tabulated_samples.begin(), tabulated_samples.end());
+			/* Compare some quantiles of the distribution */
+			double quantiles[] = {0.05, 0.25, 0.5, 0.75, 0.95, 0.99};
+			for(size_t q = 0 ; q < sizeof(quantiles) / sizeof(double) ; ++q) {
+				size_t idx = (size_t)(quantiles[q] * nsamples);
+				double expected = rejection_samples[idx];
+				EXPECT_NEAR(tabulated_samples[idx], expected, 0.01 * fabs(expected));
+			}
+		}
+
+		delete rejection;
+		delete tabulated;
+	}
+}
+
+/* Compare the tabulated free gas target velocity against the rejection sampling */
+TEST_F(SimpleReactionTest, FreeGasTable) {
+	using namespace std;
+	using namespace Helios;
+
+	AceReaction::FreeGasTable table(256);
+	double speeds[] = {0.05, 0.2, 0.5, 1.0, 2.5, 10.0, 50.0};
+	size_t nsamples = 1000000;
+
+	for(size_t i = 0 ; i < sizeof(speeds) / sizeof(double) ; ++i) {
+		double y = speeds[i];
+		ASSERT_TRUE(table.inside(y));
+		Random random(20 + i);
+		vector<double> rejection_target(nsamples), tabulated_target(nsamples);
+		vector<double> rejection_relative(nsamples), tabulated_relative(nsamples);
+		double rejection_cosine(0.0), tabulated_cosine(0.0);
+		for(size_t k = 0 ; k < nsamples ; ++k) {
+			double z, z2, c;
+			AceReaction::FreeGasTable::sampleRejection(y, random, z2, c);
+			z = sqrt(z2);
+			rejection_target[k] = z;
+			rejection_relative[k] = sqrt(y*y + z*z - 2*y*z*c);
+			rejection_cosine += c;
+			table.sample(y, random, z, c);
+			tabulated_target[k] = z;
+			tabulated_relative[k] = sqrt(y*y + z*z - 2*y*z*c);
+			tabulated_cosine += c;
+		}
+		sort(rejection_target.begin(), rejection_target.end());
+		sort(tabulated_target.begin(), tabulated_target.end());
+		sort(rejection_relative.begin(), rejection_relative.end());
+		sort(tabulated_relative.begin(), tabulated_relative.end());
+		/* Compare some quantiles of the target and relative speeds (the lower tail has less samples) */
+		double quantiles[] = {0.002, 0.005, 0.01, 0.05, 0.25, 0.5, 0.75, 0.95, 0.99};
+		double tolerance[] = {0.03, 0.02, 0.02, 0.01, 0.01, 0.01, 0.01, 0.01, 0.01};
+		for(size_t q = 0 ; q < sizeof(quantiles) / sizeof(double) ; ++q) {
+			size_t idx = (size_t)(quantiles[q] * nsamples);
+			EXPECT_NEAR(tabulated_target[idx], rejection_target[idx], tolerance[q] * rejection_target[idx]);
+			EXPECT_NEAR(tabulated_relative[idx], rejection_relative[idx], tolerance[q] * rejection_relative[idx]);
+		}
+		/* Average cosine between target and neutron */
+		EXPECT_NEAR(tabulated_cosine / nsamples, rejection_cosine / nsamples, 0.005);
+	}
+}
+
+/* Test for the alias sampler, the mapping of random numbers is not the same of the Sampler */
+class IntAliasSamplerTest : public ::testing::Test {
+	size_t nsamples;
+	size_t histories;
+	size_t nenergies;
+	bool normalize;
+protected:
+	IntAliasSamplerTest(const size_t& nsamples, const size_t& nenergies, const size_t& histories, bool normalize = true) :
+		           nsamples(nsamples), histories(histories), nenergies(nenergies), normalize(normalize), sampler(0) {/* */}
+	virtual ~IntAliasSamplerTest() {/* */}
+
+	void SetUp() {
+		/* Fixed seed, so a failure can be reproduced */
+		srand(1234);
+		/* Random (non normalized) weights, zero on odd reactions */
+		std::vector<size_t> samples;
+		std::vector<std::vector<double> > weights;
+		for(size_t i = 0 ; i < nsamples ; ++i) {
+			std::vector<double> row(nenergies,0.0);
+			if(i%2 == 0)
+				for(size_t j = 0 ; j < nenergies ; ++j)
+					row[j] = randomNumber(0.1,10.0);
+			samples.push_back(i);
+			weights.push_back(row);
+			probabilities[i] = row;
+		}
+		sampler = new Helios::AliasSampler<size_t>(samples,weights,normalize);
+	}
+
+	void TearDown() {
+		delete sampler;
+	}
+
+	void checkSamples() const {
+		size_t nerg = rand()%nenergies;
+		/* Expected probability of each reaction */
+		double total = 0.0;
+		for(size_t i = 0 ; i < nsamples ; ++i)
+			total += probabilities.find(i)->second[nerg];
+		/* Count samples */
+		std::vector<double> counts(nsamples,0.0);
+		for(size_t h = 0 ; h < histories ; h++) {
+			/* Without normalization, the random number is scaled by the total weight */
+			double value = normalize ? randomNumber() : randomNumber(0.0,total);
+			size_t sample = sampler->sample(nerg,value);
+			ASSERT_EQ(sample%2,0);
+			counts[sample]++;
+		}
+		/* Each count should be inside 5 standard deviations of the expected value */
+		for(size_t i = 0 ; i < nsamples ; ++i) {
+			double prob = probabilities.find(i)->second[nerg] / total;
+			double expect = histories * prob;
+			double sigma = sqrt(histories * prob * (1.0 - prob));
+			EXPECT_NEAR(counts[i],expect,5.0*sigma + 1.0e-10);
+		}
+	}
+
+	/* Weights used to build the sampler */
+	std::map<size_t,std::vector<double> > probabilities;
+	/* Sampler to test */
+	Helios::AliasSampler<size_t>* sampler;
+};
+
+class MaterialsIntAliasSamplerTest : public IntAliasSamplerTest {
+protected:
+	MaterialsIntAliasSamplerTest() : IntAliasSamplerTest(50,100,1000000) {/* */}
+	virtual ~MaterialsIntAliasSamplerTest() {/* */}
+};
+class OneIntAliasSamplerTest : public IntAliasSamplerTest {
+protected:
+	OneIntAliasSamplerTest() : IntAliasSamplerTest(1,100,1000000) {/* */}
+	virtual ~OneIntAliasSamplerTest() {/* */}
+};
+
+class UnnormalizedIntAliasSamplerTest : public IntAliasSamplerTest {
+protected:
+	UnnormalizedIntAliasSamplerTest() : IntAliasSamplerTest(50,100,1000000,false) {/* */}
+	virtual ~UnnormalizedIntAliasSamplerTest() {/* */}
+};
+
+TEST_F(MaterialsIntAliasSamplerTest, SamplingIntegers) {checkSamples();}
+TEST_F(UnnormalizedIntAliasSamplerTest, SamplingIntegers) {checkSamples();}
+TEST_F(OneIntAliasSamplerTest, SamplingIntegers) {checkSamples();}
+
 #endif /* REACTIONTEST_HPP_ */
@@ -29,9 +29,18 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define GEOMETRYTESTS_HPP_
 
 #include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <limits>
+#include <cmath>
 
 #include "../../../Common/Common.hpp"
 #include "../../../Parser/ParserTypes.hpp"
+#include "../../../Geometry/Cell.hpp"
+#include "../../../Geometry/Surfaces/MacroBody.hpp"
+#include "../../../Geometry/GeometricFeature.hpp"
+#include "../../../Geometry/Universe.hpp"
 #include "../../Utils.hpp"
 #include "../TestCommon.hpp"
 
@@ -291,4 +300,821 @@ TEST_F(CylinderXZConcentricTranslaUniverseTest, RandomTransport) {random();}
 TEST_F(LatticeXYConcentricTest, RandomTransport) {random();}
 TEST_F(HugeLatticeXYConcentricTest, RandomTransport) {random();}
 
+/* Cells defined with unions and complements of half-spaces */
+class ExpressionTest : public GeometryTest {
+protected:
+	ExpressionTest() : GeometryTest("expression.xml") {/* */}
+	~ExpressionTest() {/* */}
+
+	void SetUp() {
+		GeometryTest::SetUp();
+		/* Map of the surfaces of the geometry (to parse expressions) */
+		const std::vector<Helios::Surface*>& surfaces = geometry->getSurfaces();
+		for(std::vector<Helios::Surface*>::const_iterator it = surfaces.begin() ; it != surfaces.end() ; ++it)
+			surface_map[(*it)->getUserId()] = *it;
+		/* Cells and expressions of the file */
+		expressions.push_back("(-7 5 -6) : -8");
+		expressions.push_back("1 -2 3 -4 5 -6 #((-7 5 -6) : -8)");
+		expressions.push_back("-1 : 2 : -3 : 4 : -5 : 6");
+	}
+
+	Helios::CellExpression::Node parse(const std::string& expression) {
+		return Helios::CellFactory::parseExpression("test",expression,surface_map);
+	}
+
+	/* Straightforward recursive evaluation of the (not normalized) expression tree */
+	static bool evaluate(const Helios::CellExpression::Node& node, const Helios::Coordinate& position) {
+		typedef Helios::CellExpression::Node Node;
+		switch(node.type) {
+		case Node::LEAF :
+			return node.surface->sense(position) == node.sense;
+		case Node::COMPLEMENT :
+			return !evaluate(node.childs[0], position);
+		case Node::INTERSECTION :
+			for(std::vector<Node>::const_iterator it = node.childs.begin() ; it != node.childs.end() ; ++it)
+				if(!evaluate(*it, position)) return false;
+			return true;
+		case Node::UNION :
+			for(std::vector<Node>::const_iterator it = node.childs.begin() ; it != node.childs.end() ; ++it)
+				if(evaluate(*it, position)) return true;
+			return false;
+		}
+		return false;
+	}
+
+	/* Half-spaces of an expression (user IDs and senses), sorted */
+	static std::vector<std::pair<Helios::SurfaceId,bool> > halfSpaces(const Helios::CellExpression& expression) {
+		std::vector<std::pair<Helios::SurfaceId,bool> > half_spaces;
+		const std::vector<std::pair<Helios::Surface*,bool> >& expression_half_spaces = expression.getHalfSpaces();
+		for(size_t i = 0 ; i < expression_half_spaces.size() ; ++i)
+			half_spaces.push_back(std::make_pair(expression_half_spaces[i].first->getUserId(),expression_half_spaces[i].second));
+		std::sort(half_spaces.begin(), half_spaces.end());
+		return half_spaces;
+	}
+
+	static Helios::Coordinate randomPoint() {
+		return Helios::Coordinate(randomNumber(-6.0,6.0),randomNumber(-6.0,6.0),randomNumber(-6.0,6.0));
+	}
+
+	/* Random direction over the whole sphere */
+	static Helios::Direction isotropicDirection() {
+		Helios::Direction dir;
+		double norm;
+		do {
+			dir = Helios::Direction(randomNumber(-1.0,1.0),randomNumber(-1.0,1.0),randomNumber(-1.0,1.0));
+			norm = dot(dir,dir);
+		} while(norm > 1.0 || norm < 1e-6);
+		return dir/sqrt(norm);
+	}
+
+	/* Distance to the boundary of a region marching along the line and refining by bisection */
+	static double marchDistance(const Helios::CellExpression::Node& node, const Helios::Coordinate& position,
+			                    const Helios::Direction& direction) {
+		const double step = 1e-3;
+		double outside = 0.0;
+		while(evaluate(node, position + outside * direction)) {
+			outside += step;
+			if(outside > 100.0) return std::numeric_limits<double>::infinity();
+		}
+		double inside = std::max(0.0, outside - step);
+		while(outside - inside > 1e-11) {
+			double middle = 0.5 * (inside + outside);
+			if(evaluate(node, position + middle * direction)) inside = middle;
+			else outside = middle;
+		}
+		return inside;
+	}
+
+	std::map<Helios::SurfaceId,Helios::Surface*> surface_map;
+	std::vector<std::string> expressions;
+};
+
+TEST_F(ExpressionTest, Parser) {
+	typedef Helios::CellExpression::Node Node;
+	/* Precedence : complement, intersection and union */
+	Node node = parse("1 -2 : #(3 : -4)");
+	ASSERT_EQ(Node::UNION, node.type);
+	ASSERT_EQ(2, node.childs.size());
+	const Node& intersection = node.childs[0];
+	ASSERT_EQ(Node::INTERSECTION, intersection.type);
+	ASSERT_EQ(2, intersection.childs.size());
+	EXPECT_EQ(Node::LEAF, intersection.childs[0].type);
+	EXPECT_EQ(surface_map["1"], intersection.childs[0].surface);
+	EXPECT_TRUE(intersection.childs[0].sense);
+	EXPECT_EQ(surface_map["2"], intersection.childs[1].surface);
+	EXPECT_FALSE(intersection.childs[1].sense);
+	const Node& complement = node.childs[1];
+	ASSERT_EQ(Node::COMPLEMENT, complement.type);
+	ASSERT_EQ(1, complement.childs.size());
+	ASSERT_EQ(Node::UNION, complement.childs[0].type);
+	ASSERT_EQ(2, complement.childs[0].childs.size());
+	EXPECT_EQ(surface_map["3"], complement.childs[0].childs[0].surface);
+	EXPECT_TRUE(complement.childs[0].childs[0].sense);
+	EXPECT_EQ(surface_map["4"], complement.childs[0].childs[1].surface);
+	EXPECT_FALSE(complement.childs[0].childs[1].sense);
+
+	/* Parenthesis only group operands */
+	node = parse("((-7))");
+	EXPECT_EQ(Node::LEAF, node.type);
+	EXPECT_EQ(surface_map["7"], node.surface);
+	EXPECT_FALSE(node.sense);
+
+	/* Malformed expressions */
+	EXPECT_THROW(parse(""), Helios::Cell::BadCellCreation);
+	EXPECT_THROW(parse("(1 -2"), Helios::Cell::BadCellCreation);
+	EXPECT_THROW(parse("1 -2)"), Helios::Cell::BadCellCreation);
+	EXPECT_THROW(parse("1 : : 2"), Helios::Cell::BadCellCreation);
+	EXPECT_THROW(parse(": 1"), Helios::Cell::BadCellCreation);
+	EXPECT_THROW(parse("1 :"), Helios::Cell::BadCellCreation);
+	EXPECT_THROW(parse("#1"), Helios::Cell::BadCellCreation);
+	EXPECT_THROW(parse("1 #"), Helios::Cell::BadCellCreation);
+}
+
+TEST_F(ExpressionTest, Normalization) {
+	typedef std::pair<Helios::SurfaceId,bool> HalfSpace;
+	/* De Morgan : #(1 -2 : 3) = (-1 : 2) -3 */
+	std::vector<HalfSpace> expected;
+	expected.push_back(HalfSpace("1",false));
+	expected.push_back(HalfSpace("2",true));
+	expected.push_back(HalfSpace("3",false));
+	EXPECT_EQ(expected, halfSpaces(Helios::CellExpression(parse("#(1 -2 : 3)"))));
+
+	/* Double complement */
+	expected.clear();
+	expected.push_back(HalfSpace("1",true));
+	expected.push_back(HalfSpace("2",false));
+	EXPECT_EQ(expected, halfSpaces(Helios::CellExpression(parse("#(#(1 -2))"))));
+
+	/* Repeated half-spaces are stored once, opposite senses of the same surface are kept */
+	expected.clear();
+	expected.push_back(HalfSpace("7",false));
+	expected.push_back(HalfSpace("7",true));
+	expected.push_back(HalfSpace("8",false));
+	EXPECT_EQ(expected, halfSpaces(Helios::CellExpression(parse("-7 -8 : #(-7 : 8)"))));
+	EXPECT_EQ(2, Helios::CellExpression(parse("-7 -8 : #(-7 : 8)")).getSurfaces().size());
+}
+
+TEST_F(ExpressionTest, Evaluation) {
+	std::vector<std::string> tests(expressions);
+	tests.push_back("#(#(1 -2))");
+	tests.push_back("#(1 -2 : 3) : -7 #(-8 : 6)");
+	tests.push_back("#(#(-7 : -8) 1 : #(2 #(3 -4)))");
+	for(std::vector<std::string>::const_iterator it = tests.begin() ; it != tests.end() ; ++it) {
+		Helios::CellExpression::Node node = parse(*it);
+		Helios::CellExpression expression(node);
+		/* Compiled expression with the default order, while gathering statistics */
+		expression.setStatistics(true);
+		for(size_t i = 0 ; i < 20000 ; ++i) {
+			Helios::Coordinate point = randomPoint();
+			bool expected = evaluate(node, point);
+			ASSERT_EQ(expected, expression.evaluate(point, 0)) << *it << " at " << point;
+			/* Known sense of one surface */
+			const Helios::Surface* surface = expression.getSurfaces()[i % expression.getSurfaces().size()];
+			ASSERT_EQ(expected, expression.evaluate(point, surface, surface->sense(point))) << *it << " at " << point;
+		}
+		/* Reordered expression */
+		expression.setStatistics(false);
+		expression.optimize();
+		for(size_t i = 0 ; i < 20000 ; ++i) {
+			Helios::Coordinate point = randomPoint();
+			ASSERT_EQ(evaluate(node, point), expression.evaluate(point, 0)) << *it << " at " << point;
+		}
+	}
+
+	/* Cells of the geometry */
+	for(size_t n = 0 ; n < expressions.size() ; ++n) {
+		Helios::CellExpression::Node node = parse(expressions[n]);
+		const Helios::Cell* cell = geometry->getObject<Helios::Cell>(Helios::toString(n + 1))[0];
+		for(size_t i = 0 ; i < 20000 ; ++i) {
+			Helios::Coordinate point = randomPoint();
+			ASSERT_EQ(evaluate(node, point), cell->isInside(point)) << "Cell " << n + 1 << " at " << point;
+		}
+	}
+}
+
+TEST_F(ExpressionTest, SteppingDistance) {
+	/* Union of a cylinder and a sphere, and its complement inside a box */
+	for(size_t n = 0 ; n < 2 ; ++n) {
+		Helios::CellExpression::Node node = parse(expressions[n]);
+		const Helios::Cell* cell = geometry->getObject<Helios::Cell>(Helios::toString(n + 1))[0];
+		for(size_t i = 0 ; i < 500 ; ++i) {
+			Helios::Coordinate point;
+			do {
+				point = randomPoint();
+			} while(!evaluate(node, point));
+			Helios::Direction direction = isotropicDirection();
+
+			Helios::Surface* surface;
+			bool sense;
+			double distance;
+			cell->intersect(point, direction, surface, sense, distance);
+
+			double expected = marchDistance(node, point, direction);
+			ASSERT_TRUE(surface != 0);
+			ASSERT_NEAR(expected, distance, 1e-8) << "Cell " << n + 1 << " from " << point << " to " << direction;
+			/* The surface is on the boundary, and the particle is leaving its half-space */
+			Helios::Coordinate boundary = point + distance * direction;
+			EXPECT_EQ(sense, surface->sense(boundary - 1e-8 * direction));
+			EXPECT_EQ(!sense, surface->sense(boundary + 1e-8 * direction));
+		}
+	}
+}
+
+/* Cylinder inside a hexagonal prism inside a box, all of them macrobodies */
+class MacroBodyTest : public ConcentricTest {
+protected:
+	MacroBodyTest() : ConcentricTest("macrobody.xml",Helios::Coordinate(0,0,0),50000) {/* */};
+	~MacroBodyTest() {/* */}
+
+	const Helios::MacroBody* body(const Helios::SurfaceId& id) const {
+		return dynamic_cast<const Helios::MacroBody*>(geometry->getObject<Helios::Surface>(id)[0]);
+	}
+
+	/* Check the facet of a point, the point could be on an edge or corner shared by some facets */
+	void expectFacet(const Helios::SurfaceId& id, const Helios::Coordinate& point, const std::vector<int>& facets) const {
+		const Helios::MacroBody* macrobody = body(id);
+		int facet = macrobody->facet(point);
+		EXPECT_TRUE(std::find(facets.begin(), facets.end(), facet) != facets.end())
+			<< "Facet " << facet << " of surface " << id << " at " << point;
+	}
+	void expectFacet(const Helios::SurfaceId& id, const Helios::Coordinate& point, int facet) const {
+		expectFacet(id, point, std::vector<int>(1, facet));
+	}
+	void expectFacet(const Helios::SurfaceId& id, const Helios::Coordinate& point, int first, int second, int third = -1) const {
+		std::vector<int> facets;
+		facets.push_back(first);
+		facets.push_back(second);
+		if(third >= 0) facets.push_back(third);
+		expectFacet(id, point, facets);
+	}
+
+	void expectNormal(const Helios::SurfaceId& id, const Helios::Coordinate& point, const Helios::Direction& expected) const {
+		Helios::Direction normal;
+		body(id)->normal(point, normal);
+		for(int i = 0 ; i < 3 ; ++i)
+			EXPECT_NEAR(expected[i], normal[i], 1e-12) << "Normal of surface " << id << " at " << point;
+	}
+
+	void expectIntersect(const Helios::SurfaceId& id, const Helios::Coordinate& point, const Helios::Direction& direction,
+			             bool sense, double expected) const {
+		double distance;
+		Helios::Direction unit = direction / sqrt(dot(direction, direction));
+		ASSERT_TRUE(body(id)->intersect(point, unit, sense, distance)) << "Surface " << id << " from " << point << " to " << unit;
+		EXPECT_NEAR(expected, distance, 1e-12) << "Surface " << id << " from " << point << " to " << unit;
+	}
+
+	void expectMiss(const Helios::SurfaceId& id, const Helios::Coordinate& point, const Helios::Direction& direction, bool sense) const {
+		double distance;
+		Helios::Direction unit = direction / sqrt(dot(direction, direction));
+		EXPECT_FALSE(body(id)->intersect(point, unit, sense, distance)) << "Surface " << id << " from " << point << " to " << unit;
+	}
+
+	/* Check the cells on both sides of a point of a surface */
+	void expectCross(const Helios::SurfaceId& id, const Helios::Coordinate& point,
+			         const Helios::CellId& inside, const Helios::CellId& outside) const {
+		const Helios::Surface* surface = geometry->getObject<Helios::Surface>(id)[0];
+		const Helios::Cell* cell;
+		surface->cross(point, false, cell);
+		ASSERT_TRUE(cell != 0) << "Leaving surface " << id << " at " << point;
+		EXPECT_EQ(outside, cell->getUserId()) << "Leaving surface " << id << " at " << point;
+		surface->cross(point, true, cell);
+		ASSERT_TRUE(cell != 0) << "Entering surface " << id << " at " << point;
+		EXPECT_EQ(inside, cell->getUserId()) << "Entering surface " << id << " at " << point;
+	}
+};
+
+TEST_F(MacroBodyTest, StraightTransport) {straight(genVector<Helios::CellId>("1","4"),genVector<Helios::SurfaceId>("1","3"));}
+TEST_F(MacroBodyTest, RandomTransport) {random();}
+
+TEST_F(MacroBodyTest, Facets) {
+	using Helios::Coordinate;
+	using Helios::Direction;
+	const double sq3 = sqrt(3.0);
+	/* Cylinder : bottom (0), top (1) and lateral (2) */
+	expectFacet("1", Coordinate(0,0,-1), 0);
+	expectFacet("1", Coordinate(0,0,1), 1);
+	expectFacet("1", Coordinate(1,0,0), 2);
+	expectFacet("1", Coordinate(0,-1,0.5), 2);
+	expectFacet("1", Coordinate(0.5,0,-4), 0);
+	expectFacet("1", Coordinate(3,0,0), 2);
+	expectFacet("1", Coordinate(1,0,1), 1,2);
+	expectNormal("1", Coordinate(1,0,0), Direction(1,0,0));
+	expectNormal("1", Coordinate(0,1,0.5), Direction(0,1,0));
+	expectNormal("1", Coordinate(0,0,-1), Direction(0,0,-1));
+	expectNormal("1", Coordinate(0.5,0.5,1), Direction(0,0,1));
+
+	/* Hexagonal prism : bottom (0), top (1) and the pairs of facets normal to (1,0), (1/2,sqrt(3)/2), (-1/2,sqrt(3)/2) */
+	expectFacet("2", Coordinate(0,0,-2), 0);
+	expectFacet("2", Coordinate(0,0,2), 1);
+	expectFacet("2", Coordinate(-2,0,0), 2);
+	expectFacet("2", Coordinate(2,0,0), 3);
+	expectFacet("2", Coordinate(-1,-sq3,0), 4);
+	expectFacet("2", Coordinate(1,sq3,0), 5);
+	expectFacet("2", Coordinate(1,-sq3,0), 6);
+	expectFacet("2", Coordinate(-1,sq3,0), 7);
+	expectFacet("2", Coordinate(4,0.5,1), 3);
+	expectFacet("2", Coordinate(2,2/sq3,0), 3,5);
+	expectFacet("2", Coordinate(2,0,2), 1,3);
+	expectFacet("2", Coordinate(2,2/sq3,2), 1,3,5);
+	expectNormal("2", Coordinate(-2,0,0), Direction(-1,0,0));
+	expectNormal("2", Coordinate(1,sq3,0), Direction(0.5,sq3/2,0));
+	expectNormal("2", Coordinate(0.5,-sq3,1), Direction(0.5,-sq3/2,0));
+	expectNormal("2", Coordinate(0.5,0.5,2), Direction(0,0,1));
+
+	/* Box : pairs of facets normal to x, y and z */
+	expectFacet("3", Coordinate(-5,1,1), 0);
+	expectFacet("3", Coordinate(5,1,1), 1);
+	expectFacet("3", Coordinate(1,-5,1), 2);
+	expectFacet("3", Coordinate(1,5,1), 3);
+	expectFacet("3", Coordinate(1,1,-5), 4);
+	expectFacet("3", Coordinate(1,1,5), 5);
+	expectFacet("3", Coordinate(5,5,5), 1,3,5);
+	expectNormal("3", Coordinate(1,-5,1), Direction(0,-1,0));
+	expectNormal("3", Coordinate(1,1,5), Direction(0,0,1));
+
+	/* Points on the facets are on the surface */
+	EXPECT_NEAR(0.0, body("1")->function(Coordinate(1,0,1)), 1e-12);
+	EXPECT_NEAR(0.0, body("2")->function(Coordinate(2,2/sq3,2)), 1e-12);
+	EXPECT_NEAR(0.0, body("3")->function(Coordinate(-5,5,-5)), 1e-12);
+	EXPECT_FALSE(body("2")->sense(Coordinate(1.9,1.0,1.9)));
+	EXPECT_TRUE(body("2")->sense(Coordinate(2.0,1.2,0.0)));
+}
+
+TEST_F(MacroBodyTest, Intersect) {
+	using Helios::Coordinate;
+	using Helios::Direction;
+	const double sq2 = sqrt(2.0);
+	const double sq3 = sqrt(3.0);
+	/* Cylinder, from inside through the facets and the rim */
+	expectIntersect("1", Coordinate(0,0,0), Direction(1,0,0), false, 1.0);
+	expectIntersect("1", Coordinate(0,0,0), Direction(0,0,-1), false, 1.0);
+	expectIntersect("1", Coordinate(0,0,0), Direction(1,0,1), false, sq2);
+	/* From outside, through the lateral facet, the rim and grazing the cylinder */
+	expectIntersect("1", Coordinate(-3,0,0), Direction(1,0,0), true, 2.0);
+	expectIntersect("1", Coordinate(-2,0,-2), Direction(1,0,1), true, sq2);
+	expectIntersect("1", Coordinate(-3,1,0), Direction(1,0,0), true, 3.0);
+	expectMiss("1", Coordinate(-3,0,0), Direction(-1,0,0), true);
+	expectMiss("1", Coordinate(-3,1.5,0), Direction(1,0,0), true);
+	expectMiss("1", Coordinate(0,0,2), Direction(1,0,0), true);
+	/* On the surface, just after leaving the body and headed into it */
+	expectMiss("1", Coordinate(0.1,0.2,1.0), Direction(0.1,0.2,1.0), true);
+	expectIntersect("1", Coordinate(0.1,0.2,1.0), Direction(0.1,0.2,-1.0), true, 0.0);
+
+	/* Hexagonal prism, through a facet, a corner and from outside */
+	expectIntersect("2", Coordinate(0,0,0), Direction(1,0,0), false, 2.0);
+	expectIntersect("2", Coordinate(0,0,0), Direction(0,1,0), false, 4.0/sq3);
+	expectIntersect("2", Coordinate(0,0,0), Direction(sq3/2,0.5,0), false, 4.0/sq3);
+	expectIntersect("2", Coordinate(0,0,0), Direction(2,0,2), false, 2.0*sq2);
+	expectIntersect("2", Coordinate(6,0,0), Direction(-1,0,0), true, 4.0);
+	expectIntersect("2", Coordinate(6,2/sq3,0), Direction(-1,0,0), true, 4.0);
+	expectMiss("2", Coordinate(6,0,0), Direction(1,0,0), true);
+	expectMiss("2", Coordinate(6,2.5,0), Direction(-1,0,0), true);
+
+	/* Box, through the corners */
+	expectIntersect("3", Coordinate(0,0,0), Direction(1,1,1), false, 5.0*sq3);
+	expectIntersect("3", Coordinate(-6,-6,-6), Direction(1,1,1), true, sq3);
+	expectIntersect("3", Coordinate(0,0,0), Direction(0,-1,0), false, 5.0);
+	expectMiss("3", Coordinate(-6,-6,-6), Direction(-1,1,1), true);
+}
+
+TEST_F(MacroBodyTest, Cross) {
+	using Helios::Coordinate;
+	const double sq3 = sqrt(3.0);
+	/* Facets, edges and corners of each body */
+	expectCross("1", Coordinate(1,0,0), "1", "2");
+	expectCross("1", Coordinate(0,0,1), "1", "2");
+	expectCross("1", Coordinate(1,0,1), "1", "2");
+	expectCross("2", Coordinate(2,0,0), "2", "3");
+	expectCross("2", Coordinate(2,2/sq3,0), "2", "3");
+	expectCross("2", Coordinate(2,0,2), "2", "3");
+	expectCross("2", Coordinate(-2,-2/sq3,-2), "2", "3");
+	expectCross("3", Coordinate(5,0,0), "3", "4");
+	expectCross("3", Coordinate(5,5,5), "3", "4");
+}
+
+/* Hexagonal lattice of 4 x 3 elements with a pitch of 1.2 on the x-y plane */
+class HexLatticeTest : public GeometryTest {
+protected:
+	HexLatticeTest() : GeometryTest("hex-latt.xml"), nu(4), nv(3), pitch(1.2) {/* */}
+	~HexLatticeTest() {/* */}
+
+	/* Lookup of the lattice of the file (or the same lattice on other plane) translated to some point */
+	Helios::FeatureLookup* createLookup(const std::string& type, const Helios::Direction& translation) const {
+		std::vector<int> dimension;
+		dimension.push_back(nu);
+		dimension.push_back(nv);
+		Helios::LatticeObject definition("10",type,dimension,std::vector<double>(2,pitch),std::vector<Helios::UniverseId>(nu*nv,"1"));
+		Helios::Lattice lattice(&definition);
+		return lattice.createLookup(translation);
+	}
+
+	/* Center of the element (i,j) on the lattice plane */
+	void center(int i, int j, double& u, double& v) const {
+		double di = i - (nu - 1) / 2.0;
+		double dj = j - (nv - 1) / 2.0;
+		u = (di + dj / 2.0) * pitch;
+		v = dj * sqrt(3.0) / 2.0 * pitch;
+	}
+
+	/* Index of an element, -1 outside the lattice */
+	int index(int i, int j) const {
+		if(i < 0 || i >= nu || j < 0 || j >= nv) return -1;
+		return (nv - 1 - j) * nu + i;
+	}
+
+	/*
+	 * Indexes of the elements with the nearest center to a point on the lattice plane (the hexagons
+	 * are the Voronoi cells of the centers). More than one if the point is on an edge or a corner.
+	 */
+	std::vector<int> nearest(double u, double v) const {
+		std::vector<std::pair<double,int> > distances;
+		for(int i = -2 ; i < nu + 2 ; ++i) {
+			for(int j = -2 ; j < nv + 2 ; ++j) {
+				double cu, cv;
+				center(i, j, cu, cv);
+				distances.push_back(std::make_pair((u - cu) * (u - cu) + (v - cv) * (v - cv), index(i, j)));
+			}
+		}
+		std::sort(distances.begin(), distances.end());
+		std::vector<int> indexes;
+		for(size_t k = 0 ; k < distances.size() && distances[k].first - distances[0].first < 1e-9 ; ++k)
+			indexes.push_back(distances[k].second);
+		return indexes;
+	}
+
+	void expectIndex(const Helios::FeatureLookup* lookup, const Helios::Coordinate& point, double u, double v) const {
+		std::vector<int> expected = nearest(u, v);
+		int value = lookup->getIndex(point);
+		EXPECT_TRUE(std::find(expected.begin(), expected.end(), value) != expected.end())
+			<< "Index " << value << " at " << point << " (expected " << expected[0] << ")";
+	}
+
+	int nu, nv;
+	double pitch;
+};
+
+TEST_F(HexLatticeTest, Lookup) {
+	using Helios::Coordinate;
+	using Helios::Direction;
+	const double pi = 4.0 * std::atan(1.0);
+	Direction translation(0.3,-0.2,5.0);
+	Helios::FeatureLookup* lookup = createLookup("hex-x-y", translation);
+	ASSERT_TRUE(lookup != 0);
+
+	for(int i = -1 ; i <= nu ; ++i) {
+		for(int j = -1 ; j <= nv ; ++j) {
+			double u, v;
+			center(i, j, u, v);
+			/* Center of the element */
+			EXPECT_EQ(index(i, j), lookup->getIndex(Coordinate(u + translation[0], v + translation[1], 0.0)));
+			for(int k = 0 ; k < 6 ; ++k) {
+				/* Middle of the facets (shared by two elements) */
+				double fu = u + pitch / 2.0 * std::cos(k * pi / 3.0);
+				double fv = v + pitch / 2.0 * std::sin(k * pi / 3.0);
+				expectIndex(lookup, Coordinate(fu + translation[0], fv + translation[1], 1.0), fu, fv);
+				/* Corners (shared by three elements) */
+				double cu = u + pitch / sqrt(3.0) * std::cos(k * pi / 3.0 + pi / 6.0);
+				double cv = v + pitch / sqrt(3.0) * std::sin(k * pi / 3.0 + pi / 6.0);
+				expectIndex(lookup, Coordinate(cu + translation[0], cv + translation[1], -1.0), cu, cv);
+				/* Inside, near the corners */
+				double iu = u + 0.999 * pitch / sqrt(3.0) * std::cos(k * pi / 3.0 + pi / 6.0);
+				double iv = v + 0.999 * pitch / sqrt(3.0) * std::sin(k * pi / 3.0 + pi / 6.0);
+				EXPECT_EQ(index(i, j), lookup->getIndex(Coordinate(iu + translation[0], iv + translation[1], 0.0)));
+			}
+		}
+	}
+
+	/* Random points around the lattice */
+	for(size_t n = 0 ; n < 100000 ; ++n) {
+		double u = randomNumber(-5.0,5.0);
+		double v = randomNumber(-4.0,4.0);
+		expectIndex(lookup, Coordinate(u + translation[0], v + translation[1], randomNumber(-1.0,1.0)), u, v);
+	}
+	delete lookup;
+
+	/* Same lattice on the other planes */
+	Helios::FeatureLookup* lookup_yz = createLookup("hex-y-z", Direction(0.0,0.0,0.0));
+	Helios::FeatureLookup* lookup_xz = createLookup("hex-x-z", Direction(0.0,0.0,0.0));
+	for(size_t n = 0 ; n < 10000 ; ++n) {
+		double u = randomNumber(-5.0,5.0);
+		double v = randomNumber(-4.0,4.0);
+		expectIndex(lookup_yz, Coordinate(2.0, u, v), u, v);
+		expectIndex(lookup_xz, Coordinate(v, 2.0, u), u, v);
+	}
+	delete lookup_yz;
+	delete lookup_xz;
+}
+
+TEST_F(HexLatticeTest, Cells) {
+	/* Lattice universe */
+	const Helios::Universe* universe = 0;
+	const std::vector<Helios::Universe*>& universes = geometry->getUniverses();
+	for(size_t i = 0 ; i < universes.size() ; ++i)
+		if(universes[i]->getUserId() == "10") universe = universes[i];
+	ASSERT_TRUE(universe != 0);
+	const std::vector<Helios::Cell*>& cells = universe->getCells();
+	ASSERT_EQ(nu * nv, cells.size());
+
+	/* The element of the lookup is the cell (made of planes) that contains the point */
+	Helios::FeatureLookup* lookup = createLookup("hex-x-y", Helios::Direction(0.0,0.0,0.0));
+	for(size_t n = 0 ; n < 100000 ; ++n) {
+		Helios::Coordinate point(randomNumber(-5.0,5.0),randomNumber(-4.0,4.0),randomNumber(-1.0,1.0));
+		int index = lookup->getIndex(point);
+		if(index >= 0) {
+			EXPECT_EQ(index, cells[index]->getFeatureIndex());
+			EXPECT_TRUE(cells[index]->isInside(point)) << "Cell " << cells[index]->getUserId() << " at " << point;
+		} else {
+			for(size_t i = 0 ; i < cells.size() ; ++i)
+				EXPECT_FALSE(cells[i]->isInside(point)) << "Cell " << cells[i]->getUserId() << " at " << point;
+		}
+		/* The cell found on the geometry is on the element */
+		const Helios::Cell* cell = geometry->findCell(point);
+		if(index >= 0) {
+			ASSERT_TRUE(cell != 0);
+			EXPECT_EQ(cells[index], cell->getParent()->getParent());
+		}
+	}
+	delete lookup;
+}
+
+/* Pin of three rings (radius 0.3, 0.4 and 0.5) on the x-y plane */
+class PinTest : public GeometryTest {
+protected:
+	PinTest() : GeometryTest("pin.xml") {
+		radius.push_back(0.3);
+		radius.push_back(0.4);
+		radius.push_back(0.5);
+	}
+	~PinTest() {/* */}
+
+	/* Lookup of a pin translated to some point */
+	Helios::FeatureLookup* createLookup(const std::string& type, double cu, double cv, const Helios::Direction& translation) const {
+		std::vector<double> center;
+		center.push_back(cu);
+		center.push_back(cv);
+		Helios::PinObject definition("20",type,center,radius,std::vector<Helios::MaterialId>(radius.size() + 1,"water"));
+		Helios::Pin pin(&definition);
+		return pin.createLookup(translation);
+	}
+
+	/* Ring of a point at some distance of the center (a point on a cylinder is outside of it) */
+	int ring(double u, double v) const {
+		int index = 0;
+		for(size_t k = 0 ; k < radius.size() ; ++k)
+			if(u * u + v * v >= radius[k] * radius[k]) index++;
+		return index;
+	}
+
+	std::vector<double> radius;
+};
+
+TEST_F(PinTest, Lookup) {
+	using Helios::Coordinate;
+	using Helios::Direction;
+	/* Known points, with the ones just on the cylinders */
+	Helios::FeatureLookup* lookup = createLookup("x-y", 0.0, 0.0, Direction(0.0,0.0,0.0));
+	ASSERT_TRUE(lookup != 0);
+	EXPECT_EQ(0, lookup->getIndex(Coordinate(0.0,0.0,0.0)));
+	EXPECT_EQ(0, lookup->getIndex(Coordinate(0.2,0.0,0.0)));
+	EXPECT_EQ(0, lookup->getIndex(Coordinate(0.299,0.0,0.0)));
+	EXPECT_EQ(1, lookup->getIndex(Coordinate(0.3,0.0,0.0)));
+	EXPECT_EQ(1, lookup->getIndex(Coordinate(0.0,-0.35,0.0)));
+	EXPECT_EQ(2, lookup->getIndex(Coordinate(0.0,0.4,7.0)));
+	EXPECT_EQ(2, lookup->getIndex(Coordinate(-0.45,0.0,0.0)));
+	EXPECT_EQ(3, lookup->getIndex(Coordinate(0.0,-0.5,0.0)));
+	EXPECT_EQ(3, lookup->getIndex(Coordinate(0.3,0.4,0.0)));
+	EXPECT_EQ(3, lookup->getIndex(Coordinate(3.0,4.0,0.0)));
+	delete lookup;
+
+	/* Random points, on each plane and translated */
+	Direction translation(1.0,2.0,3.0);
+	Helios::FeatureLookup* lookup_xy = createLookup("x-y", 0.1, -0.2, translation);
+	Helios::FeatureLookup* lookup_yz = createLookup("y-z", 0.1, -0.2, translation);
+	Helios::FeatureLookup* lookup_xz = createLookup("x-z", 0.1, -0.2, translation);
+	for(size_t n = 0 ; n < 100000 ; ++n) {
+		Coordinate point(randomNumber(0.0,2.0),randomNumber(1.0,3.0),randomNumber(2.0,4.0));
+		EXPECT_EQ(ring(point[0] - 1.1, point[1] - 1.8), lookup_xy->getIndex(point)) << point;
+		EXPECT_EQ(ring(point[1] - 2.1, point[2] - 2.8), lookup_yz->getIndex(point)) << point;
+		EXPECT_EQ(ring(point[2] - 3.1, point[0] - 0.8), lookup_xz->getIndex(point)) << point;
+	}
+	delete lookup_xy;
+	delete lookup_yz;
+	delete lookup_xz;
+}
+
+TEST_F(PinTest, Cells) {
+	/* Pin universe */
+	const Helios::Universe* universe = 0;
+	const std::vector<Helios::Universe*>& universes = geometry->getUniverses();
+	for(size_t i = 0 ; i < universes.size() ; ++i)
+		if(universes[i]->getUserId() == "20") universe = universes[i];
+	ASSERT_TRUE(universe != 0);
+	const std::vector<Helios::Cell*>& cells = universe->getCells();
+	ASSERT_EQ(radius.size() + 1, cells.size());
+
+	/* The ring of the lookup is the cell that contains the point */
+	Helios::FeatureLookup* lookup = createLookup("x-y", 0.1, -0.2, Helios::Direction(0.0,0.0,0.0));
+	std::vector<Helios::Coordinate> points;
+	for(size_t k = 0 ; k < radius.size() ; ++k) {
+		/* On the cylinders */
+		points.push_back(Helios::Coordinate(0.1 + radius[k], -0.2, 0.0));
+		points.push_back(Helios::Coordinate(0.1, -0.2 - radius[k], 1.0));
+	}
+	for(size_t n = 0 ; n < 100000 ; ++n)
+		points.push_back(Helios::Coordinate(randomNumber(-1.0,1.0),randomNumber(-1.0,1.0),randomNumber(-1.0,1.0)));
+	for(size_t n = 0 ; n < points.size() ; ++n) {
+		int index = lookup->getIndex(points[n]);
+		ASSERT_TRUE(index >= 0 && index < (int)cells.size());
+		EXPECT_EQ(index, cells[index]->getFeatureIndex());
+		for(size_t i = 0 ; i < cells.size() ; ++i)
+			EXPECT_EQ((int)i == index, cells[i]->isInside(points[n])) << "Cell " << cells[i]->getUserId() << " at " << points[n];
+		EXPECT_EQ(cells[index], geometry->findCell(points[n]));
+	}
+	delete lookup;
+}
+
+/* Box with a 2x2 lattice of 3x3 lattices of pins */
+class NestedTest : public GeometryTest {
+protected:
+	NestedTest() : GeometryTest("nested.xml") {/* */}
+	~NestedTest() {/* */}
+
+	static Helios::Coordinate randomPoint() {
+		return Helios::Coordinate(randomNumber(-3.0,3.0),randomNumber(-3.0,3.0),randomNumber(-3.0,3.0));
+	}
+
+	/* Random direction over the whole sphere */
+	static Helios::Direction isotropicDirection() {
+		Helios::Direction dir;
+		double norm;
+		do {
+			dir = Helios::Direction(randomNumber(-1.0,1.0),randomNumber(-1.0,1.0),randomNumber(-1.0,1.0));
+			norm = dot(dir,dir);
+		} while(norm > 1.0 || norm < 1e-6);
+		return dir/sqrt(norm);
+	}
+
+	/* Nearest surface of a cell and its ancestors with one (virtual) call for each surface */
+	static void virtualIntersect(const Helios::Cell* cell, const Helios::Coordinate& position, const Helios::Direction& direction,
+			                     Helios::Surface*& surface, bool& sense, double& distance) {
+		surface = 0;
+		sense = false;
+		distance = std::numeric_limits<double>::infinity();
+		for( ; cell ; cell = cell->getParent()->getParent()) {
+			const std::vector<Helios::Cell::SenseSurface>& surfaces = cell->getBoundingSurfaces();
+			for(std::vector<Helios::Cell::SenseSurface>::const_iterator it = surfaces.begin() ; it != surfaces.end() ; ++it) {
+				double new_distance;
+				if(it->first->intersect(position,direction,it->second,new_distance) && new_distance < distance) {
+					distance = new_distance;
+					surface = it->first;
+					sense = it->second;
+				}
+			}
+		}
+	}
+
+	/* Move of the particle after each step : to the surface or to a collision point, changing the direction or not */
+	struct Move {
+		double fraction;
+		bool turn;
+		Helios::Direction direction;
+	};
+
+	/* Cell, surface and distance of each step */
+	struct Step {
+		const Helios::Cell* cell;
+		Helios::Surface* surface;
+		double distance;
+	};
+
+	/* Track a particle with the same moves, with or without the tracking state */
+	std::vector<Step> track(const Helios::Coordinate& start, const Helios::Direction& start_direction,
+			                const std::vector<Move>& moves, Helios::GeometryState* state = 0) const {
+		std::vector<Step> steps;
+		/* The state is reused between histories, as the transport does on each thread */
+		if(state) state->reset();
+		Helios::Coordinate position(start);
+		Helios::Direction direction(start_direction);
+		const Helios::Cell* cell = geometry->findCell(position);
+		for(size_t k = 0 ; k < moves.size() && cell ; ++k) {
+			Step step;
+			bool sense;
+			if(state)
+				cell->intersect(position, direction, step.surface, sense, step.distance, *state);
+			else
+				cell->intersect(position, direction, step.surface, sense, step.distance);
+			step.cell = cell;
+			steps.push_back(step);
+			if(moves[k].fraction < 1.0) {
+				/* Collision */
+				position = position + moves[k].fraction * step.distance * direction;
+				if(moves[k].turn) direction = moves[k].direction;
+			} else {
+				/* Cross the surface */
+				position = position + step.distance * direction;
+				step.surface->cross(position, sense, cell);
+				if(cell && (cell->getFlag() & Helios::Cell::DEADCELL)) break;
+			}
+		}
+		return steps;
+	}
+
+	/* Check the senses of each surface of the cell with one (virtual) call for each surface */
+	static bool virtualInside(const Helios::Cell* cell, const Helios::Coordinate& position) {
+		const std::vector<Helios::Cell::SenseSurface>& surfaces = cell->getBoundingSurfaces();
+		for(std::vector<Helios::Cell::SenseSurface>::const_iterator it = surfaces.begin() ; it != surfaces.end() ; ++it)
+			if(it->first->sense(position) != it->second) return false;
+		return true;
+	}
+};
+
+TEST_F(NestedTest, PackedSurfaces) {
+	const std::vector<Helios::Cell*>& cells = geometry->getCells();
+	for(size_t n = 0 ; n < 20000 ; ++n) {
+		Helios::Coordinate point = randomPoint();
+		Helios::Direction direction = isotropicDirection();
+
+		/* Same senses on every cell */
+		for(std::vector<Helios::Cell*>::const_iterator it = cells.begin() ; it != cells.end() ; ++it)
+			ASSERT_EQ(virtualInside(*it, point), (*it)->isInside(point)) << "Cell " << (*it)->getUserId() << " at " << point;
+
+		/* Same nearest surface and distance */
+		const Helios::Cell* cell = geometry->findCell(point);
+		ASSERT_TRUE(cell != 0);
+		Helios::Surface* surface;
+		bool sense;
+		double distance;
+		cell->intersect(point, direction, surface, sense, distance);
+		Helios::Surface* expected_surface;
+		bool expected_sense;
+		double expected_distance;
+		virtualIntersect(cell, point, direction, expected_surface, expected_sense, expected_distance);
+		ASSERT_EQ(expected_surface, surface) << "Cell " << cell->getUserId() << " at " << point << " to " << direction;
+		ASSERT_EQ(expected_sense, sense);
+		ASSERT_NEAR(expected_distance, distance, 1e-12);
+	}
+}
+
+TEST_F(NestedTest, TrackingState) {
+	Helios::GeometryState state;
+	for(size_t h = 0 ; h < 2000 ; ++h) {
+		Helios::Coordinate start = randomPoint();
+		Helios::Direction start_direction = isotropicDirection();
+		/* Flights to the surfaces and collisions, some of them without changing the direction */
+		std::vector<Move> moves(200);
+		for(size_t k = 0 ; k < moves.size() ; ++k) {
+			moves[k].fraction = (randomNumber() < 0.5) ? randomNumber() : 1.0;
+			moves[k].turn = (randomNumber() < 0.3);
+			moves[k].direction = isotropicDirection();
+		}
+
+		std::vector<Step> expected = track(start, start_direction, moves);
+		std::vector<Step> steps = track(start, start_direction, moves, &state);
+		ASSERT_EQ(expected.size(), steps.size()) << "History " << h;
+		for(size_t k = 0 ; k < steps.size() ; ++k) {
+			ASSERT_EQ(expected[k].cell, steps[k].cell) << "History " << h << " step " << k;
+			ASSERT_EQ(expected[k].surface, steps[k].surface) << "History " << h << " step " << k;
+			ASSERT_NEAR(expected[k].distance, steps[k].distance, 1e-9) << "History " << h << " step " << k;
+		}
+	}
+}
+
+TEST_F(NestedTest, SharedSurfaces) {
+	/* Equal surfaces of the lattice clones are created once */
+	const std::vector<Helios::Surface*>& surfaces = geometry->getSurfaces();
+	size_t shared = 0;
+	for(size_t i = 0 ; i < surfaces.size() ; ++i) {
+		if(surfaces[i]->isShared()) shared++;
+		for(size_t j = i + 1 ; j < surfaces.size() ; ++j)
+			ASSERT_FALSE(*surfaces[i] == *surfaces[j]) << *surfaces[i] << *surfaces[j];
+	}
+	EXPECT_LT(0, shared);
+
+	/*
+	 * Cross the planes of the lattices on the lines and corners of the elements. The cell found (and
+	 * its ancestors) should contain the point, which could be just on the surfaces of the ancestors.
+	 */
+	for(size_t i = 0 ; i < surfaces.size() ; ++i) {
+		const Helios::Surface* surface = surfaces[i];
+		bool xplane = (surface->getName() == "px");
+		if(!xplane && surface->getName() != "py") continue;
+		double plane = -surface->function(Helios::Coordinate(0.0,0.0,0.0));
+		/* Skip the boundaries of the box */
+		if(std::abs(plane) > 2.9) continue;
+		for(int k = -5 ; k <= 5 ; ++k) {
+			/* Corners and middle of the edges */
+			double other = 0.5 * k;
+			Helios::Coordinate point = xplane ? Helios::Coordinate(plane, other, 0.5) : Helios::Coordinate(other, plane, 0.5);
+			for(int sense = 0 ; sense < 2 ; ++sense) {
+				const Helios::Cell* cell;
+				surface->cross(point, sense, cell);
+				ASSERT_TRUE(cell != 0) << "Surface " << surface->getUserId() << " at " << point;
+				for(const Helios::Cell* ancestor = cell ; ancestor ; ancestor = ancestor->getParent()->getParent())
+					EXPECT_TRUE(ancestor->isInside(point, surface, 1e-9))
+						<< "Cell " << ancestor->getUserId() << " crossing surface " << surface->getUserId() << " at " << point;
+			}
+		}
+	}
+}
+
 #endif /* GEOMETRYTESTS_HPP_ */
@@ -25,11 +25,11 @@ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
 SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
-//#include "GeometryTest/GeometryTests.hpp"
+#include "GeometryTest/GeometryTests.hpp"
 //#include "ReactionTest/ReactionTests.hpp"
 //#include "SourceTest/SourceTest.hpp"
-//#include "ReactionTest/GridTest.hpp"
-//#include "AceTest/AceTests.hpp"
+#include "ReactionTest/GridTest.hpp"
+#include "AceTest/AceTests.hpp"
 #include "AceTest/ReactionTest.hpp"
 
 InputPath InputPath::inputpath;
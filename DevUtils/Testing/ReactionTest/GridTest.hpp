@@ -80,10 +80,11 @@ TEST_F(SimpleGridTest, OrderingValues) {
 		double value = randomNumber(min_value,max_value);
 		std::pair<size_t,double> pair_value(0,value);
 		grid->interpolate(pair_value);
-		if(pair_value.first)
+		/* Values on the first interval of the grid also get the index zero */
+		if(value > (*grid)[0])
 			EXPECT_GE(value,(*grid)[pair_value.first]);
 		else
-			EXPECT_LE(value,(*grid)[pair_value.first]);
+			EXPECT_EQ(0u,pair_value.first);
 
 		if(pair_value.first + 1 != grid->size() - 1)
 			EXPECT_LE(value,(*grid)[pair_value.first + 1]);
@@ -255,4 +256,42 @@ TEST_F(ChildGridTest, LinearInterpolation) {
 	}
 }
 
+TEST_F(ChildGridTest, ThinnedLinearInterpolation) {
+	/* All functions are linear, so most of the points of the master grid can be removed */
+	std::vector<std::vector<double> > values(1, std::vector<double>(grid->size()));
+	for(size_t i = 0 ; i < grid->size() ; ++i)
+		values[0][i] = linear_function((*grid)[i]);
+	size_t size = grid->size();
+	size_t memory = grid->getMemory();
+	EXPECT_FALSE(grid->isThinned());
+	size_t removed = grid->thin(values, 1e-10);
+	EXPECT_EQ(size, grid->size() + removed);
+	EXPECT_LT(grid->size(), size);
+	EXPECT_TRUE(grid->isThinned());
+	/* The master grid and the pointers of the childs are smaller */
+	EXPECT_LT(grid->getMemory(), memory);
+
+	/* Child grids should give the same interpolation */
+	for(size_t j = 0 ; j < child_grids.size() ; ++j) {
+		Helios::ChildGrid* child_grid = child_grids[j];
+		/* The pointers are replaced, one for each point of the thinned master grid */
+		EXPECT_EQ(grid->size(), child_grid->pointers());
+		std::vector<double> user_function = user_functions[j];
+		for(size_t i = 0 ; i < random_values.size() ; ++i) {
+			double eval = linear_function(random_values[i]);
+			double factor = 0.0;
+			std::pair<size_t,double> pair_value(0,random_values[i]);
+			size_t idx = child_grid->index(pair_value,factor);
+			/* Interval of the child grid that contains the value */
+			EXPECT_LE((*child_grid)[idx], std::max(random_values[i], (*child_grid)[0]));
+			if(random_values[i] > (*child_grid)[0] && random_values[i] < (*child_grid)[child_grid->size() - 1])
+				EXPECT_GE((*child_grid)[idx + 1], random_values[i]);
+			EXPECT_GE(factor, 0.0);
+			EXPECT_LE(factor, 1.0);
+			double inter = factor * (user_function[idx + 1] - user_function[idx]) + user_function[idx];
+			EXPECT_NEAR(eval,inter,5e8*std::numeric_limits<double>::epsilon());
+		}
+	}
+}
+
 #endif /* GRIDTEST_HPP_ */
@@ -58,9 +58,14 @@ McEnvironment::McEnvironment(int argc, char **argv, Parser* parser) : parser(par
 	pushObject(new SettingsObject("max_source_samples", "100"));
 	pushObject(new SettingsObject("max_rng_per_history", "100000"));
 	pushObject(new SettingsObject("multithread", "tbb"));
+	pushObject(new SettingsObject("threads", "0"));
 	pushObject(new SettingsObject("seed", "10"));
 	pushObject(new SettingsObject("energy_freegas_threshold", "400.0"));
 	pushObject(new SettingsObject("awr_freegas_threshold", "1.0"));
+	pushObject(new SettingsObject("freegas_points", "0"));
+	pushObject(new SettingsObject("spectrum_points", "0"));
+	pushObject(new SettingsObject("ace_compact", "false"));
+	pushObject(new SettingsObject("grid_thinning", "0"));
 }
 
 McEnvironment::McEnvironment(Parser* parser) : parser(parser) {
@@ -75,9 +80,14 @@ McEnvironment::McEnvironment(Parser* parser) : parser(parser) {
 	pushObject(new SettingsObject("max_source_samples", "100"));
 	pushObject(new SettingsObject("max_rng_per_history", "100000"));
 	pushObject(new SettingsObject("multithread", "tbb"));
+	pushObject(new SettingsObject("threads", "0"));
 	pushObject(new SettingsObject("seed", "10"));
 	pushObject(new SettingsObject("energy_freegas_threshold", "400.0"));
 	pushObject(new SettingsObject("awr_freegas_threshold", "1.0"));
+	pushObject(new SettingsObject("freegas_points", "0"));
+	pushObject(new SettingsObject("spectrum_points", "0"));
+	pushObject(new SettingsObject("ace_compact", "false"));
+	pushObject(new SettingsObject("grid_thinning", "0"));
 }
 
 void McEnvironment::parseFile(const std::string& filename) {
@@ -132,6 +142,20 @@ void McEnvironment::setup() {
 
 	/* Finally, we setup the source module */
 	setupModule<Source>();
+
+	/* All the reactions are created, the ACE data not used for sampling can be released */
+	if(isModuleSet<AceModule>() && getSetting<string>("ace_compact","value") == "true")
+		getModule<AceModule>()->compact();
+}
+
+void McEnvironment::printMemory(std::ostream& out) const {
+	size_t total = 0;
+	for(map<string,McModule*>::const_iterator it = module_map.begin() ; it != module_map.end() ; ++it) {
+		size_t memory = (*it).second->getMemory();
+		out << " - " << setw(12) << (*it).first << " : " << memory / 1024 << " kB" << endl;
+		total += memory;
+	}
+	out << " - " << setw(12) << "total" << " : " << total / 1024 << " kB" << endl;
 }
 
 void McEnvironment::simulate() const {
@@ -141,6 +165,15 @@ void McEnvironment::simulate() const {
 	/* Get multithread type of simulation */
 	string multithread = getSetting<string>("multithread", "value");
 
+	/* Number of threads on each node (0 means all the available cores) */
+	int threads = getSetting<int>("threads", "value");
+	tbb::task_scheduler_init init(tbb::task_scheduler_init::deferred);
+	if(threads > 0) {
+		omp_set_num_threads(threads);
+		init.initialize(threads);
+	} else
+		init.initialize();
+
 	/* Create simulation */
 	if(multithread == "tbb")
 		simulation = new ParallelSimulation<AnalogKeff,IntelTbb>(this);
@@ -153,6 +186,10 @@ void McEnvironment::simulate() const {
 
 	Log::msg() << left << Log::ident(1) << " - Multithreading          : " << multithread << Log::endl;
 	Log::fout() << " - Multithreading          : " << multithread << endl;
+	if(threads > 0) {
+		Log::msg() << left << Log::ident(1) << " - Threads                 : " << threads << Log::endl;
+		Log::fout() << " - Threads                 : " << threads << endl;
+	}
 
 	simulation->launch();
 
@@ -156,6 +156,9 @@ namespace Helios {
 		 */
 		void simulate() const;
 
+		/* Print the memory used by each module */
+		void printMemory(std::ostream& out) const;
+
 		/* Register a module factory */
 		void registerFactory(ModuleFactory* factory) {
 			factory_map[factory->getName()] = factory;
@@ -80,6 +80,8 @@ namespace Helios {
 		std::string getName() const {return name;}
 		/*  Get the environment */
 		const McEnvironment* getEnvironment() const {return environment;}
+		/* Approximate memory used by the data of this module (in bytes, zero if it is not accounted) */
+		virtual size_t getMemory() const {return 0;}
 		virtual ~McModule() {/* */};
 	};
 
@@ -43,9 +43,14 @@ static std::map<UserId,std::set<std::string> > setValidSettings() {
 	setSingleValue(settings, "max_rng_per_history");
 	setSingleValue(settings, "xs_data");
 	setSingleValue(settings, "multithread");
+	setSingleValue(settings, "threads");
 	setSingleValue(settings, "seed");
 	setSingleValue(settings, "energy_freegas_threshold");
 	setSingleValue(settings, "awr_freegas_threshold");
+	setSingleValue(settings, "freegas_points");
+	setSingleValue(settings, "spectrum_points");
+	setSingleValue(settings, "ace_compact");
+	setSingleValue(settings, "grid_thinning");
 
 	/* KEFF simulation data */
 	settings["criticality"].insert("batches");
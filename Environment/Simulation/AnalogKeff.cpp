@@ -71,22 +71,33 @@ void AnalogKeff::source(size_t nbank) {
 	fission_bank[nbank] = source_particle;
 }
 
-bool AnalogKeff::voidTransport(const Material*& material, Particle& particle, const Cell*& cell) {
+bool AnalogKeff::voidTransport(const Material*& material, Particle& particle, const Cell*& cell, GeometryState& state) {
 	/* Check the material pointer */
 	while(not material) {
+		HELIOS_PROFILE_LOCAL(profiler);
+		HELIOS_PROFILE_EVENT(VOIDHOPS, 1);
+
 		/* Initialize some auxiliary variables */
 		Surface* surface(0);  /* Surface pointer */
 		bool sense(true);     /* Sense of the surface we are crossing */
 		double distance(0.0); /* Distance to closest surface */
 
 		/* Get next surface's distance */
-		cell->intersect(particle.pos(), particle.dir(), surface, sense, distance);
+		{
+			HELIOS_PROFILE_SCOPE(INTERSECT);
+			cell->intersect(particle.pos(), particle.dir(), surface, sense, distance, state);
+		}
 
 		/* Transport the particle to the surface */
 		particle.pos() = particle.pos() + distance * particle.dir();
 
 		/*  Cross the surface (checking boundary conditions) */
-		bool outside = not surface->cross(particle,sense,cell);
+		bool outside;
+		{
+			HELIOS_PROFILE_SCOPE(CROSS);
+			HELIOS_PROFILE_EVENT(CROSSINGS, 1);
+			outside = not surface->cross(particle,sense,cell);
+		}
 		assert(cell != 0);
 		/* Particle is outside the system */
 		if(outside) return false;
@@ -113,28 +124,44 @@ void AnalogKeff::history(size_t nbank, const std::vector<ChildTally*>& tally_con
 	/* Flag if particle is out of the system */
 	bool outside = false;
 
+	/* Profiling counters of this thread */
+	HELIOS_PROFILE_LOCAL(profiler);
+	HELIOS_PROFILE_EVENT(HISTORIES, 1);
+
 	/* 1. ---- Initialize particle from source (get particle from the bank) */
 	CellParticle& pc = fission_bank[nbank];
 	const Cell* cell = pc.first;
 	Particle& particle = pc.second;
 
+	/* Tracking state of the particle on the geometry */
+	GeometryState& state = states.local();
+	state.reset();
+
 	while(true) {
 
 		/* 2. ---- Get material and mean free path */
 		const Material* material = cell->getMaterial();
 
 		/* Transport the particle until a non-void cell is found (checking boundary conditions) */
-		outside = not voidTransport(material, particle, cell);
+		outside = not voidTransport(material, particle, cell, state);
 		if(outside) {
 			estimate<LEAK>(tally_container, particle.wgt());
 			break;
 		}
 
 		/* 3. ---- Get next surface's distance */
-		cell->intersect(particle.pos(), particle.dir(), surface, sense, distance);
+		{
+			HELIOS_PROFILE_SCOPE(INTERSECT);
+			cell->intersect(particle.pos(), particle.dir(), surface, sense, distance, state);
+		}
 
 		/* 4. ---- Get collision distance */
-		double mfp = material->getMeanFreePath(particle.erg());
+		double mfp;
+		{
+			HELIOS_PROFILE_SCOPE(XSLOOKUP);
+			HELIOS_PROFILE_EVENT(LOOKUPS, 1);
+			mfp = material->getMeanFreePath(particle.erg());
+		}
 		double collision_distance = -log(r.uniform())*mfp;
 
 		/* 5. ---- Check sampled distance against closest surface distance */
@@ -146,24 +173,35 @@ void AnalogKeff::history(size_t nbank, const std::vector<ChildTally*>& tally_con
 				estimate<KEFF_TRK>(tally_container, particle.wgt() * distance * material->getNuFission(particle.erg()));
 
 			/* 5.2 ---- Cross the surface (checking boundary conditions) */
-			outside = not surface->cross(particle,sense,cell);
+			{
+				HELIOS_PROFILE_SCOPE(CROSS);
+				HELIOS_PROFILE_EVENT(CROSSINGS, 1);
+				outside = not surface->cross(particle,sense,cell);
+			}
 			assert(cell != 0);
 			if(outside) break;
 
 			/* 5.3 ---- Get material of the current cell (after crossing the surface) */
 			const Material* new_material = cell->getMaterial();
 			/* Transport the particle until a non-void cell is found (checking boundary conditions) */
-			outside = not voidTransport(new_material, particle, cell);
+			outside = not voidTransport(new_material, particle, cell, state);
 			if(outside) break;
 
 			/* 5.4 ---- Get next surface's distance */
 			double new_distance(0.0);
-			cell->intersect(particle.pos(), particle.dir(), surface, sense, new_distance);
+			{
+				HELIOS_PROFILE_SCOPE(INTERSECT);
+				cell->intersect(particle.pos(), particle.dir(), surface, sense, new_distance, state);
+			}
 
 			/* Check if there is a change on the material */
 			if(new_material != material) {
 				/* Mean free path (the particle didn't change the energy) */
-				mfp = new_material->getMeanFreePath(particle.erg());
+				{
+					HELIOS_PROFILE_SCOPE(XSLOOKUP);
+					HELIOS_PROFILE_EVENT(LOOKUPS, 1);
+					mfp = new_material->getMeanFreePath(particle.erg());
+				}
 				/* 5.5 ---- Get collision distance */
 				collision_distance = -log(r.uniform())*mfp;
 				/* Update distance */
@@ -188,18 +226,24 @@ void AnalogKeff::history(size_t nbank, const std::vector<ChildTally*>& tally_con
 
 		/* 6. Move the particle to the collision point */
 		particle.pos() = particle.pos() + collision_distance * particle.dir();
+		HELIOS_PROFILE_EVENT(COLLISIONS, 1);
 		/* Accumulate track length estimation of the KEFF */
 		if(material->isFissile())
 			estimate<KEFF_TRK>(tally_container, particle.wgt() * collision_distance * material->getNuFission(particle.erg()));
 
 		/* 7. ---- Sample isotope */
-		const Isotope* isotope = material->getIsotope(particle.erg(),r);
+		const Isotope* isotope;
+		{
+			HELIOS_PROFILE_SCOPE(ISOTOPE);
+			isotope = material->getIsotope(particle.erg(),r);
+		}
 
 		/* Accumulate collision estimation of the KEFF */
 		if(material->isFissile())
 			estimate<KEFF_COL>(tally_container, particle.wgt() * material->getNuBar(particle.erg()));
 
 		/* 8. ---- Sample reaction with the isotope */
+		HELIOS_PROFILE_SCOPE(REACTION);
 
 		/* 8.1 ---- Check the type of reaction reaction */
 		double absorption = isotope->getAbsorptionProb(particle.erg());
@@ -229,6 +273,7 @@ void AnalogKeff::history(size_t nbank, const std::vector<ChildTally*>& tally_con
 					Reaction* fission_reaction = isotope->fission(particle.erg(),r);
 					/* Accumulate population (always, no matter if the cycle is active or inactive) */
 					tally_container[POP]->acc(particle.wgt() * nu);
+					HELIOS_PROFILE_EVENT(FISSIONSITES, nu);
 					/* We should bank the particle state after simulating the fission reaction */
 					for(int i = 0 ; i < nu ; ++i) {
 						Particle new_particle(particle);
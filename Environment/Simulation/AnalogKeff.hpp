@@ -28,6 +28,8 @@
 #ifndef ANALOGKEFF_HPP_
 #define ANALOGKEFF_HPP_
 
+#include <tbb/enumerable_thread_specific.h>
+
 #include "Simulation.hpp"
 
 namespace Helios {
@@ -41,9 +43,11 @@ class AnalogKeff: public Helios::SimulationBase {
 	std::vector<CellParticle> fission_bank;
 	/* Local bank on a cycle simulation */
 	vector<vector<CellParticle> > local_bank;
+	/* Tracking state on the geometry of each thread (reused by the histories simulated on it) */
+	tbb::enumerable_thread_specific<GeometryState> states;
 
 	/* Transport a particle through void cells until a material is found or the particle get out of the system */
-	bool voidTransport(const Material*& material, Particle& particle, const Cell*& cell);
+	bool voidTransport(const Material*& material, Particle& particle, const Cell*& cell, GeometryState& state);
 
 	/* Estimators inside the cycle */
 	enum Estimator {
@@ -0,0 +1,121 @@
+/*
+ Copyright (c) 2012, Esteban Pellegrino
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright
+ notice, this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+ * Neither the name of the <organization> nor the
+ names of its contributors may be used to endorse or promote products
+ derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <unistd.h>
+#include <cstring>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#include "../../Common/Log/Log.hpp"
+#include "PerfCounters.hpp"
+
+using namespace std;
+
+namespace Helios {
+
+#ifdef __linux__
+/* Open one counter for the calling thread (there is no glibc wrapper for this call) */
+static int openCounter(uint32_t type, uint64_t config) {
+	struct perf_event_attr attr;
+	memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = type;
+	attr.config = config;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+	return syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+#endif
+
+/* Warn only once when the counters are not available */
+static volatile int perf_warning = 0;
+
+PerfCounters::PerfCounters() {
+	open();
+}
+
+PerfCounters::PerfCounters(const PerfCounters& other) {
+	open();
+}
+
+void PerfCounters::open() {
+	for(size_t i = 0 ; i < NCOUNTERS ; ++i)
+		fds[i] = -1;
+
+#ifdef __linux__
+	fds[CYCLES] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+	fds[INSTRUCTIONS] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+	fds[CACHEMISSES] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+	fds[TLBMISSES] = openCounter(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB |
+			(PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+#endif
+
+	if(!isOpen() && __sync_lock_test_and_set(&perf_warning, 1) == 0)
+		Log::warn() << "Hardware performance counters are not available on this system" << Log::endl;
+}
+
+bool PerfCounters::isOpen() const {
+	for(size_t i = 0 ; i < NCOUNTERS ; ++i)
+		if(fds[i] >= 0) return true;
+	return false;
+}
+
+void PerfCounters::read(uint64_t values[NCOUNTERS]) const {
+	for(size_t i = 0 ; i < NCOUNTERS ; ++i) {
+		values[i] = 0;
+		if(fds[i] < 0) continue;
+		/* Value, time enabled and time running */
+		uint64_t data[3];
+		if(::read(fds[i], data, sizeof(data)) != sizeof(data)) continue;
+		/* Scale the value if the counter was multiplexed */
+		if(data[2] > 0 && data[2] < data[1])
+			values[i] = (uint64_t)((double)data[0] * (double)data[1] / (double)data[2]);
+		else
+			values[i] = data[0];
+	}
+}
+
+string PerfCounters::getName(Counter counter) {
+	switch(counter) {
+	case CYCLES       : return "cycles";
+	case INSTRUCTIONS : return "instructions";
+	case CACHEMISSES  : return "cache_misses";
+	case TLBMISSES    : return "dtlb_misses";
+	default           : return "unknown";
+	}
+}
+
+PerfCounters::~PerfCounters() {
+	for(size_t i = 0 ; i < NCOUNTERS ; ++i)
+		if(fds[i] >= 0) close(fds[i]);
+}
+
+} /* namespace Helios */
@@ -0,0 +1,83 @@
+/*
+ Copyright (c) 2012, Esteban Pellegrino
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright
+ notice, this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+ * Neither the name of the <organization> nor the
+ names of its contributors may be used to endorse or promote products
+ derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PERFCOUNTERS_HPP_
+#define PERFCOUNTERS_HPP_
+
+#include <stdint.h>
+#include <string>
+
+namespace Helios {
+
+/*
+ * Hardware performance counters of the calling thread (Linux perf_event_open). The counters
+ * are opened on construction and count only user space events of the thread that created
+ * the object. If the kernel doesn't allow the counters (see /proc/sys/kernel/perf_event_paranoid)
+ * the values are always zero.
+ */
+class PerfCounters {
+
+public:
+
+	/* Counters opened on each thread */
+	enum Counter {
+		CYCLES       = 0, /* CPU cycles */
+		INSTRUCTIONS = 1, /* Retired instructions */
+		CACHEMISSES  = 2, /* Last level cache misses */
+		TLBMISSES    = 3, /* Data TLB load misses */
+		NCOUNTERS    = 4
+	};
+
+	/* Open the counters for the calling thread */
+	PerfCounters();
+
+	/* Copies open a new set of counters for the calling thread (file descriptors are not shared) */
+	PerfCounters(const PerfCounters& other);
+
+	/* Check if at least one counter is available */
+	bool isOpen() const;
+
+	/* Read the current value of the counters (scaled if the kernel multiplexed them) */
+	void read(uint64_t values[NCOUNTERS]) const;
+
+	/* Name of a counter */
+	static std::string getName(Counter counter);
+
+	~PerfCounters();
+
+private:
+	PerfCounters& operator=(const PerfCounters& other);
+
+	/* Open the counters */
+	void open();
+
+	/* File descriptors of each counter (-1 if not available) */
+	int fds[NCOUNTERS];
+};
+
+} /* namespace Helios */
+#endif /* PERFCOUNTERS_HPP_ */
@@ -0,0 +1,262 @@
+/*
+ Copyright (c) 2012, Esteban Pellegrino
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright
+ notice, this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+ * Neither the name of the <organization> nor the
+ names of its contributors may be used to endorse or promote products
+ derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <boost/mpi.hpp>
+#include <fstream>
+#include <iomanip>
+#include <functional>
+
+#include "../../Common/Log/Log.hpp"
+#include "Profiler.hpp"
+
+using namespace std;
+namespace mpi = boost::mpi;
+
+namespace Helios {
+
+Profiler::Profiler(const boost::mpi::communicator& comm) : comm(comm), start_ticks(0), start_ns(0) {/* */}
+
+string Profiler::getPhaseName(Phase phase) {
+	switch(phase) {
+	case SOURCE     : return "source";
+	case TRANSPORT  : return "transport";
+	case REDUCE     : return "reduce_tallies";
+	case AFTERBATCH : return "after_batch";
+	case INTERSECT  : return "intersect";
+	case CROSS      : return "cross";
+	case XSLOOKUP   : return "xs_lookup";
+	case ISOTOPE    : return "isotope";
+	case REACTION   : return "reaction";
+	default         : return "unknown";
+	}
+}
+
+string Profiler::getEventName(Event event) {
+	switch(event) {
+	case HISTORIES    : return "histories";
+	case COLLISIONS   : return "collisions";
+	case CROSSINGS    : return "crossings";
+	case VOIDHOPS     : return "void_hops";
+	case FISSIONSITES : return "fission_sites";
+	case LOOKUPS      : return "lookups";
+	default           : return "unknown";
+	}
+}
+
+void Profiler::beginBatch() {
+	/* Clear the values (the references to the thread counters are still valid) */
+	for(tbb::enumerable_thread_specific<Counters>::iterator it = counters.begin() ; it != counters.end() ; ++it)
+		it->clear();
+#ifdef HELIOS_PERF
+	/* Start the hardware counters from this point */
+	for(tbb::enumerable_thread_specific<Counters>::iterator it = counters.begin() ; it != counters.end() ; ++it)
+		it->perf.read(it->last);
+#endif
+	/* Save the current state of the clocks */
+	start_ticks = ticks();
+	start_ns = nanoseconds();
+}
+
+void Profiler::samplePhase(Phase phase) {
+#ifdef HELIOS_PERF
+	/* The counters of other threads can be read from here (they are only read, not modified) */
+	for(tbb::enumerable_thread_specific<Counters>::iterator it = counters.begin() ; it != counters.end() ; ++it)
+		it->sample(phase);
+#endif
+}
+
+void Profiler::endBatch(bool active, size_t particles) {
+	/* Elapsed wall time on this node */
+	uint64_t end_ticks = ticks();
+	double wall = (double)(nanoseconds() - start_ns) * 1.0e-9;
+	/* Calibrate the counter using the wall time of the batch (assumes an invariant TSC) */
+	double seconds_per_tick = 0.0;
+	if(end_ticks > start_ticks)
+		seconds_per_tick = wall / (double)(end_ticks - start_ticks);
+
+	/* Combine the counters of all threads */
+	vector<double> seconds(NPHASES, 0.0);
+	vector<uint64_t> events(NEVENTS, 0);
+	for(tbb::enumerable_thread_specific<Counters>::const_iterator it = counters.begin() ; it != counters.end() ; ++it) {
+		for(size_t i = 0 ; i < NPHASES ; ++i)
+			seconds[i] += (double)it->ticks[i] * seconds_per_tick;
+		for(size_t i = 0 ; i < NEVENTS ; ++i)
+			events[i] += it->events[i];
+	}
+	size_t threads = counters.size();
+
+#ifdef HELIOS_PERF
+	/* Combine the hardware counters of all threads */
+	vector<uint64_t> hardware(NBATCHPHASES * PerfCounters::NCOUNTERS, 0);
+	for(tbb::enumerable_thread_specific<Counters>::const_iterator it = counters.begin() ; it != counters.end() ; ++it)
+		for(size_t i = 0 ; i < NBATCHPHASES ; ++i)
+			for(size_t j = 0 ; j < PerfCounters::NCOUNTERS ; ++j)
+				hardware[i * PerfCounters::NCOUNTERS + j] += it->hardware[i][j];
+#endif
+
+	/* Reduce among nodes */
+	BatchRecord record;
+	record.batch = records.size() + 1;
+	record.active = active;
+	record.particles = particles;
+	record.seconds.resize(NPHASES, 0.0);
+	record.events.resize(NEVENTS, 0);
+	mpi::reduce(comm, &seconds[0], NPHASES, &record.seconds[0], std::plus<double>(), 0);
+	mpi::reduce(comm, &events[0], NEVENTS, &record.events[0], std::plus<uint64_t>(), 0);
+	mpi::reduce(comm, wall, record.wall, mpi::maximum<double>(), 0);
+	mpi::reduce(comm, threads, record.threads, mpi::maximum<size_t>(), 0);
+#ifdef HELIOS_PERF
+	record.hardware.resize(hardware.size(), 0);
+	mpi::reduce(comm, &hardware[0], hardware.size(), &record.hardware[0], std::plus<uint64_t>(), 0);
+#endif
+
+	/* Only the master keeps the records */
+	if(comm.rank() == 0)
+		records.push_back(record);
+}
+
+uint64_t Profiler::getHardware(const BatchRecord& record, size_t phase, size_t counter) {
+#ifdef HELIOS_PERF
+	if(record.hardware.empty()) return 0;
+	return record.hardware[phase * PerfCounters::NCOUNTERS + counter];
+#else
+	return 0;
+#endif
+}
+
+#ifdef HELIOS_PERF
+/* Ratio between two counters (zero if the denominator is zero) */
+static double ratio(uint64_t num, uint64_t den) {
+	if(den == 0) return 0.0;
+	return (double)num / (double)den;
+}
+#endif
+
+void Profiler::printJson(std::ostream& out) const {
+	out << "{" << endl;
+	out << "  \"nodes\" : " << comm.size() << "," << endl;
+	out << "  \"batches\" : [" << endl;
+	for(vector<BatchRecord>::const_iterator it = records.begin() ; it != records.end() ; ++it) {
+		out << "    {" << endl;
+		out << "      \"batch\" : " << it->batch << "," << endl;
+		out << "      \"type\" : \"" << (it->active ? "active" : "inactive") << "\"," << endl;
+		out << "      \"particles\" : " << it->particles << "," << endl;
+		out << "      \"threads\" : " << it->threads << "," << endl;
+		out << "      \"wall\" : " << it->wall << "," << endl;
+		out << "      \"phases\" : {";
+		for(size_t i = 0 ; i < NPHASES ; ++i)
+			out << (i ? ", " : " ") << "\"" << getPhaseName((Phase)i) << "\" : " << it->seconds[i];
+		out << " }," << endl;
+		out << "      \"events\" : {";
+		for(size_t i = 0 ; i < NEVENTS ; ++i)
+			out << (i ? ", " : " ") << "\"" << getEventName((Event)i) << "\" : " << it->events[i];
+#ifdef HELIOS_PERF
+		out << " }," << endl;
+		/* Hardware counters of each batch phase */
+		out << "      \"hardware\" : {" << endl;
+		for(size_t i = 0 ; i < NBATCHPHASES ; ++i) {
+			out << "        \"" << getPhaseName((Phase)i) << "\" : {";
+			for(size_t j = 0 ; j < PerfCounters::NCOUNTERS ; ++j)
+				out << " \"" << PerfCounters::getName((PerfCounters::Counter)j) << "\" : " << getHardware(*it, i, j) << ",";
+			out << " \"ipc\" : " << ratio(getHardware(*it, i, PerfCounters::INSTRUCTIONS), getHardware(*it, i, PerfCounters::CYCLES))
+				<< " }" << ((i + 1 < NBATCHPHASES) ? "," : "") << endl;
+		}
+		out << "      }," << endl;
+		/* Derived metrics of the transport phase */
+		uint64_t collisions = it->events[COLLISIONS];
+		out << "      \"derived\" : {";
+		out << " \"cache_misses_per_collision\" : " << ratio(getHardware(*it, TRANSPORT, PerfCounters::CACHEMISSES), collisions) << ",";
+		out << " \"dtlb_misses_per_collision\" : " << ratio(getHardware(*it, TRANSPORT, PerfCounters::TLBMISSES), collisions) << ",";
+		out << " \"instructions_per_collision\" : " << ratio(getHardware(*it, TRANSPORT, PerfCounters::INSTRUCTIONS), collisions);
+#endif
+		out << " }" << endl;
+		out << "    }" << ((it + 1 != records.end()) ? "," : "") << endl;
+	}
+	out << "  ]" << endl;
+	out << "}" << endl;
+}
+
+void Profiler::printCsv(std::ostream& out) const {
+	/* Header */
+	out << "batch,type,particles,threads,wall";
+	for(size_t i = 0 ; i < NPHASES ; ++i)
+		out << "," << getPhaseName((Phase)i);
+	for(size_t i = 0 ; i < NEVENTS ; ++i)
+		out << "," << getEventName((Event)i);
+#ifdef HELIOS_PERF
+	for(size_t i = 0 ; i < NBATCHPHASES ; ++i) {
+		for(size_t j = 0 ; j < PerfCounters::NCOUNTERS ; ++j)
+			out << "," << getPhaseName((Phase)i) << "_" << PerfCounters::getName((PerfCounters::Counter)j);
+		out << "," << getPhaseName((Phase)i) << "_ipc";
+	}
+	out << ",cache_misses_per_collision,dtlb_misses_per_collision,instructions_per_collision";
+#endif
+	out << endl;
+	/* One line per batch */
+	for(vector<BatchRecord>::const_iterator it = records.begin() ; it != records.end() ; ++it) {
+		out << it->batch << "," << (it->active ? "active" : "inactive") << "," << it->particles
+			<< "," << it->threads << "," << it->wall;
+		for(size_t i = 0 ; i < NPHASES ; ++i)
+			out << "," << it->seconds[i];
+		for(size_t i = 0 ; i < NEVENTS ; ++i)
+			out << "," << it->events[i];
+#ifdef HELIOS_PERF
+		for(size_t i = 0 ; i < NBATCHPHASES ; ++i) {
+			for(size_t j = 0 ; j < PerfCounters::NCOUNTERS ; ++j)
+				out << "," << getHardware(*it, i, j);
+			out << "," << ratio(getHardware(*it, i, PerfCounters::INSTRUCTIONS), getHardware(*it, i, PerfCounters::CYCLES));
+		}
+		uint64_t collisions = it->events[COLLISIONS];
+		out << "," << ratio(getHardware(*it, TRANSPORT, PerfCounters::CACHEMISSES), collisions);
+		out << "," << ratio(getHardware(*it, TRANSPORT, PerfCounters::TLBMISSES), collisions);
+		out << "," << ratio(getHardware(*it, TRANSPORT, PerfCounters::INSTRUCTIONS), collisions);
+#endif
+		out << endl;
+	}
+}
+
+void Profiler::report(const std::string& prefix) const {
+	if(comm.rank() != 0) return;
+
+	string json_file = prefix + ".profile.json";
+	string csv_file = prefix + ".profile.csv";
+
+	ofstream json(json_file.c_str());
+	ofstream csv(csv_file.c_str());
+	if(!json.is_open() || !csv.is_open()) {
+		Log::warn() << "Cannot open the profiling report files (" << json_file << ", " << csv_file << ")" << Log::endl;
+		return;
+	}
+	json << setprecision(9);
+	csv << setprecision(9);
+	printJson(json);
+	printCsv(csv);
+
+	Log::msg() << left << "Profiling report       : " << json_file << " , " << csv_file << Log::endl;
+}
+
+} /* namespace Helios */
@@ -0,0 +1,225 @@
+/*
+ Copyright (c) 2012, Esteban Pellegrino
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright
+ notice, this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+ * Neither the name of the <organization> nor the
+ names of its contributors may be used to endorse or promote products
+ derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PROFILER_HPP_
+#define PROFILER_HPP_
+
+#include <time.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+#include <tbb/enumerable_thread_specific.h>
+#include <boost/mpi/communicator.hpp>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#ifdef HELIOS_PERF
+#include "PerfCounters.hpp"
+#endif
+
+namespace Helios {
+
+/*
+ * Phase timers and event counters of the transport loop. Each worker thread accumulates
+ * on its own copy of the counters (no locks on the history loop). The counters are combined
+ * at the end of each batch and reduced among all the MPI nodes on the master.
+ *
+ * The hooks inside the simulation are compiled only when HELIOS_PROFILE is defined (the
+ * HELIOS_PROFILE option on the CMake file), otherwise the macros below expand to nothing.
+ *
+ * If HELIOS_PERF is also defined, each thread opens hardware counters (PerfCounters) that
+ * are sampled on the boundaries of the batch phases (SOURCE, TRANSPORT, REDUCE and AFTERBATCH).
+ */
+class Profiler {
+
+public:
+
+	/* Timed phases */
+	enum Phase {
+		SOURCE     = 0, /* Preparation of the source bank before the batch */
+		TRANSPORT  = 1, /* Simulation of the batch (includes all the history phases) */
+		REDUCE     = 2, /* Tally reduction */
+		AFTERBATCH = 3, /* Update of the simulation after the batch */
+		INTERSECT  = 4, /* Distance to the closest surface (Cell::intersect) */
+		CROSS      = 5, /* Surface crossing (Surface::cross) */
+		XSLOOKUP   = 6, /* Material cross sections lookups */
+		ISOTOPE    = 7, /* Isotope sampling */
+		REACTION   = 8, /* Reaction sampling and kernels */
+		NPHASES    = 9,
+		NBATCHPHASES = AFTERBATCH + 1 /* Phases of the batch (where hardware counters are sampled) */
+	};
+
+	/* Counted events */
+	enum Event {
+		HISTORIES    = 0, /* Simulated histories */
+		COLLISIONS   = 1, /* Collisions */
+		CROSSINGS    = 2, /* Surface crossings */
+		VOIDHOPS     = 3, /* Crossings of void cells */
+		FISSIONSITES = 4, /* Banked fission sites */
+		LOOKUPS      = 5, /* Material cross section lookups */
+		NEVENTS      = 6
+	};
+
+	/* Counters of one thread */
+	struct Counters {
+		uint64_t ticks[NPHASES];
+		uint64_t events[NEVENTS];
+#ifdef HELIOS_PERF
+		PerfCounters perf;                                        /* Hardware counters of the thread */
+		uint64_t last[PerfCounters::NCOUNTERS];                   /* Values on the last sample */
+		uint64_t hardware[NBATCHPHASES][PerfCounters::NCOUNTERS]; /* Values accumulated on each phase */
+		Counters() {clear(); perf.read(last);}
+		/* Accumulate the counters since the last sample on a phase */
+		void sample(Phase phase) {
+			uint64_t current[PerfCounters::NCOUNTERS];
+			perf.read(current);
+			for(size_t i = 0 ; i < PerfCounters::NCOUNTERS ; ++i) {
+				hardware[phase][i] += current[i] - last[i];
+				last[i] = current[i];
+			}
+		}
+#else
+		Counters() {clear();}
+#endif
+		void clear() {
+			for(size_t i = 0 ; i < NPHASES ; ++i) ticks[i] = 0;
+			for(size_t i = 0 ; i < NEVENTS ; ++i) events[i] = 0;
+#ifdef HELIOS_PERF
+			for(size_t i = 0 ; i < NBATCHPHASES ; ++i)
+				for(size_t j = 0 ; j < PerfCounters::NCOUNTERS ; ++j) hardware[i][j] = 0;
+#endif
+		}
+	};
+
+	/* Accumulate the ticks elapsed on a phase while the object is alive */
+	class Scope {
+		uint64_t& acc;
+		uint64_t start;
+	public:
+		Scope(Counters& counters, Phase phase) : acc(counters.ticks[phase]), start(ticks()) {/* */}
+		~Scope() {acc += ticks() - start;}
+	};
+
+	/* Reduced data of one batch */
+	struct BatchRecord {
+		size_t batch;                 /* Batch number */
+		bool active;                  /* Active or inactive batch */
+		size_t particles;             /* Number of particles simulated */
+		size_t threads;               /* Number of threads (maximum among nodes) */
+		double wall;                  /* Wall time of the batch (maximum among nodes) */
+		std::vector<double> seconds;  /* Time spent on each phase (sum over threads and nodes) */
+		std::vector<uint64_t> events; /* Events (sum over threads and nodes) */
+		std::vector<uint64_t> hardware; /* Hardware counters on each batch phase (empty if not used) */
+	};
+
+	Profiler(const boost::mpi::communicator& comm);
+
+	/* Get counters of the calling thread */
+	Counters& local() {return counters.local();}
+
+	/* Reset the counters at the beginning of a batch */
+	void beginBatch();
+
+	/* Attribute the hardware counters of all threads since the last sample to a batch phase */
+	void samplePhase(Phase phase);
+
+	/* Combine the counters of all the threads and nodes at the end of a batch (collective) */
+	void endBatch(bool active, size_t particles);
+
+	/* Write the JSON and CSV reports using a prefix for the file names (only on master) */
+	void report(const std::string& prefix) const;
+
+	/* Get the batch records (only on master) */
+	const std::vector<BatchRecord>& getRecords() const {return records;}
+
+	/* Names of phases and events */
+	static std::string getPhaseName(Phase phase);
+	static std::string getEventName(Event event);
+
+	/* Value of the time stamp counter (or monotonic clock in nanoseconds) */
+	static uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+		return __rdtsc();
+#else
+		return nanoseconds();
+#endif
+	}
+
+	/* Monotonic clock in nanoseconds */
+	static uint64_t nanoseconds() {
+		timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+	}
+
+	~Profiler() {/* */}
+
+private:
+	/* Get a hardware counter of a phase on a batch record */
+	static uint64_t getHardware(const BatchRecord& record, size_t phase, size_t counter);
+
+	/* Print records on the output streams */
+	void printJson(std::ostream& out) const;
+	void printCsv(std::ostream& out) const;
+
+	/* MPI communicator */
+	const boost::mpi::communicator& comm;
+	/* Thread local counters */
+	tbb::enumerable_thread_specific<Counters> counters;
+	/* Ticks and clock at the beginning of the batch (used to calibrate the counter) */
+	uint64_t start_ticks;
+	uint64_t start_ns;
+	/* Batch records */
+	std::vector<BatchRecord> records;
+};
+
+} /* namespace Helios */
+
+#ifdef HELIOS_PROFILE
+/* Get the counters of the calling thread */
+#define HELIOS_PROFILE_LOCAL(profiler) Helios::Profiler::Counters& helios_profile_counters = (profiler).local()
+/* Time a phase until the end of the current scope */
+#define HELIOS_PROFILE_SCOPE(phase) Helios::Profiler::Scope helios_profile_scope(helios_profile_counters, Helios::Profiler::phase)
+/* Count events */
+#define HELIOS_PROFILE_EVENT(event, n) helios_profile_counters.events[Helios::Profiler::event] += (n)
+#else
+#define HELIOS_PROFILE_LOCAL(profiler)
+#define HELIOS_PROFILE_SCOPE(phase)
+#define HELIOS_PROFILE_EVENT(event, n)
+#endif
+
+#if defined(HELIOS_PROFILE) && defined(HELIOS_PERF)
+/* Attribute the hardware counters to a batch phase */
+#define HELIOS_PROFILE_SAMPLE(profiler, phase) (profiler).samplePhase(Helios::Profiler::phase)
+#else
+#define HELIOS_PROFILE_SAMPLE(profiler, phase)
+#endif
+
+#endif /* PROFILER_HPP_ */
@@ -43,7 +43,7 @@ SimulationBase::SimulationBase(const McEnvironment* environment, size_t nparticl
 		initial_source(environment->getModule<Source>()),
 		nbatches(nbatches), nparticles(nparticles), ninactive(ninactive), simulation_type(INACTIVE),
 		local_comm(environment->getCommunicator()),
-		local_stride(0) {
+		local_stride(0), profiler(local_comm) {
 
 	/* Check number of batches and inactive cycles */
 	if(nbatches < ninactive)
@@ -124,21 +124,53 @@ void SimulationBase::batch(SimulationType type) {
 	/* Set current type */
 	simulation_type = type;
 
+#ifdef HELIOS_PROFILE
+	/* Number of particles simulated on this batch */
+	size_t batch_particles = nparticles;
+	/* Reset profiling counters */
+	profiler.beginBatch();
+#endif
+	HELIOS_PROFILE_LOCAL(profiler);
+
 	/* Make internal updates before simulating the batch */
-	beforeBatch();
+	{
+		HELIOS_PROFILE_SCOPE(SOURCE);
+		beforeBatch();
+	}
+	HELIOS_PROFILE_SAMPLE(profiler, SOURCE);
 
 	/* Simulate the batch of particles */
-	simulateBatch();
+	{
+		HELIOS_PROFILE_SCOPE(TRANSPORT);
+		simulateBatch();
+	}
+	HELIOS_PROFILE_SAMPLE(profiler, TRANSPORT);
 
 	/* ---- Reduce tallies */
-	if(simulation_type == INACTIVE) reduceTallies(inactive_tallies);
-	else if(simulation_type == ACTIVE) reduceTallies(active_tallies);
+	{
+		HELIOS_PROFILE_SCOPE(REDUCE);
+		if(simulation_type == INACTIVE) reduceTallies(inactive_tallies);
+		else if(simulation_type == ACTIVE) reduceTallies(active_tallies);
+	}
+	HELIOS_PROFILE_SAMPLE(profiler, REDUCE);
 
 	/* Update internal data */
-	afterBatch();
+	{
+		HELIOS_PROFILE_SCOPE(AFTERBATCH);
+		afterBatch();
+	}
+	HELIOS_PROFILE_SAMPLE(profiler, AFTERBATCH);
+
+#ifdef HELIOS_PROFILE
+	/* Combine profiling counters of all threads and nodes */
+	profiler.endBatch(simulation_type == ACTIVE, batch_particles);
+#endif
 }
 
 void SimulationBase::launch() {
+	/* The first inactive batch is used to gather statistics of the cell expressions and the surface crossings */
+	Geometry* geometry = environment->getModule<Geometry>();
+
 	/* Simulate inactive batches */
 	for(size_t i = 0 ; i < ninactive ; ++i) {
 		/* Print information */
@@ -146,7 +178,9 @@ void SimulationBase::launch() {
 				<< setw(4) << right << i + 1 << " / " << setw(4) << left << ninactive << Log::endl;
 
 		/* Simulate batch */
+		if(i == 0) geometry->setStatistics(true);
 		batch(INACTIVE);
+		if(i == 0) geometry->optimize();
 	}
 
 	/* Get number of active nactive */
@@ -197,6 +231,11 @@ void SimulationBase::launch() {
 		(*it)->print(Log::fout());
 		Log::fout() << endl;
 	}
+
+#ifdef HELIOS_PROFILE
+	/* Write profiling report next to the output file */
+	profiler.report(Log::getOutput());
+#endif
 }
 
 } /* namespace Helios */
@@ -37,6 +37,7 @@
 #include "../McEnvironment.hpp"
 
 #include "../../Tallies/Tally.hpp"
+#include "Profiler.hpp"
 
 namespace Helios {
 
@@ -93,6 +94,9 @@ protected:
 	/* Local counters (this "tallies" should be synchronized after each inactive batch simulation) */
 	TallyContainer inactive_tallies;
 
+	/* ---- Profiling of the simulation phases (only used when HELIOS_PROFILE is defined) */
+	Profiler profiler;
+
 	/* Simulate a batch of particles */
 	void batch(SimulationType type);
 
@@ -26,6 +26,7 @@
  */
 
 #include <limits>
+#include <cmath>
 
 #include "Cell.hpp"
 #include "Universe.hpp"
@@ -38,19 +39,27 @@ using namespace boost;
 
 namespace Helios {
 
-Cell::Cell(const CellObject* definition, const std::vector<SenseSurface>& surfaces) :
+Cell::Cell(const CellObject* definition, const std::vector<SenseSurface>& surfaces, const CellExpression& expression) :
 	surfaces(surfaces),
+	expression(expression),
 	flag(definition->getFlags()),
 	fill(0),
 	material(0),
 	parent(0),
 	internal_id(0),
+	feature_index(-1),
 	user_id(definition->getUserCellId())
 	{
     /* Set the new cell on surfaces neighbor container */
     vector<Cell::SenseSurface>::const_iterator it_sur = surfaces.begin();
 	for(; it_sur != surfaces.end() ; ++it_sur)
 		(*it_sur).first->addNeighborCell((*it_sur).second,this);
+
+	/* Pack the surfaces by type (only on intersections, the expression is evaluated otherwise) */
+	if(expression.empty())
+		for(it_sur = surfaces.begin() ; it_sur != surfaces.end() ; ++it_sur)
+		if(!(*it_sur).first->pack(surface_pack, (*it_sur).second))
+			unpacked_surfaces.push_back(*it_sur);
 }
 
 void Cell::setFill(Universe* universe) {
@@ -74,6 +83,13 @@ std::ostream& operator<<(std::ostream& out, const Cell& q) {
 	/* Print flags */
 	out << " ; flags = " << q.getFlag(); out << endl;
 
+	/* Print expression */
+	if(!q.expression.empty()) {
+		out << Log::ident(2) << "expression = ";
+		q.expression.print(out);
+		out << endl;
+	}
+
 	/* Print surfaces */
 	vector<Cell::SenseSurface>::const_iterator it_sur = q.surfaces.begin();
 	while(it_sur != q.surfaces.end()) {
@@ -88,8 +104,13 @@ std::ostream& operator<<(std::ostream& out, const Cell& q) {
 }
 
 bool Cell::isInside(const Coordinate& position, const Surface* skip) const {
+	/* Unions or complements */
+	if(!expression.empty()) return expression.evaluate(position, skip);
+	/* Packed surfaces */
+	if(!surface_pack.isInside(position, skip)) return false;
+	/* Rest of the surfaces */
 	vector<SenseSurface>::const_iterator it;
-	for (it = surfaces.begin(); it != surfaces.end(); ++it) {
+	for (it = unpacked_surfaces.begin(); it != unpacked_surfaces.end(); ++it) {
 		if (it->first != skip) {
 			if (it->first->sense(position) != it->second)
 			/* The sense of the point isn't the same the same sense as we know this cell is defined... */
@@ -99,6 +120,19 @@ bool Cell::isInside(const Coordinate& position, const Surface* skip) const {
 	return true;
 }
 
+bool Cell::isInside(const Coordinate& position, const Surface* skip, double tolerance) const {
+	/* Unions or complements */
+	if(!expression.empty()) return expression.evaluate(position, skip);
+	vector<SenseSurface>::const_iterator it;
+	for (it = surfaces.begin(); it != surfaces.end(); ++it) {
+		if (it->first == skip) continue;
+		double value = it->first->function(position);
+		if ((value >= 0) != it->second && std::abs(value) > tolerance)
+			return false;
+	}
+	return true;
+}
+
 const Cell* Cell::findCell(const Coordinate& position, const Surface* skip) const {
 	/* Check if the point is inside this cell */
 	if(!isInside(position,skip)) return 0;
@@ -119,9 +153,75 @@ void Cell::intersect(const Coordinate& position, const Direction& direction, Sur
         distance = std::numeric_limits<double>::infinity();
     }
 
-    /* Loop over surfaces */
+    /* Surfaces of this cell */
+    localIntersect(position,direction,surface,sense,distance);
+}
+
+void Cell::intersect(const Coordinate& position, const Direction& direction, Surface*& surface, bool& sense, double& distance,
+		             GeometryState& state) const {
+
+    /* Surfaces of the ancestors cells (from the cache if possible) */
+    const Cell* parent_cell = parent->getParent();
+    if(parent_cell){
+    	parent_cell->levelIntersect(position,direction,surface,sense,distance,state);
+    } else {
+        surface = 0;
+        sense = false;
+        distance = std::numeric_limits<double>::infinity();
+    }
+
+    /* The innermost level is always evaluated */
+    localIntersect(position,direction,surface,sense,distance);
+}
+
+size_t Cell::levelIntersect(const Coordinate& position, const Direction& direction, Surface*& surface, bool& sense, double& distance,
+		                    GeometryState& state) const {
+
+	/* Upper levels first */
+    const Cell* parent_cell = parent->getParent();
+    size_t level = 0;
+    if(parent_cell){
+    	level = parent_cell->levelIntersect(position,direction,surface,sense,distance,state) + 1;
+    } else {
+        surface = 0;
+        sense = false;
+        distance = std::numeric_limits<double>::infinity();
+    }
+
+    /* Check the cache of this level (a negative distance means we should calculate it again) */
+    GeometryState::Level& cache = state.getLevel(level);
+    double level_distance = cache.remaining(this,position,direction);
+    if(level_distance < 0.0) {
+    	Surface* level_surface = 0;
+    	bool level_sense = false;
+    	level_distance = std::numeric_limits<double>::infinity();
+    	localIntersect(position,direction,level_surface,level_sense,level_distance);
+    	cache.set(this,position,direction,level_surface,level_sense,level_distance);
+    }
+
+    /* Update nearest surface */
+    if(cache.getSurface() && level_distance < distance) {
+    	distance = level_distance;
+    	surface = cache.getSurface();
+    	sense = cache.getSense();
+    }
+
+    return level;
+}
+
+void Cell::localIntersect(const Coordinate& position, const Direction& direction, Surface*& surface, bool& sense, double& distance) const {
+	/* Unions or complements */
+	if(!expression.empty()) {
+		expressionIntersect(position,direction,surface,sense,distance);
+		return;
+	}
+
+    /* Packed surfaces */
+    surface_pack.intersect(position,direction,surface,sense,distance);
+
+    /* Loop over the rest of the surfaces */
 	vector<SenseSurface>::const_iterator it;
-	for (it = surfaces.begin() ; it != surfaces.end(); ++it) {
+	for (it = unpacked_surfaces.begin() ; it != unpacked_surfaces.end(); ++it) {
 		/* Distance to the surface */
         double newDistance;
         /* Check the intersection with each surface */
@@ -137,6 +237,59 @@ void Cell::intersect(const Coordinate& position, const Direction& direction, Sur
 
 }
 
+void Cell::expressionIntersect(const Coordinate& position, const Direction& direction, Surface*& surface, bool& sense, double& distance) const {
+	/*
+	 * Not every surface crossing is a boundary of the region (i.e. surfaces between the operands of
+	 * an union), so we move along the line from one surface to the next one until the point is
+	 * outside the region.
+	 */
+	const vector<Surface*>& expression_surfaces = expression.getSurfaces();
+	Coordinate point = position;
+	double travelled = 0.0;
+	/* Last surface crossed and the sense of the point after crossing it */
+	const Surface* crossed = 0;
+	bool crossed_sense = false;
+	/* A line crosses each surface at most twice */
+	size_t max_steps = 2 * expression_surfaces.size() + 1;
+	for(size_t step = 0 ; step < max_steps ; ++step) {
+		/* Nearest surface from the current point */
+		Surface* near_surface = 0;
+		bool near_sense = false;
+		double near_distance = std::numeric_limits<double>::infinity();
+		vector<Surface*>::const_iterator it;
+		for(it = expression_surfaces.begin() ; it != expression_surfaces.end() ; ++it) {
+			bool current_sense = (*it == crossed) ? crossed_sense : (*it)->sense(point);
+			double new_distance;
+			if((*it)->intersect(point,direction,current_sense,new_distance) && new_distance < near_distance) {
+				near_distance = new_distance;
+				near_surface = *it;
+				near_sense = current_sense;
+			}
+		}
+
+		/* The region is not bounded on this direction or the boundary is beyond the nearest surface */
+		if(!near_surface || travelled + near_distance >= distance) return;
+
+		/* Cross the surface */
+		travelled += near_distance;
+		point = point + near_distance * direction;
+		crossed = near_surface;
+		crossed_sense = !near_sense;
+
+		/* Check if we left the region */
+		if(!expression.evaluate(point,crossed,crossed_sense)) {
+			distance = travelled;
+			surface = near_surface;
+			sense = near_sense;
+			return;
+		}
+	}
+
+	/* The line crossed more surfaces than it could, the boundary of the region is not well defined */
+	throw Geometry::GeometryError("Could not find the boundary of cell " + getUserId() +
+			                      " along the direction of flight");
+}
+
 static inline bool getSign(const SurfaceId& value) {
 	if(value.find("-") != string::npos) return false;
 	else return true;
@@ -160,12 +313,96 @@ static inline vector<string> getUniqueTokens(const char_separator<char>& sep, co
 }
 
 std::vector<SurfaceId> CellFactory::getSurfacesIds(const string& surface_expresion) {
-	return getUniqueTokens(char_separator<char>("():- "),surface_expresion);
+	return getUniqueTokens(char_separator<char>("():#- "),surface_expresion);
+}
+
+/* Recursive descent parser of surface expressions */
+class ExpressionParser {
+	const CellId& cellid;
+	std::map<SurfaceId,Surface*>& cell_surfaces;
+	vector<string> tokens;
+	size_t current;
+
+	bool end() const {return current == tokens.size();}
+
+	/* union := intersection (":" intersection)* */
+	CellExpression::Node parseUnion() {
+		CellExpression::Node node(CellExpression::Node::UNION);
+		node.childs.push_back(parseIntersection());
+		while(!end() && tokens[current] == ":") {
+			++current;
+			node.childs.push_back(parseIntersection());
+		}
+		if(node.childs.size() == 1) return node.childs[0];
+		return node;
+	}
+
+	/* intersection := factor factor* */
+	CellExpression::Node parseIntersection() {
+		CellExpression::Node node(CellExpression::Node::INTERSECTION);
+		node.childs.push_back(parseFactor());
+		while(!end() && tokens[current] != ":" && tokens[current] != ")")
+			node.childs.push_back(parseFactor());
+		if(node.childs.size() == 1) return node.childs[0];
+		return node;
+	}
+
+	/* factor := "#" "(" union ")" | "(" union ")" | surface */
+	CellExpression::Node parseFactor() {
+		if(end())
+			throw Cell::BadCellCreation(cellid,"Unexpected end of the surface expression");
+		string token = tokens[current++];
+		if(token == "#") {
+			if(end() || tokens[current] != "(")
+				throw Cell::BadCellCreation(cellid,"Complement should be applied to an expression between parenthesis");
+			CellExpression::Node node(CellExpression::Node::COMPLEMENT);
+			node.childs.push_back(parseFactor());
+			return node;
+		}
+		if(token == "(") {
+			CellExpression::Node node = parseUnion();
+			if(end() || tokens[current] != ")")
+				throw Cell::BadCellCreation(cellid,"Missing closing parenthesis on the surface expression");
+			++current;
+			return node;
+		}
+		if(token == ")" || token == ":")
+			throw Cell::BadCellCreation(cellid,"Unexpected " + token + " on the surface expression");
+		return CellExpression::Node(cell_surfaces[getAbsId(token)],getSign(token));
+	}
+
+public:
+	ExpressionParser(const CellId& cellid, const string& expression, std::map<SurfaceId,Surface*>& cell_surfaces) :
+		cellid(cellid), cell_surfaces(cell_surfaces), current(0) {
+		/* Keep the operators as tokens */
+		tokenizer<char_separator<char> > tok(expression, char_separator<char>(" ","():#"));
+		tokens.insert(tokens.begin(),tok.begin(),tok.end());
+	}
+
+	CellExpression::Node parse() {
+		CellExpression::Node node = parseUnion();
+		if(!end())
+			throw Cell::BadCellCreation(cellid,"Unexpected " + tokens[current] + " on the surface expression");
+		return node;
+	}
+};
+
+CellExpression::Node CellFactory::parseExpression(const CellId& cellid, const string& surface_expresion,
+		                                          std::map<SurfaceId,Surface*>& cell_surfaces) {
+	ExpressionParser parser(cellid,surface_expresion,cell_surfaces);
+	return parser.parse();
 }
 
 Cell* CellFactory::createCell(const CellObject* definition, std::map<SurfaceId,Surface*>& cell_surfaces) const {
 	/* Get surface expression */
 	string surface_expresion = definition->getSurfacesExpression();
+
+	/* Unions or complements, the expression is compiled */
+	if(surface_expresion.find_first_of(":#") != string::npos) {
+		CellExpression expression(parseExpression(definition->getUserCellId(),surface_expresion,cell_surfaces));
+		return new Cell(definition,expression.getHalfSpaces(),expression);
+	}
+
 	vector<string> tokens = getUniqueTokens(char_separator<char>("() "),surface_expresion);;
 
 	/* Now get the tokens and craft a container with surfaces and senses */
@@ -36,6 +36,9 @@
 #include "../Material/Material.hpp"
 #include "Transformation.hpp"
 #include "GeometryObject.hpp"
+#include "SurfacePack.hpp"
+#include "GeometryState.hpp"
+#include "CellExpression.hpp"
 
 namespace Helios {
 
@@ -100,6 +103,11 @@ namespace Helios {
 		/* Get the material that is filling this cell (NULL if any) */
 		const Material* getMaterial() const {return material;}
 
+		/* Set the position of the cell on the feature (ring of a pin, element of a lattice) */
+		void setFeatureIndex(int index) {feature_index = index;}
+		/* Position of the cell on the feature that created it, -1 if the cell isn't part of a feature */
+		int getFeatureIndex() const {return feature_index;}
+
 		/* Set the parent universe of this cell */
 		void setParent(Universe* parent_universe) {parent = parent_universe;}
 		/* Get the universe where this cell is */
@@ -119,20 +127,55 @@ namespace Helios {
 		 */
 		bool isInside(const Coordinate& position, const Surface* skip = 0) const;
 
+		/*
+		 * Same as above, but a point on a surface of the cell (the value of the surface equation is
+		 * smaller than the tolerance) is taken as inside. Cells with unions or complements are checked
+		 * without tolerance.
+		 */
+		bool isInside(const Coordinate& position, const Surface* skip, double tolerance) const;
+
 		/* Get the nearest surface to a point in a given direction */
 		void intersect(const Coordinate& position, const Direction& direction, Surface*& surface, bool& sense, double& distance) const;
 
+		/*
+		 * Get the nearest surface to a point in a given direction, the distances to the surfaces
+		 * of the ancestor cells are taken from the tracking state of the particle when possible.
+		 */
+		void intersect(const Coordinate& position, const Direction& direction, Surface*& surface, bool& sense, double& distance,
+				       GeometryState& state) const;
+
+
+		/* Gather statistics of the surfaces tests on the cell expression (if any) */
+		void setStatistics(bool gather) {expression.setStatistics(gather);}
+		/* Reorder the cell expression using the gathered statistics */
+		void optimize() {if(!expression.empty()) expression.optimize();}
+
 		virtual ~Cell() {/* */};
 
 	protected:
 
-		Cell(const CellObject* definition, const std::vector<SenseSurface>& surfaces);
+		Cell(const CellObject* definition, const std::vector<SenseSurface>& surfaces, const CellExpression& expression = CellExpression());
+
+		/* Get the nearest surface of this cell, only updated if it is closer than the given one */
+		void localIntersect(const Coordinate& position, const Direction& direction, Surface*& surface, bool& sense, double& distance) const;
+		/* Get the nearest surface where the particle leaves the region of the cell expression */
+		void expressionIntersect(const Coordinate& position, const Direction& direction, Surface*& surface, bool& sense, double& distance) const;
+		/* Nearest surface of this cell and its ancestors using the cache of the state, returns the level of the cell */
+		size_t levelIntersect(const Coordinate& position, const Direction& direction, Surface*& surface, bool& sense, double& distance,
+				              GeometryState& state) const;
+
 		/* Prevent copy */
 		Cell(const Cell& cell);
 		Cell& operator= (const Cell& other);
 
 		/* A vector of surfaces and senses that define this cell */
 		std::vector<SenseSurface> surfaces;
+		/* Surfaces of known types, evaluated without virtual calls */
+		SurfacePack surface_pack;
+		/* Surfaces that couldn't be packed */
+		std::vector<SenseSurface> unpacked_surfaces;
+		/* Region with unions or complements (empty if the cell is an intersection of its surfaces) */
+		CellExpression expression;
 		/* Other information about this cell */
 		CellInfo flag;
 		/* Reference to the universe that is filling this cell, NULL if any (material cell). */
@@ -146,6 +189,8 @@ namespace Helios {
 		Universe* parent;
 		/* Internal identification of this cell */
 		InternalCellId internal_id;
+		/* Position of the cell on the feature that created it */
+		int feature_index;
 		/* cCell id choose by the user */
 		CellId user_id;
 	};
@@ -189,6 +234,14 @@ namespace Helios {
 		 */
 		static std::vector<SurfaceId> getSurfacesIds(const std::string& surface_expresion);
 
+		/*
+		 * Parse a surface expression. The juxtaposition of operands is an intersection, ":" is an union,
+		 * "#(...)" is the complement of a expression and parenthesis are used to group operands. The
+		 * precedence is complement, intersection and union.
+		 */
+		static CellExpression::Node parseExpression(const CellId& cellid, const std::string& surface_expresion,
+				                                   std::map<SurfaceId,Surface*>& cell_surfaces);
+
 		/* Prevent construction or copy */
 		CellFactory() {/* */};
 		/* Create a new surface */
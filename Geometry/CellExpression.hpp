@@ -0,0 +1,302 @@
+/*
+ Copyright (c) 2012, Esteban Pellegrino
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright
+ notice, this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+ * Neither the name of the <organization> nor the
+ names of its contributors may be used to endorse or promote products
+ derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CELLEXPRESSION_HPP_
+#define CELLEXPRESSION_HPP_
+
+#include <vector>
+#include <algorithm>
+#include <ostream>
+
+#include "../Common/Common.hpp"
+#include "../Common/ThreadCounters.hpp"
+#include "Surface.hpp"
+
+namespace Helios {
+
+	/*
+	 * Region of a cell defined by a boolean expression of half-spaces (surfaces and senses) with
+	 * intersections, unions and complements.
+	 *
+	 * The expression tree is normalized (complements are pushed down to the half-spaces, so they
+	 * only flip senses) and compiled to a flat program of tests and conditional jumps that
+	 * evaluates the region with short-circuit. The operands of each intersection or union could
+	 * be reordered using statistics of the tests (i.e. gathered on a warm-up batch), so the
+	 * cheaper and more selective ones are evaluated first.
+	 */
+	class CellExpression {
+	public:
+
+		/* Node of the expression tree */
+		class Node {
+		public:
+			enum Type {
+				LEAF         = 0, /* Half-space of a surface */
+				INTERSECTION = 1,
+				UNION        = 2,
+				COMPLEMENT   = 3
+			};
+			Type type;
+			/* Surface and sense (only for leaves) */
+			Surface* surface;
+			bool sense;
+			/* Operands */
+			std::vector<Node> childs;
+			/* Index of the leaf on the statistics counters */
+			size_t leaf;
+
+			Node(Type type = INTERSECTION) : type(type), surface(0), sense(false), leaf(0) {/* */}
+			Node(Surface* surface, bool sense) : type(LEAF), surface(surface), sense(sense), leaf(0) {/* */}
+		};
+
+		/* Empty expression (the cell is a plain intersection of its surfaces) */
+		CellExpression() {/* */}
+
+		CellExpression(const Node& expression) : root(normalize(expression, false)) {
+			/* Enumerate leaves and surfaces */
+			size_t nleaves = 0;
+			setupLeaves(root, nleaves);
+			counts.resize(2 * nleaves, 0);
+			/* Without statistics, the smaller operands are evaluated first */
+			optimize();
+		}
+
+		/* True if there isn't any expression */
+		bool empty() const {return code.empty();}
+
+		/* Evaluate the region on a point, the half-spaces of the skipped surface are taken as satisfied */
+		bool evaluate(const Coordinate& position, const Surface* skip) const {
+			return run(position, skip, false, false);
+		}
+
+		/* Evaluate the region on a point, with a known sense for one surface */
+		bool evaluate(const Coordinate& position, const Surface* surface, bool surface_sense) const {
+			return run(position, surface, true, surface_sense);
+		}
+
+		/* Unique surfaces on the expression */
+		const std::vector<Surface*>& getSurfaces() const {return surfaces;}
+
+		/* Unique half-spaces on the expression (after normalization) */
+		const std::vector<std::pair<Surface*,bool> >& getHalfSpaces() const {return half_spaces;}
+
+		/* Gather statistics of the half-space tests (the counts of each thread are added when it stops) */
+		void setStatistics(bool gather) {
+			if(gather) statistics.start(counts.size());
+			else statistics.stop(counts);
+		}
+
+		/* Reorder the operands using the gathered statistics and compile again the expression */
+		void optimize() {
+			order(root);
+			code.clear();
+			compile(root);
+		}
+
+		void print(std::ostream& out) const {print(out, root);}
+
+		~CellExpression() {/* */}
+
+	private:
+
+		/* Operations of the compiled expression */
+		enum Operation {
+			TEST       = 0, /* Evaluate a half-space */
+			JUMP_FALSE = 1, /* Jump if the current value is false (short-circuit of an intersection) */
+			JUMP_TRUE  = 2  /* Jump if the current value is true (short-circuit of an union) */
+		};
+
+		struct Instruction {
+			Operation op;
+			Surface* surface;
+			bool sense;
+			/* Leaf index for tests, target of the jumps */
+			size_t value;
+			Instruction(Operation op, Surface* surface, bool sense, size_t value) :
+				op(op), surface(surface), sense(sense), value(value) {/* */}
+		};
+
+		/* Normalized expression tree */
+		Node root;
+		/* Compiled expression */
+		std::vector<Instruction> code;
+		/* Surfaces and half-spaces on the expression */
+		std::vector<Surface*> surfaces;
+		std::vector<std::pair<Surface*,bool> > half_spaces;
+		/* Statistics : number of times each leaf was evaluated (even index) and was true (odd index) */
+		std::vector<size_t> counts;
+		ThreadCounters statistics;
+
+		bool run(const Coordinate& position, const Surface* surface, bool known, bool surface_sense) const {
+			bool value = true;
+			size_t i = 0;
+			while(i < code.size()) {
+				const Instruction& ins = code[i];
+				switch(ins.op) {
+				case TEST :
+					if(ins.surface == surface)
+						value = !known || (ins.sense == surface_sense);
+					else
+						value = (ins.surface->sense(position) == ins.sense);
+					if(statistics.active()) {
+						std::vector<size_t>& local = statistics.local();
+						local[2 * ins.value]++;
+						if(value) local[2 * ins.value + 1]++;
+					}
+					++i;
+					break;
+				case JUMP_FALSE :
+					i = value ? i + 1 : ins.value;
+					break;
+				case JUMP_TRUE :
+					i = value ? ins.value : i + 1;
+					break;
+				}
+			}
+			return value;
+		}
+
+		/* Push complements down to the leaves and flatten nested operations of the same type */
+		static Node normalize(const Node& node, bool complement) {
+			if(node.type == Node::LEAF)
+				return Node(node.surface, node.sense != complement);
+			if(node.type == Node::COMPLEMENT)
+				return normalize(node.childs[0], !complement);
+			/* De Morgan */
+			Node::Type type = node.type;
+			if(complement)
+				type = (type == Node::INTERSECTION) ? Node::UNION : Node::INTERSECTION;
+			Node result(type);
+			for(std::vector<Node>::const_iterator it = node.childs.begin() ; it != node.childs.end() ; ++it) {
+				Node child = normalize(*it, complement);
+				if(child.type == type)
+					result.childs.insert(result.childs.end(), child.childs.begin(), child.childs.end());
+				else
+					result.childs.push_back(child);
+			}
+			if(result.childs.size() == 1) return result.childs[0];
+			return result;
+		}
+
+		void setupLeaves(Node& node, size_t& nleaves) {
+			if(node.type == Node::LEAF) {
+				node.leaf = nleaves++;
+				if(std::find(surfaces.begin(), surfaces.end(), node.surface) == surfaces.end())
+					surfaces.push_back(node.surface);
+				std::pair<Surface*,bool> half_space(node.surface, node.sense);
+				if(std::find(half_spaces.begin(), half_spaces.end(), half_space) == half_spaces.end())
+					half_spaces.push_back(half_space);
+				return;
+			}
+			for(std::vector<Node>::iterator it = node.childs.begin() ; it != node.childs.end() ; ++it)
+				setupLeaves(*it, nleaves);
+		}
+
+		/* Estimated cost and probability of a node, used to sort the operands */
+		struct Estimate {
+			double cost;
+			double probability;
+			Node node;
+			/* Order of the operands (cost over the probability of ending the evaluation) */
+			double rank;
+		};
+
+		struct CompareEstimate {
+			bool operator() (const Estimate& left, const Estimate& right) const {
+				return left.rank < right.rank;
+			}
+		};
+
+		/*
+		 * Sort the operands of each node (the operands are supposed independent). On an intersection the
+		 * evaluation ends with the first false operand, on an union with the first true one.
+		 */
+		Estimate order(Node& node) const {
+			Estimate estimate;
+			if(node.type == Node::LEAF) {
+				estimate.cost = 1.0;
+				estimate.probability = (counts[2 * node.leaf + 1] + 0.5) / (counts[2 * node.leaf] + 1.0);
+				return estimate;
+			}
+			bool intersection = (node.type == Node::INTERSECTION);
+			std::vector<Estimate> operands;
+			for(std::vector<Node>::iterator it = node.childs.begin() ; it != node.childs.end() ; ++it) {
+				Estimate operand = order(*it);
+				double end = intersection ? 1.0 - operand.probability : operand.probability;
+				operand.rank = operand.cost / end;
+				operand.node = *it;
+				operands.push_back(operand);
+			}
+			std::stable_sort(operands.begin(), operands.end(), CompareEstimate());
+			/* Expected cost of the sorted operands */
+			double reach = 1.0;
+			estimate.cost = 0.0;
+			for(size_t i = 0 ; i < operands.size() ; ++i) {
+				node.childs[i] = operands[i].node;
+				estimate.cost += reach * operands[i].cost;
+				double next = intersection ? operands[i].probability : 1.0 - operands[i].probability;
+				reach *= next;
+			}
+			estimate.probability = intersection ? reach : 1.0 - reach;
+			return estimate;
+		}
+
+		void compile(const Node& node) {
+			if(node.type == Node::LEAF) {
+				code.push_back(Instruction(TEST, node.surface, node.sense, node.leaf));
+				return;
+			}
+			Operation jump = (node.type == Node::INTERSECTION) ? JUMP_FALSE : JUMP_TRUE;
+			std::vector<size_t> jumps;
+			for(size_t i = 0 ; i < node.childs.size() ; ++i) {
+				compile(node.childs[i]);
+				if(i + 1 < node.childs.size()) {
+					jumps.push_back(code.size());
+					code.push_back(Instruction(jump, 0, false, 0));
+				}
+			}
+			/* All the jumps go to the end of the node */
+			for(std::vector<size_t>::const_iterator it = jumps.begin() ; it != jumps.end() ; ++it)
+				code[*it].value = code.size();
+		}
+
+		void print(std::ostream& out, const Node& node) const {
+			if(node.type == Node::LEAF) {
+				out << (node.sense ? "" : "-") << node.surface->getUserId();
+				return;
+			}
+			out << "(";
+			for(size_t i = 0 ; i < node.childs.size() ; ++i) {
+				if(i > 0) out << ((node.type == Node::INTERSECTION) ? " " : " : ");
+				print(out, node.childs[i]);
+			}
+			out << ")";
+		}
+	};
+
+} /* namespace Helios */
+#endif /* CELLEXPRESSION_HPP_ */
@@ -25,9 +25,14 @@
  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <cmath>
+#include <algorithm>
+
 #include "GeometricFeature.hpp"
 #include "Universe.hpp"
 #include "Surfaces/PlaneNormal.hpp"
+#include "Surfaces/Plane.hpp"
+#include "Surfaces/CylinderOnAxis.hpp"
 
 using namespace std;
 
@@ -39,6 +44,8 @@ GeometricFeature::GeometricFeature(const FeatureObject* definition) : feature(de
 GeometricFeature* FeatureFactory::createFeature(const FeatureObject* definition) const {
 	if(definition->getFeature() == "lattice")
 		return new Lattice(definition);
+	if(definition->getFeature() == "pin")
+		return new Pin(definition);
 	return 0;
 }
 
@@ -138,6 +145,104 @@ static string getLatticePosition(const size_t& x, const size_t& y) {
 	return "";
 }
 
+/* Coordinates on the plane of the lattice (inverse of getTranslation) */
+template<int axis>
+static void getLatticeCoordinates(const Coordinate& position, double& u, double& v) {
+	switch(axis) {
+	case xaxis :
+		u = position[yaxis]; v = position[zaxis];
+		break;
+	case yaxis :
+		u = position[zaxis]; v = position[xaxis];
+		break;
+	case zaxis :
+		u = position[xaxis]; v = position[yaxis];
+		break;
+	}
+}
+
+/* Sine of 60 degrees */
+static const double hex_sine = std::sqrt(3.0) / 2.0;
+
+/*
+ * Center of the element (i,j) of a hexagonal lattice, the elements are placed on the
+ * directions (1,0) and (1/2,sqrt(3)/2) and the lattice is centered on the origin.
+ */
+static void getHexCenter(int nu, int nv, double pitch, int i, int j, double& u, double& v) {
+	double di = i - (nu - 1) / 2.0;
+	double dj = j - (nv - 1) / 2.0;
+	u = (di + dj / 2.0) * pitch;
+	v = dj * hex_sine * pitch;
+}
+
+/* Lookup of a rectangular lattice */
+template<int axis>
+class RectangularLookup : public FeatureLookup {
+	/* Lower corner, pitch and number of elements on each direction */
+	double u_min, v_min;
+	double u_delta, v_delta;
+	int nu, nv;
+public:
+	RectangularLookup(const vector<int>& dimension, const vector<double>& pitch, const Direction& translation) :
+		u_delta(pitch[0]), v_delta(pitch[1]), nu(dimension[0]), nv(dimension[1]) {
+		getLatticeCoordinates<axis>(translation, u_min, v_min);
+		u_min -= u_delta * nu / 2.0;
+		v_min -= v_delta * nv / 2.0;
+	}
+	int getIndex(const Coordinate& position) const {
+		double u, v;
+		getLatticeCoordinates<axis>(position, u, v);
+		int column = (int)std::floor((u - u_min) / u_delta);
+		int row = (int)std::floor((v - v_min) / v_delta);
+		if(column < 0 || column >= nu || row < 0 || row >= nv) return -1;
+		/* Rows are created from top to bottom */
+		return (nv - 1 - row) * nu + column;
+	}
+	~RectangularLookup() {/* */}
+};
+
+/* Lookup of a hexagonal lattice (rounding of the axial coordinates to the nearest hexagon) */
+template<int axis>
+class HexagonalLookup : public FeatureLookup {
+	/* Center of the element (0,0), pitch and number of elements on each direction */
+	double u0, v0;
+	double pitch;
+	int nu, nv;
+public:
+	HexagonalLookup(const vector<int>& dimension, const vector<double>& pitch, const Direction& translation) :
+		pitch(pitch[0]), nu(dimension[0]), nv(dimension[1]) {
+		double tu, tv;
+		getLatticeCoordinates<axis>(translation, tu, tv);
+		getHexCenter(nu, nv, this->pitch, 0, 0, u0, v0);
+		u0 += tu;
+		v0 += tv;
+	}
+	int getIndex(const Coordinate& position) const {
+		double u, v;
+		getLatticeCoordinates<axis>(position, u, v);
+		/* Axial coordinates */
+		double x = (v - v0) / (hex_sine * pitch);
+		double z = (u - u0) / pitch - x / 2.0;
+		double y = -x - z;
+		/* Round to the nearest hexagon, fixing the coordinate with the largest error */
+		double rx = std::floor(x + 0.5);
+		double ry = std::floor(y + 0.5);
+		double rz = std::floor(z + 0.5);
+		double dx = std::abs(rx - x);
+		double dy = std::abs(ry - y);
+		double dz = std::abs(rz - z);
+		if(dx > dy && dx > dz) rx = -ry - rz;
+		else if(dy > dz) ry = -rx - rz;
+		else rz = -rx - ry;
+		int i = (int)rz;
+		int j = (int)rx;
+		if(i < 0 || i >= nu || j < 0 || j >= nv) return -1;
+		/* Rows are created from top to bottom */
+		return (nv - 1 - j) * nu + i;
+	}
+	~HexagonalLookup() {/* */}
+};
+
 /* ---- Lattice Factory stuff */
 
 template<int axis>
@@ -217,11 +322,90 @@ static void gen2DLattice(const LatticeObject& new_lat,std::vector<SurfaceObject*
 	}
 }
 
+/* Plane between the element (i,j) of a hexagonal lattice and its neighbor on the direction k */
+static string getHexPlane(const UniverseId& latt_id, int k, int i, int j) {
+	/* Indexes are shifted to avoid negative values on the IDs */
+	return toString(latt_id) + "[h" + toString(k) + "," + toString(i + 1) + "," + toString(j + 1) + "]";
+}
+
+template<int axis>
+/* Generation of a 2D hexagonal lattice in plane perpendicular to axis */
+static void genHexLattice(const LatticeObject& new_lat,std::vector<SurfaceObject*>& sur_def,
+		                  std::vector<CellObject*>& cell_def) {
+
+	/* Get dimension and pitch */
+	vector<int> dimension = new_lat.getDimension();
+	vector<double> pitch = new_lat.getWidth();
+	/* Get universes to fill each cell */
+	vector<UniverseId> universes = new_lat.getUniverses();
+	/* Get lattice id */
+	UniverseId latt_id = new_lat.getUserFeatureId();
+
+	if(dimension.size() != 2)
+		throw Universe::BadUniverseCreation(latt_id,"Hexagonal lattices should have two dimensions");
+	if(!compareFloating(pitch[0],pitch[1]))
+		throw Universe::BadUniverseCreation(latt_id,"Hexagonal lattices should have the same pitch on both directions");
+
+	/* Normals of the facets (on the lattice plane) and the offset to the neighbor element on each one */
+	const double normal_u[3] = {1.0, 0.5, -0.5};
+	const double normal_v[3] = {0.0, hex_sine, hex_sine};
+	const int offset_i[3] = {1, 0, -1};
+	const int offset_j[3] = {0, 1, 1};
+
+	/* Each plane is shared by two neighbor elements */
+	map<string,SurfaceObject*> planes;
+
+	size_t uni_count = 0;
+	/* Now create each cell of the lattice (left to right, top to bottom) */
+	for(int j = dimension[1] - 1 ; j >= 0  ; j--) {
+		for(int i = 0 ; i < dimension[0]  ; i++) {
+			/* Center of the element */
+			double u, v;
+			getHexCenter(dimension[0], dimension[1], pitch[0], i, j, u, v);
+
+			std::string surfs = "";
+			for(int k = 0 ; k < 3 ; ++k) {
+				/* Planes on the positive and negative side of the direction k */
+				int side_i[2] = {i, i - offset_i[k]};
+				int side_j[2] = {j, j - offset_j[k]};
+				for(int side = 0 ; side < 2 ; ++side) {
+					string plane_id = getHexPlane(latt_id, k, side_i[side], side_j[side]);
+					if(planes.find(plane_id) == planes.end()) {
+						double sign = side ? -1.0 : 1.0;
+						double position = normal_u[k] * u + normal_v[k] * v + sign * pitch[0] / 2.0;
+						Direction normal = getTranslation<axis>(normal_u[k], normal_v[k]);
+						vector<double> coeff;
+						coeff.push_back(normal[xaxis]);
+						coeff.push_back(normal[yaxis]);
+						coeff.push_back(normal[zaxis]);
+						coeff.push_back(position);
+						SurfaceObject* new_surface = new SurfaceObject(plane_id,Plane().getName(),coeff);
+						planes[plane_id] = new_surface;
+						sur_def.push_back(new_surface);
+					}
+					surfs += (side ? "" : "-") + plane_id + " ";
+				}
+			}
+
+			/* Translate the cell to the lattice point */
+			Transformation transf(getTranslation<axis>(u,v));
+			CellId lattice_id = toString(latt_id)+getLatticePosition<axis>(i,j);
+			cell_def.push_back(new CellObject(lattice_id,surfs,Cell::NONE,latt_id,universes[uni_count],Material::NONE,transf));
+
+			/* Get next universe */
+			uni_count++;
+		}
+	}
+}
+
 static map<string,Lattice::Constructor> initLatticeConstructorTable() {
 	map<string,Lattice::Constructor> m;
 	m["x-y"] = gen2DLattice<zaxis>;
 	m["y-z"] = gen2DLattice<xaxis>;
 	m["x-z"] = gen2DLattice<yaxis>;
+	m["hex-x-y"] = genHexLattice<zaxis>;
+	m["hex-y-z"] = genHexLattice<xaxis>;
+	m["hex-x-z"] = genHexLattice<yaxis>;
 	return m;
 }
 
@@ -234,7 +418,8 @@ Lattice::Lattice(const FeatureObject* definition) : GeometricFeature(definition)
 	/* We know the definition is a LatticeObject */
 	const LatticeObject* new_lat = dynamic_cast<const LatticeObject*>(definition);
 
-	/* Get dimension and pitch */
+	/* Get type, dimension and pitch */
+	type = new_lat->getType();
 	dimension = new_lat->getDimension();
 	pitch = new_lat->getWidth();
 	/* Get universes to fill each cell */
@@ -259,6 +444,17 @@ Lattice::Lattice(const FeatureObject* definition) : GeometricFeature(definition)
 		"Invalid number of universes in lattice (expected = " + toString(uni_count) + " ; input = " + toString(universes.size()) + ")");
 }
 
+FeatureLookup* Lattice::createLookup(const Direction& translation) const {
+	if(dimension.size() != 2) return 0;
+	if(type == "x-y") return new RectangularLookup<zaxis>(dimension,pitch,translation);
+	if(type == "y-z") return new RectangularLookup<xaxis>(dimension,pitch,translation);
+	if(type == "x-z") return new RectangularLookup<yaxis>(dimension,pitch,translation);
+	if(type == "hex-x-y") return new HexagonalLookup<zaxis>(dimension,pitch,translation);
+	if(type == "hex-y-z") return new HexagonalLookup<xaxis>(dimension,pitch,translation);
+	if(type == "hex-x-z") return new HexagonalLookup<yaxis>(dimension,pitch,translation);
+	return 0;
+}
+
 void Lattice::createFeature(const FeatureObject* featureObject,
                               std::vector<SurfaceObject*>& surfaceObject,
 		                      std::vector<CellObject*>& cellObject) const {
@@ -282,4 +478,127 @@ void Lattice::createFeature(const FeatureObject* featureObject,
 	(*it_const).second(*new_lat,surfaceObject,cellObject);
 }
 
+/* ---- Pin stuff */
+
+/* Axis of the pin given the plane where the rings are */
+static int getPinAxis(const string& type) {
+	if(type == "x-y") return zaxis;
+	if(type == "y-z") return xaxis;
+	if(type == "x-z") return yaxis;
+	return -1;
+}
+
+/* Lookup of the ring of a pin (binary search on the squared radius) */
+template<int axis>
+class PinLookup : public FeatureLookup {
+	/* Center of the pin */
+	Direction center;
+	/* Squared radius of each cylinder, sorted from the inner to the outer one */
+	vector<double> radius2;
+public:
+	PinLookup(const Direction& center, const vector<double>& radius) : center(center), radius2(radius.size()) {
+		for(size_t i = 0 ; i < radius.size() ; ++i)
+			radius2[i] = radius[i] * radius[i];
+	}
+	int getIndex(const Coordinate& position) const {
+		double u, v;
+		getLatticeCoordinates<axis>(position - center, u, v);
+		/* A point on a cylinder is outside of it (the sense of a surface is positive at zero) */
+		return upper_bound(radius2.begin(), radius2.end(), u * u + v * v) - radius2.begin();
+	}
+	~PinLookup() {/* */}
+};
+
+template<int axis>
+/* Generation of the rings of a pin along an axis */
+static void genPin(const UniverseId& pin_id, const Direction& center, const vector<double>& radius,
+		           const vector<MaterialId>& materials, vector<SurfaceObject*>& sur_def, vector<CellObject*>& cell_def) {
+
+	/* Coefficients of the cylinders are the radius and the coordinates of the center */
+	vector<double> coeff(1, 0.0);
+	for(int i = 0 ; i < 3 ; i++)
+		if(i != axis) coeff.push_back(center[i]);
+
+	/* Create the cylinders from the inner to the outer one */
+	vector<SurfaceId> cylinders;
+	for(size_t k = 0 ; k < radius.size() ; k++) {
+		coeff[0] = radius[k];
+		SurfaceId pin_surface = toString(pin_id) + "[r" + toString(k) + "]";
+		sur_def.push_back(new SurfaceObject(pin_surface,CylinderOnAxis<axis>().getName(),coeff));
+		cylinders.push_back(pin_surface);
+	}
+
+	/* Create each ring, the position of the cell on the universe is the index of the ring */
+	for(size_t k = 0 ; k <= radius.size() ; k++) {
+		std::string surfs = "";
+		if(k > 0) surfs += cylinders[k - 1] + " ";
+		if(k < radius.size()) surfs += "-" + cylinders[k];
+		CellId pin_cell = toString(pin_id) + "[" + toString(k) + "]";
+		cell_def.push_back(new CellObject(pin_cell,surfs,Cell::NONE,pin_id,Universe::BASE,materials[k],Transformation()));
+	}
+}
+
+/* Constructor with current surfaces and cells on the geometry */
+Pin::Pin(const FeatureObject* definition) : GeometricFeature(definition) {
+
+	/* We know the definition is a PinObject */
+	const PinObject* new_pin = dynamic_cast<const PinObject*>(definition);
+
+	type = new_pin->getType();
+	center = new_pin->getCenter();
+	radius = new_pin->getRadius();
+	materials = new_pin->getMaterials();
+	UniverseId pin_id = new_pin->getUserFeatureId();
+
+	/* Check the input */
+	if(getPinAxis(type) < 0) throw Universe::BadUniverseCreation(pin_id,"Pin type " + type + " doesn't exist");
+	if(center.size() != 2) throw Universe::BadUniverseCreation(pin_id,"The center of the pin should have 2 values");
+	if(radius.size() == 0) throw Universe::BadUniverseCreation(pin_id,"You need to put at least one radius on the pin");
+	for(size_t k = 0 ; k < radius.size() ; k++) {
+		if(radius[k] <= 0.0 || (k > 0 && radius[k] <= radius[k - 1]))
+			throw Universe::BadUniverseCreation(pin_id,"Radii of the pin should be positive and strictly increasing");
+	}
+	if(materials.size() != radius.size() + 1)
+		throw Universe::BadUniverseCreation(pin_id,
+		"Invalid number of materials in pin (expected = " + toString(radius.size() + 1) + " ; input = " + toString(materials.size()) + ")");
+}
+
+FeatureLookup* Pin::createLookup(const Direction& translation) const {
+	switch(getPinAxis(type)) {
+	case xaxis :
+		return new PinLookup<xaxis>(translation + getTranslation<xaxis>(center[0],center[1]),radius);
+	case yaxis :
+		return new PinLookup<yaxis>(translation + getTranslation<yaxis>(center[0],center[1]),radius);
+	case zaxis :
+		return new PinLookup<zaxis>(translation + getTranslation<zaxis>(center[0],center[1]),radius);
+	}
+	return 0;
+}
+
+void Pin::createFeature(const FeatureObject* featureObject,
+                        std::vector<SurfaceObject*>& surfaceObject,
+		                std::vector<CellObject*>& cellObject) const {
+
+	UniverseId pin_id = featureObject->getUserFeatureId();
+
+	/* The pin is a universe itself, so it can't be defined with an id of an existent universe */
+	for(vector<CellObject*>::const_iterator it_cell = cellObject.begin() ; it_cell != cellObject.end() ; ++it_cell) {
+		if(pin_id == (*it_cell)->getUniverse())
+			throw Universe::BadUniverseCreation(pin_id,"Duplicated id. You can't use the id of a existent universe to define a pin");
+	}
+
+	/* Create the pin */
+	switch(getPinAxis(type)) {
+	case xaxis :
+		genPin<xaxis>(pin_id,getTranslation<xaxis>(center[0],center[1]),radius,materials,surfaceObject,cellObject);
+		break;
+	case yaxis :
+		genPin<yaxis>(pin_id,getTranslation<yaxis>(center[0],center[1]),radius,materials,surfaceObject,cellObject);
+		break;
+	case zaxis :
+		genPin<zaxis>(pin_id,getTranslation<zaxis>(center[0],center[1]),radius,materials,surfaceObject,cellObject);
+		break;
+	}
+}
+
 } /* namespace Helios */
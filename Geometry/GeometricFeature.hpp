@@ -42,6 +42,17 @@ namespace Helios {
 	class FeatureObject;
 	class LatticeObject;
 
+	/*
+	 * Arithmetic lookup of the cell of a feature that contains a point. The index is the position
+	 * of the cell on the universe of the feature (-1 if the point is outside the feature).
+	 */
+	class FeatureLookup {
+	public:
+		FeatureLookup() {/* */}
+		virtual int getIndex(const Coordinate& position) const = 0;
+		virtual ~FeatureLookup() {/* */}
+	};
+
 	/*
 	 * A geometric feature is a collection of geometry entities that conform a complex
 	 * object. For example, a pin, pin ring or a lattice.
@@ -67,9 +78,16 @@ namespace Helios {
 								   std::vector<SurfaceObject*>& surfaceObject,
 								   std::vector<CellObject*>& cellObject) const = 0;
 
+		/*
+		 * Create the lookup of the cells of the feature translated to some point (NULL if
+		 * the cells can't be found without checking each one)
+		 */
+		virtual FeatureLookup* createLookup(const Direction& translation) const {return 0;}
+
 		virtual ~GeometricFeature() {/* */};
 	};
 
+
 	/* Lattice factory class */
 	class Lattice : public GeometricFeature {
 
@@ -86,6 +104,9 @@ namespace Helios {
 						   std::vector<SurfaceObject*>& surfaceObject,
 						   std::vector<CellObject*>& cellObject) const;
 
+		/* Create the lookup of the elements of a lattice translated to some point */
+		FeatureLookup* createLookup(const Direction& translation) const;
+
 		virtual ~Lattice() {/* */}
 
 	private:
@@ -100,6 +121,32 @@ namespace Helios {
 
 	};
 
+	/* Pin of concentric cylinders, each ring is a cell of the pin universe */
+	class Pin : public GeometricFeature {
+
+	public:
+
+		/* Constructor with current surfaces and cells on the geometry */
+		Pin(const FeatureObject* definition);
+
+		void createFeature(const FeatureObject* featureObject,
+						   std::vector<SurfaceObject*>& surfaceObject,
+						   std::vector<CellObject*>& cellObject) const;
+
+		/* Create the lookup of the rings of a pin translated to some point */
+		FeatureLookup* createLookup(const Direction& translation) const;
+
+		virtual ~Pin() {/* */}
+
+	private:
+
+		std::string type;
+		std::vector<double> center;
+		std::vector<double> radius;
+		std::vector<MaterialId> materials;
+
+	};
+
 	class FeatureObject : public GeometryObject {
 
 	protected:
@@ -150,6 +197,37 @@ namespace Helios {
 		~LatticeObject() {/* */}
 	};
 
+	class PinObject : public FeatureObject {
+		std::string type;
+		std::vector<double> center;
+		std::vector<double> radius;
+		std::vector<MaterialId> materials;
+	public:
+
+		PinObject(const UniverseId& userPinId, const std::string& type, const std::vector<double>& center,
+				  const std::vector<double>& radius, const std::vector<MaterialId>& materials) :
+				  FeatureObject("pin",userPinId), type(type), center(center),
+				  radius(radius), materials(materials) {/* */}
+
+		std::string getType() const {
+			return type;
+		}
+
+		std::vector<double> getCenter() const {
+			return center;
+		}
+
+		std::vector<double> getRadius() const {
+			return radius;
+		}
+
+		std::vector<MaterialId> getMaterials() const {
+			return materials;
+		}
+
+		~PinObject() {/* */}
+	};
+
 	class FeatureFactory {
 
 	public:
@@ -26,7 +26,9 @@
  */
 
 #include <cstdlib>
+#include <cmath>
 #include <set>
+#include <algorithm>
 
 #include "Surface.hpp"
 #include "Cell.hpp"
@@ -89,7 +91,8 @@ Geometry::Geometry(const std::vector<McObject*>& definitions, const McEnvironmen
 			/* Create a lattice factory */
 			GeometricFeature* feature = feature_factory.createFeature(*it);
 			feature->createFeature((*it),surFeatureObject,cellFeatureObject);
-			delete feature;
+			/* Keep the feature until the universes are created */
+			feature_map.insert(make_pair((*it)->getUserFeatureId(),feature));
 		}
 	}
 
@@ -166,6 +169,39 @@ Geometry::Geometry(const std::vector<McObject*>& definitions, const McEnvironmen
 	/* Finally we should purge the extra definitions added by the geometry feature */
 	purgePointers(cellFeatureObject);
 	purgePointers(surFeatureObject);
+	surface_hash.clear();
+	map<UniverseId,GeometricFeature*>::iterator it_feature = feature_map.begin();
+	for(; it_feature != feature_map.end() ; ++it_feature)
+		delete (*it_feature).second;
+	feature_map.clear();
+}
+
+/*
+ * Key of the coefficients of a surface. The coefficients are probed by evaluating the surface at some fixed
+ * points and the (weighted) sum of the values is rounded. Equal surfaces (up to some tolerance) get the same
+ * key, or consecutive ones if the values are just on the edge of a bucket.
+ */
+static double surfaceKey(const Surface* surface) {
+	static const double probes[4][3] = {{0.1,0.2,0.3},{1.7,-0.9,0.4},{-0.6,1.3,-1.1},{0.8,0.5,1.9}};
+	/* Tolerance of the buckets */
+	static const double tolerance = 1e-6;
+	double value = 0.0;
+	for(size_t i = 0 ; i < 4 ; ++i)
+		value += (i + 1) * surface->function(Coordinate(probes[i][0],probes[i][1],probes[i][2]));
+	return floor(value / tolerance + 0.5);
+}
+
+/* Hash of the type and the key of a surface (FNV-1a) */
+static size_t surfaceHash(const string& type, double key) {
+	size_t hash = 2166136261u;
+	for(size_t i = 0 ; i < type.size() ; ++i)
+		hash = (hash ^ (unsigned char)type[i]) * 16777619u;
+	/* Avoid the sign of the zero */
+	if(key == 0.0) key = 0.0;
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&key);
+	for(size_t j = 0 ; j < sizeof(double) ; ++j)
+		hash = (hash ^ bytes[j]) * 16777619u;
+	return hash;
 }
 
 Surface* Geometry::addSurface(const Surface* surface, const ParentCell& parent_cell, const std::string& surf_id) {
@@ -181,15 +217,40 @@ Surface* Geometry::addSurface(const Surface* surface, const ParentCell& parent_c
 		}
 	}
 
-	/* Set internal / unique index */
-	new_surface->setInternalId(surfaces.size());
 	/* Update surface map */
     SurfaceId new_surf_id;
     if(parent_cell.getId().size() == 0) new_surf_id = surf_id;
     else new_surf_id = surf_id + "<" + parent_cell.getId();
 
+	/* Check if the same surface was already created on other place of the geometry (on the bucket or the neighbor ones) */
+	string type = new_surface->getName();
+	double key = surfaceKey(new_surface);
+	for(double offset = -1.0 ; offset <= 1.0 ; offset += 1.0) {
+		map<size_t, vector<Surface*> >::const_iterator it_bucket = surface_hash.find(surfaceHash(type, key + offset));
+		if(it_bucket == surface_hash.end()) continue;
+		const vector<Surface*>& bucket = it_bucket->second;
+		for(it_sur = bucket.begin() ; it_sur != bucket.end() ; ++it_sur) {
+			if(new_surface->getFlags() == (*it_sur)->getFlags() && *new_surface == *(*it_sur)) {
+				delete new_surface;
+				/* The neighbors of the surface are now on different branches of the geometry */
+				(*it_sur)->setShared(true);
+				/* Both paths point to the same surface */
+				InternalSurfaceId internal_id = (*it_sur)->getInternalId();
+				vector<InternalSurfaceId>& internal_ids = surface_internal_map[surf_id];
+				if(find(internal_ids.begin(), internal_ids.end(), internal_id) == internal_ids.end())
+					internal_ids.push_back(internal_id);
+				surface_reverse_map[new_surf_id] = internal_id;
+				return (*it_sur);
+			}
+		}
+	}
+	surface_hash[surfaceHash(type, key)].push_back(new_surface);
+
+	/* Set internal / unique index */
+	new_surface->setInternalId(surfaces.size());
+
     /* Update path map */
-    surface_path_map[new_surface->getInternalId()] = new_surf_id;
+    surface_path_map.push_back(new_surf_id);
     /* Update internal map */
     surface_internal_map[surf_id].push_back(new_surface->getInternalId());
     /* Update reverse map */
@@ -220,9 +281,16 @@ Universe* Geometry::addUniverse(const UniverseId& uni_def, const map<UniverseId,
 	/* Get the cell of this level */
 	vector<CellObject*> cell_def = (*it_uni_cells).second;
 
-	/* Add each cell of this universe */
+	/*
+	 * Add each cell of this universe. All the cells (and surfaces) of the universe are created before going
+	 * down into the universes that fill them, so the objects of one level are allocated next to each other
+	 * and get consecutive internal IDs.
+	 */
 	vector<CellObject*>::iterator it_cell = cell_def.begin();
     map<SurfaceId,Surface*> temp_sur_map;
+    /* Paths and bounding surfaces of the new cells, needed to create the universes that fill them */
+    vector<CellId> cell_paths;
+    vector<vector<Surface*> > cell_surfaces;
 
 	for(; it_cell != cell_def.end() ; ++it_cell) {
 
@@ -269,7 +337,7 @@ Universe* Geometry::addUniverse(const UniverseId& uni_def, const map<UniverseId,
 	    new_cell->setInternalId(cells.size());
 
 	    /* Update cell map */
-	    cell_path_map[new_cell->getInternalId()] = cell_id;
+	    cell_path_map.push_back(cell_id);
 	    /* Update internal map */
 	    cell_internal_map[(*it_cell)->getUserCellId()].push_back(new_cell->getInternalId());
 	    /* Update reverse map */
@@ -282,6 +350,18 @@ Universe* Geometry::addUniverse(const UniverseId& uni_def, const map<UniverseId,
 	    /* Link this cell with the new universe */
 	    new_universe->addCell(new_cell);
 
+	    /* Keep the information of the cell for the next level */
+	    cell_paths.push_back(cell_id);
+	    cell_surfaces.push_back(bounding_surfaces);
+	}
+
+	/* Now create the universes that fill the cells */
+	for(size_t ncell = 0 ; ncell < cell_def.size() ; ++ncell) {
+		it_cell = cell_def.begin() + ncell;
+		Cell* new_cell = new_universe->getCells()[ncell];
+		const CellId& cell_id = cell_paths[ncell];
+		vector<Surface*>& bounding_surfaces = cell_surfaces[ncell];
+
 	    /* Check if this cell is filled by another universe */
 	    UniverseId fill_universe_id = (*it_cell)->getFill();
 	    if(fill_universe_id != Universe::BASE) {
@@ -310,6 +390,11 @@ Universe* Geometry::addUniverse(const UniverseId& uni_def, const map<UniverseId,
 	    }
 	}
 
+	/* Cells of lattices and pins can be found without checking each one */
+	map<UniverseId,GeometricFeature*>::const_iterator it_feature = feature_map.find(uni_def);
+	if(it_feature != feature_map.end())
+		new_universe->setLookup((*it_feature).second->createLookup(parent_cell.getTransformation().getTranslation()));
+
 	/* Return the universe */
 	return new_universe;
 }
@@ -363,6 +448,28 @@ void Geometry::print(std::ostream& out) const {
 		out << *(*it_uni);
 }
 
+void Geometry::setStatistics(bool gather) {
+	vector<Cell*>::iterator it_cell = cells.begin();
+	for(; it_cell != cells.end() ; it_cell++)
+		(*it_cell)->setStatistics(gather);
+	vector<Surface*>::iterator it_sur = surfaces.begin();
+	for(; it_sur != surfaces.end() ; it_sur++)
+		(*it_sur)->setStatistics(gather);
+}
+
+void Geometry::optimize() {
+	vector<Cell*>::iterator it_cell = cells.begin();
+	for(; it_cell != cells.end() ; it_cell++) {
+		(*it_cell)->setStatistics(false);
+		(*it_cell)->optimize();
+	}
+	vector<Surface*>::iterator it_sur = surfaces.begin();
+	for(; it_sur != surfaces.end() ; it_sur++) {
+		(*it_sur)->setStatistics(false);
+		(*it_sur)->optimize();
+	}
+}
+
 Geometry::~Geometry() {
 	purgePointers(surfaces);
 	purgePointers(cells);
@@ -70,7 +70,7 @@ namespace Helios {
 
 		/* Get full path of an object */
 		template<class Object>
-		UserId getPath(const Object* object) const;
+		const UserId& getPath(const Object* object) const;
 		/* Get references to objects from a path expression or id */
 		template<class Object>
 		std::vector<Object*> getObject(const UserId& id) const;
@@ -85,6 +85,17 @@ namespace Helios {
 		/* Print cell with each surface of the geometry */
 		void print(std::ostream& out) const;
 
+		/*
+		 * Gather statistics of the surface tests on the cell expressions and of the neighbor cells
+		 * found when crossing surfaces (i.e. during a warm-up batch)
+		 */
+		void setStatistics(bool gather);
+		/*
+		 * Reorder the cell expressions and the neighbor cells of the surfaces using the gathered
+		 * statistics. The statistics are not gathered anymore, so the order is frozen.
+		 */
+		void optimize();
+
 	    /* Find a cell given an arbitrary point in the problem (starting from the base universe) */
 		const Cell* findCell(const Coordinate& position) const {
 			/* Start with the base universe */
@@ -121,20 +132,20 @@ namespace Helios {
 
 		/* Template to hold maps from different object */
 		class ObjectMap {
-			/* This map an internal ID with the full path of a object */
-			const std::map<InternalId,UserId>* path_map;
+			/* Full path of each object, indexed by the internal ID */
+			const std::vector<UserId>* path_map;
 			/* This map the full path of a object with the internal ID */
 			const std::map<UserId, InternalId>* reverse_map;
 			/* This map the original object ID with all the internal objects IDs */
 			const std::map<UserId, std::vector<InternalId> >* internal_map;
 		public:
 			ObjectMap() {/**/}
-			ObjectMap(const std::map<InternalId,UserId>* path_map, const std::map<UserId, InternalId>* reverse_map,
+			ObjectMap(const std::vector<UserId>* path_map, const std::map<UserId, InternalId>* reverse_map,
 					  const std::map<UserId, std::vector<InternalId> >* internal_map) :
 					  path_map(path_map), reverse_map(reverse_map), internal_map(internal_map) {/* */}
 			~ObjectMap() {/* */}
 			const std::map<UserId, std::vector<InternalId> >& getInternalMap() const {return *internal_map;}
-			const std::map<InternalId, UserId>& getPathMap() const {return *path_map;}
+			const std::vector<UserId>& getPathMap() const {return *path_map;}
 			const std::map<UserId, InternalId>& getReverseMap() const {return *reverse_map;}
 		};
 
@@ -150,17 +161,19 @@ namespace Helios {
 
 		/* ----- Map surfaces */
 
-		/* This map an internal ID with the full path of a surface */
-		std::map<InternalSurfaceId,SurfaceId> surface_path_map;
+		/* Full path of each surface, indexed by the internal ID */
+		std::vector<SurfaceId> surface_path_map;
 		/* This map the full path of a surface with the internal ID */
 		std::map<SurfaceId, InternalSurfaceId> surface_reverse_map;
 		/* This map the original surface ID with all the internal surfaces IDs */
 		std::map<SurfaceId, std::vector<InternalSurfaceId> > surface_internal_map;
+		/* Surfaces created on the geometry, hashed by type and coefficients (only used during the construction) */
+		std::map<size_t, std::vector<Surface*> > surface_hash;
 
 		/* ----- Map cells */
 
-		/* This map an internal ID with the full path of a cell */
-		std::map<InternalCellId,CellId> cell_path_map;
+		/* Full path of each cell, indexed by the internal ID */
+		std::vector<CellId> cell_path_map;
 		/* This map the full path of a surface with the internal ID */
 		std::map<CellId, InternalCellId> cell_reverse_map;
 		/* This map the original cell ID with all the internal cells IDs */
@@ -173,6 +186,8 @@ namespace Helios {
 
 		/* Map of cell to materials IDs */
 		std::map<InternalCellId, MaterialId> material_map;
+		/* Features of the geometry (to set the lookup of the cells on the feature universes) */
+		std::map<UniverseId, GeometricFeature*> feature_map;
 
 		/* Get container of objects given the INTERNAL cells id */
 		template<class Object>
@@ -222,29 +237,25 @@ namespace Helios {
 	std::vector<Surface*> Geometry::getContainer<Surface>(const std::vector<InternalId>& internal_ids) const;
 
 	template<class Object>
-	UserId Geometry::getPath(const Object* object) const {
-		/* Get the internal ID */
-		InternalId internal = object->getInternalId();
-		std::map<InternalId,UserId> path_map = object_maps.find(Object::name())->second.getPathMap();
-		std::map<InternalId,UserId>::const_iterator it = path_map.find(internal);
-		/* This is the full path of this cell */
-		return (*it).second;
+	const UserId& Geometry::getPath(const Object* object) const {
+		/* The full path of this object is on the position of the internal ID */
+		return object_maps.find(Object::name())->second.getPathMap()[object->getInternalId()];
 	}
 
 	template<class Object>
 	std::vector<Object*> Geometry::getObject(const UserId& orig_id) const {
 		std::string id(orig_id);
 		id.erase(std::remove_if(id.begin(), id.end(),::isspace), id.end());
-		/* Get maps */
-		std::map<UserId,InternalId> reverse_map = object_maps.find(Object::name())->second.getReverseMap();
-		std::map<UserId,std::vector<InternalId> > internal_map = object_maps.find(Object::name())->second.getInternalMap();
+		/* Get maps (by reference, they could be huge on geometries with a lot of cloned universes) */
+		const ObjectMap& object_map = object_maps.find(Object::name())->second;
+		const std::map<UserId,InternalId>& reverse_map = object_map.getReverseMap();
+		const std::map<UserId,std::vector<InternalId> >& internal_map = object_map.getInternalMap();
 		/* Detect if is a full path (only one cell) or a group of cells */
 		if(id.find("<") != std::string::npos) {
 			/* One specific cell */
-			std::map<UserId,InternalId>::iterator it = reverse_map.find(id);
+			std::map<UserId,InternalId>::const_iterator it = reverse_map.find(id);
 			if(it != reverse_map.end()) {
-				std::vector<InternalId> internal_ids;
-				internal_ids.push_back(it->second);
+				std::vector<InternalId> internal_ids(1, it->second);
 				return getContainer<Object>(internal_ids);
 			}
 			else
@@ -254,8 +265,7 @@ namespace Helios {
 			/* Group of objects (or a object on top level) */
 			std::map<UserId,std::vector<InternalId> >::const_iterator it = internal_map.find(id);
 			if(it != internal_map.end()) {
-				std::vector<InternalId> internal_ids = (*it).second;
-				return getContainer<Object>(internal_ids);
+				return getContainer<Object>((*it).second);
 			} else
 				throw GeometryError(Object::name() + " " + id + " does not exist");
 		}
@@ -0,0 +1,115 @@
+/*
+ Copyright (c) 2012, Esteban Pellegrino
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright
+ notice, this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+ * Neither the name of the <organization> nor the
+ names of its contributors may be used to endorse or promote products
+ derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GEOMETRYSTATE_HPP_
+#define GEOMETRYSTATE_HPP_
+
+#include <vector>
+#include <limits>
+
+#include "../Common/Common.hpp"
+
+namespace Helios {
+
+	class Cell;
+	class Surface;
+
+	/*
+	 * Tracking state of a particle on the geometry.
+	 *
+	 * Keeps the nearest surface of each ancestor cell (the cells filled by the universes that
+	 * contain the particle) along the current direction. While the particle flies on the same line
+	 * and remains inside the ancestor cell, the distance to that surface is the cached one minus
+	 * the flight length, so only the innermost level is evaluated on each step.
+	 */
+	class GeometryState {
+	public:
+
+		/* Nearest surface of a cell on some level of the geometry */
+		class Level {
+			/* Cell where the distance was calculated */
+			const Cell* cell;
+			/* Position and direction of the particle when the distance was calculated */
+			Coordinate position;
+			Direction direction;
+			/* Nearest surface */
+			Surface* surface;
+			bool sense;
+			double distance;
+		public:
+			Level() : cell(0), position(0.0,0.0,0.0), direction(0.0,0.0,0.0), surface(0), sense(false), distance(0.0) {/* */}
+
+			/* Distance from the position to the nearest surface (negative if the cache is not valid) */
+			double remaining(const Cell* current, const Coordinate& pos, const Direction& dir) const {
+				if(current != cell || dir[0] != direction[0] || dir[1] != direction[1] || dir[2] != direction[2])
+					return -1.0;
+				if(!surface) return std::numeric_limits<double>::infinity();
+				return distance - dot(pos - position, dir);
+			}
+
+			/* Update the cached surface */
+			void set(const Cell* current, const Coordinate& pos, const Direction& dir, Surface* near_surface, bool near_sense, double near_distance) {
+				cell = current;
+				position = pos;
+				direction = dir;
+				surface = near_surface;
+				sense = near_sense;
+				distance = near_distance;
+			}
+
+			Surface* getSurface() const {return surface;}
+			bool getSense() const {return sense;}
+
+			/* Invalidate the cached surface */
+			void reset() {cell = 0;}
+
+			~Level() {/* */}
+		};
+
+		GeometryState() {/* */}
+
+		/* Get the cache of a level on the geometry (zero is the outermost level) */
+		Level& getLevel(size_t level) {
+			if(level >= levels.size()) levels.resize(level + 1);
+			return levels[level];
+		}
+
+		/* Invalidate the cache of all the levels (keeping the memory for the next particle) */
+		void reset() {
+			for(std::vector<Level>::iterator it = levels.begin() ; it != levels.end() ; ++it)
+				it->reset();
+		}
+
+		~GeometryState() {/* */}
+
+	private:
+		/* Cache for each level */
+		std::vector<Level> levels;
+	};
+
+} /* namespace Helios */
+#endif /* GEOMETRYSTATE_HPP_ */
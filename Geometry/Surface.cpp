@@ -25,23 +25,71 @@
  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <algorithm>
+
 #include "Surface.hpp"
 #include "Surfaces/SurfaceTypes.hpp"
-
 #include "Cell.hpp"
+#include "Universe.hpp"
 
 using namespace std;
 
 namespace Helios {
 
 Surface::Surface(const SurfaceObject* definition) :
-		surfid(definition->getUserSurfaceId()), flag(definition->getFlags()), int_surfid(0) {/* */}
+		surfid(definition->getUserSurfaceId()), flag(definition->getFlags()), int_surfid(0), shared(false) {/* */}
 
 void Surface::addNeighborCell(const bool& sense, Cell* cell) {
-	if(sense)
+	if(sense) {
 		neighbor_pos.push_back(cell);
-	else
+		hits_pos.push_back(0);
+	} else {
 		neighbor_neg.push_back(cell);
+		hits_neg.push_back(0);
+	}
+}
+
+void Surface::setStatistics(bool gather) {
+	if(gather) {
+		statistics.start(hits_pos.size() + hits_neg.size());
+		return;
+	}
+	/* Add the counts of each thread */
+	std::vector<size_t> hits(hits_pos);
+	hits.insert(hits.end(), hits_neg.begin(), hits_neg.end());
+	statistics.stop(hits);
+	std::copy(hits.begin(), hits.begin() + hits_pos.size(), hits_pos.begin());
+	std::copy(hits.begin() + hits_pos.size(), hits.end(), hits_neg.begin());
+}
+
+/* Compare the number of hits of two neighbors (the order of insertion is kept on ties) */
+struct CompareHits {
+	const std::vector<size_t>& hits;
+	CompareHits(const std::vector<size_t>& hits) : hits(hits) {/* */}
+	bool operator() (size_t i, size_t j) const {
+		return hits[i] > hits[j];
+	}
+};
+
+/* Sort the neighbors from the most to the less frequent one */
+static void sortNeighbors(std::vector<Cell*>& neighbor, std::vector<size_t>& hits) {
+	std::vector<size_t> order(neighbor.size());
+	for(size_t i = 0 ; i < order.size() ; ++i)
+		order[i] = i;
+	std::stable_sort(order.begin(), order.end(), CompareHits(hits));
+	std::vector<Cell*> sorted_neighbor(neighbor.size());
+	std::vector<size_t> sorted_hits(hits.size());
+	for(size_t i = 0 ; i < order.size() ; ++i) {
+		sorted_neighbor[i] = neighbor[order[i]];
+		sorted_hits[i] = hits[order[i]];
+	}
+	neighbor.swap(sorted_neighbor);
+	hits.swap(sorted_hits);
+}
+
+void Surface::optimize() {
+	sortNeighbors(neighbor_pos,hits_pos);
+	sortNeighbors(neighbor_neg,hits_neg);
 }
 
 const std::vector<Cell*>& Surface::getNeighborCell(const bool& sense) const {
@@ -51,19 +99,46 @@ const std::vector<Cell*>& Surface::getNeighborCell(const bool& sense) const {
 		return neighbor_neg;
 }
 
+/* Check if a point is inside the cells filled by the universes that contain some cell */
+static bool isInsideAncestors(const Cell* cell, const Coordinate& position, const Surface* skip) {
+	for(const Cell* ancestor = cell->getParent()->getParent() ; ancestor ; ancestor = ancestor->getParent()->getParent())
+		if(not ancestor->isInside(position,skip)) return false;
+	return true;
+}
+
+/* Same as above, but the point could be just on a surface of the ancestors (i.e. on a corner) */
+static bool isOnAncestors(const Cell* cell, const Coordinate& position, const Surface* skip) {
+	static const double tolerance = 1e-9;
+	for(const Cell* ancestor = cell->getParent()->getParent() ; ancestor ; ancestor = ancestor->getParent()->getParent())
+		if(not ancestor->isInside(position,skip,tolerance)) return false;
+	return true;
+}
+
 /* Cross a surface, i.e. find next cell. Of course, this should be called on a position located on the surface */
 void Surface::cross(const Coordinate& position, const bool& sense, const Cell*& cell) const {
 	/* Set to zero */
 	cell = 0;
+	const Cell* corner_cell = 0;
 	const std::vector<Cell*>& neighbor = getNeighborCell(not sense);
 	std::vector<Cell*>::const_iterator it_neighbor = neighbor.begin();
 	for( ; it_neighbor != neighbor.end() ; ++it_neighbor) {
 		cell = (*it_neighbor)->findCell(position,this);
-		if(cell) break;
+		/* A neighbor of a shared surface could be on other branch of the geometry */
+		if(cell && shared && not isInsideAncestors(*it_neighbor,position,this)) {
+			/* Keep the first one that is just on a corner of its ancestors */
+			if(not corner_cell && isOnAncestors(*it_neighbor,position,this)) corner_cell = cell;
+			cell = 0;
+		}
+		if(cell) {
+			if(statistics.active()) countHit(not sense, it_neighbor - neighbor.begin());
+			break;
+		}
 	}
+	/* The point could be just on a corner of an ancestor cell */
+	if(not cell) cell = corner_cell;
 }
 
-bool Surface::cross(Particle& particle, const bool& sense, const Cell*& cell) const {
+bool Surface::boundary(Particle& particle, const bool& sense, bool& inside) const {
 	/* Check reflecting surface */
 	if(getFlags() & REFLECTING) {
 		/* Get normal */
@@ -74,11 +149,21 @@ bool Surface::cross(Particle& particle, const bool& sense, const Cell*& cell) co
 		/* Calculate the new direction */
 		double projection = 2 * dot(particle.dir(), vnormal);
 		particle.dir() = particle.dir() - projection * vnormal;
-		return true;
+		inside = true;
+		return false;
 	} else if (getFlags() & VACUUM) {
 		/* Reach a boundary */
+		inside = false;
 		return false;
 	}
+	/* Just a normal surface */
+	return true;
+}
+
+bool Surface::cross(Particle& particle, const bool& sense, const Cell*& cell) const {
+	/* Check boundary conditions */
+	bool inside;
+	if(not boundary(particle,sense,inside)) return inside;
 
 	/* Just a normal surface, cross and get new cell*/
 	cross(particle.pos(),sense,cell);
@@ -105,6 +190,10 @@ SurfaceFactory::SurfaceFactory() {
 	registerSurface(CylinderOnAxis<yaxis>());       /* c/y - radius x z */
 	registerSurface(CylinderOnAxis<zaxis>());       /* c/z - radius x y */
 	registerSurface(SphereOnOrigin());              /* so  - radius */
+	registerSurface(Plane());                       /* p   - a b c d */
+	registerSurface(BoxOnAxis());                   /* rpp - xmin xmax ymin ymax zmin zmax */
+	registerSurface(CircularCylinder());            /* rcc - base, height vector, radius */
+	registerSurface(HexagonalPrism());              /* rhp - base, height vector, vector to the first facet */
 }
 
 Surface* SurfaceFactory::createSurface(const SurfaceObject* definition) const {
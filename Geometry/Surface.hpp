@@ -36,12 +36,14 @@
 #include <fstream>
 
 #include "../Common/Common.hpp"
+#include "../Common/ThreadCounters.hpp"
 #include "../Transport/Particle.hpp"
 #include "GeometryObject.hpp"
 
 namespace Helios {
 
 	class SurfaceObject;
+	class SurfacePack;
 	class Cell;
 
 	class Surface {
@@ -86,6 +88,8 @@ namespace Helios {
 		virtual bool intersect(const Coordinate& pos, const Direction& dir, const bool& sense, double& distance) const  = 0;
 		/* Get the name of this surface */
 		virtual std::string getName() const = 0;
+		/* Push the coefficients of the surface into a pack of surfaces. Returns false if the type can't be packed */
+		virtual bool pack(SurfacePack& surface_pack, const bool& sense) {return false;}
 
 		/* Comparison operator */
 		bool operator==(const Surface& sur) {
@@ -99,6 +103,11 @@ namespace Helios {
 		/* Get neighbor cells of this surface */
 		const std::vector<Cell*>& getNeighborCell(const bool& sense) const;
 
+		/* Gather statistics of the neighbor cells found when the surface is crossed */
+		void setStatistics(bool gather);
+		/* Reorder the neighbor cells using the gathered statistics (the most frequent ones first) */
+		void optimize();
+
 		/* Return the user ID associated with this surface. */
 		const SurfaceId& getUserId() const {return surfid;}
 		/* Set internal / unique identifier for the cell */
@@ -109,6 +118,10 @@ namespace Helios {
 		SurfaceInfo getFlags() const {return flag;}
 		/* Set different options for the surfaces */
 		void setFlags(SurfaceInfo new_flag) {flag = new_flag;}
+		/* Set if the surface is shared by cells of unrelated universes */
+		void setShared(bool is_shared) {shared = is_shared;}
+		/* Check if the surface is shared by cells of unrelated universes */
+		bool isShared() const {return shared;}
 
 		/* Mathematically define a surface as a collection of points that satisfy this equation */
 		virtual double function(const Coordinate& pos) const = 0;
@@ -143,15 +156,18 @@ namespace Helios {
 
 	protected:
 		/* Default, used only on factory */
-		Surface() : surfid(), flag(NONE), int_surfid(0) {/* */};
+		Surface() : surfid(), flag(NONE), int_surfid(0), shared(false) {/* */};
 		/* Constructor from id and flags */
-		Surface(const SurfaceId& surfid, const SurfaceInfo& flag) : surfid(surfid), flag(flag), int_surfid(0) {/* */};
+		Surface(const SurfaceId& surfid, const SurfaceInfo& flag) : surfid(surfid), flag(flag), int_surfid(0), shared(false) {/* */};
 		/* Create surface from user id */
 		Surface(const SurfaceObject* definition);
 		/* Prevent copy */
 		Surface(const Surface& surface);
 		Surface& operator= (const Surface& other);
 
+		/* Check boundary conditions of the surface (returns true if the particle should cross it) */
+		bool boundary(Particle& particle, const bool& sense, bool& inside) const;
+
 		/* Print internal parameters of the surface */
 		virtual void print(std::ostream& out) const = 0;
 		/* Virtual comparison operator, to avoid duplicated surfaces on the geometry */
@@ -167,9 +183,23 @@ namespace Helios {
 		SurfaceInfo flag;
 		/* Internal identification of this surface */
 		InternalSurfaceId int_surfid;
+		/*
+		 * The surface is shared by cells of unrelated universes, so a neighbor cell could contain a point
+		 * that is outside of its ancestors.
+		 */
+		bool shared;
 		/* Neighbor cells */
 		std::vector<Cell*> neighbor_pos;
 		std::vector<Cell*> neighbor_neg;
+		/* Number of times each neighbor cell was found when the surface was crossed */
+		std::vector<size_t> hits_pos;
+		std::vector<size_t> hits_neg;
+		/* Counts of each thread while the statistics are gathered (positive neighbors first) */
+		ThreadCounters statistics;
+		/* Count a crossing into a neighbor cell */
+		void countHit(const bool& sense, size_t neighbor) const {
+			statistics.local()[sense ? neighbor : hits_pos.size() + neighbor]++;
+		}
 	};
 
 	class SurfaceObject : public GeometryObject {
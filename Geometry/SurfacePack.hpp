@@ -0,0 +1,291 @@
+/*
+ Copyright (c) 2012, Esteban Pellegrino
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright
+ notice, this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+ * Neither the name of the <organization> nor the
+ names of its contributors may be used to endorse or promote products
+ derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SURFACEPACK_HPP_
+#define SURFACEPACK_HPP_
+
+#include <vector>
+#include <limits>
+#include <cmath>
+
+#include "../Common/Common.hpp"
+
+namespace Helios {
+
+	class Surface;
+
+	/*
+	 * Surfaces of a cell packed by type, with the coefficients of each type stored on contiguous
+	 * arrays. The senses and distances of all the surfaces of a type are evaluated on a loop
+	 * without virtual calls and without branches (so the compiler can vectorize it), and the nearest
+	 * surface is picked with a min-reduction.
+	 *
+	 * The arithmetic is the same of each surface class, so the results are identical to the ones
+	 * obtained with the virtual calls (except the order in which ties are resolved).
+	 */
+	class SurfacePack {
+
+		/* Planes normal to an axis */
+		struct Planes {
+			std::vector<double> coordinate;
+			std::vector<int> sense;
+			std::vector<Surface*> surfaces;
+		};
+
+		/* Planes with any orientation (unit normal and distance to the origin) */
+		struct GeneralPlanes {
+			std::vector<double> nx;
+			std::vector<double> ny;
+			std::vector<double> nz;
+			std::vector<double> distance;
+			std::vector<int> sense;
+			std::vector<Surface*> surfaces;
+		};
+
+		/* Cylinders parallel to an axis (center on the other two coordinates, in increasing order) */
+		struct Cylinders {
+			std::vector<double> u;
+			std::vector<double> v;
+			std::vector<double> radius2;
+			std::vector<int> sense;
+			std::vector<Surface*> surfaces;
+		};
+
+		/* Spheres centered on the origin */
+		struct Spheres {
+			std::vector<double> radius2;
+			std::vector<int> sense;
+			std::vector<Surface*> surfaces;
+		};
+
+		Planes planes[3];
+		GeneralPlanes general_planes;
+		Cylinders cylinders[3];
+		Spheres spheres;
+
+		/* Number of surfaces */
+		size_t nsurfaces;
+
+		/* Other coordinates of an axis */
+		static int first(int axis) {return (axis == xaxis) ? yaxis : xaxis;}
+		static int second(int axis) {return (axis == zaxis) ? yaxis : zaxis;}
+
+		/* Distance to a quadratic surface (infinity if there is no intersection), same as quadraticIntersect */
+		static inline double quadraticDistance(double a, double k, double c, int sense) {
+			const double inf = std::numeric_limits<double>::infinity();
+			/* Discriminant */
+			double disc = k*k - a*c;
+			double sq = std::sqrt(std::max(disc, 0.0));
+			/* Particle inside or outside the surface */
+			double inside = (k <= 0) ? ((a > 0) ? (sq - k)/a : inf) : std::max(0.0, -c/(sq + k));
+			double outside = (k >= 0) ? ((a < 0) ? -(sq + k)/a : inf) : std::max(0.0, c/(sq - k));
+			double distance = sense ? outside : inside;
+			return (disc >= 0.0) ? distance : inf;
+		}
+
+		/* Keep the nearest surface of a type */
+		static inline void nearest(const double* distances, size_t n, double& distance, size_t& index) {
+			for(size_t i = 0 ; i < n ; ++i) {
+				bool closer = distances[i] < distance;
+				distance = closer ? distances[i] : distance;
+				index = closer ? i : index;
+			}
+		}
+
+	public:
+
+		/* Maximum number of surfaces of the same type (and axis) on the pack */
+		static const size_t max_surfaces = 64;
+
+		SurfacePack() : nsurfaces(0) {/* */}
+
+		/* Push surfaces, return false if there is no place for another surface of this type */
+		bool pushPlane(Surface* surface, int axis, double coordinate, bool sense) {
+			Planes& plane = planes[axis];
+			if(plane.surfaces.size() == max_surfaces) return false;
+			plane.coordinate.push_back(coordinate);
+			plane.sense.push_back(sense);
+			plane.surfaces.push_back(surface);
+			nsurfaces++;
+			return true;
+		}
+		bool pushGeneralPlane(Surface* surface, const Direction& normal, double distance, bool sense) {
+			GeneralPlanes& plane = general_planes;
+			if(plane.surfaces.size() == max_surfaces) return false;
+			plane.nx.push_back(normal[xaxis]);
+			plane.ny.push_back(normal[yaxis]);
+			plane.nz.push_back(normal[zaxis]);
+			plane.distance.push_back(distance);
+			plane.sense.push_back(sense);
+			plane.surfaces.push_back(surface);
+			nsurfaces++;
+			return true;
+		}
+		bool pushCylinder(Surface* surface, int axis, const Coordinate& point, double radius, bool sense) {
+			Cylinders& cylinder = cylinders[axis];
+			if(cylinder.surfaces.size() == max_surfaces) return false;
+			cylinder.u.push_back(point[first(axis)]);
+			cylinder.v.push_back(point[second(axis)]);
+			cylinder.radius2.push_back(radius * radius);
+			cylinder.sense.push_back(sense);
+			cylinder.surfaces.push_back(surface);
+			nsurfaces++;
+			return true;
+		}
+		bool pushSphere(Surface* surface, double radius, bool sense) {
+			if(spheres.surfaces.size() == max_surfaces) return false;
+			spheres.radius2.push_back(radius * radius);
+			spheres.sense.push_back(sense);
+			spheres.surfaces.push_back(surface);
+			nsurfaces++;
+			return true;
+		}
+
+		/* Number of surfaces on the pack */
+		size_t size() const {return nsurfaces;}
+
+		/* Check if the senses of the point are the ones of the pack, optionally skipping one surface */
+		bool isInside(const Coordinate& position, const Surface* skip = 0) const;
+
+		/* Update the nearest surface if one of the pack is closer */
+		void intersect(const Coordinate& position, const Direction& direction, Surface*& surface, bool& sense, double& distance) const;
+
+		~SurfacePack() {/* */}
+	};
+
+	inline bool SurfacePack::isInside(const Coordinate& position, const Surface* skip) const {
+		/* Number of surfaces where the point has the wrong sense */
+		size_t wrong = 0;
+		for(int axis = 0 ; axis < 3 ; ++axis) {
+			const Planes& plane = planes[axis];
+			double p = position[axis];
+			for(size_t i = 0 ; i < plane.surfaces.size() ; ++i)
+				wrong += ((p - plane.coordinate[i] >= 0) != (bool)plane.sense[i]) && (plane.surfaces[i] != skip);
+
+			const Cylinders& cylinder = cylinders[axis];
+			double pu = position[first(axis)];
+			double pv = position[second(axis)];
+			for(size_t i = 0 ; i < cylinder.surfaces.size() ; ++i) {
+				double x = pu - cylinder.u[i];
+				double y = pv - cylinder.v[i];
+				wrong += ((x*x + y*y - cylinder.radius2[i] >= 0) != (bool)cylinder.sense[i]) && (cylinder.surfaces[i] != skip);
+			}
+		}
+		const GeneralPlanes& plane = general_planes;
+		for(size_t i = 0 ; i < plane.surfaces.size() ; ++i) {
+			double f = plane.nx[i] * position[xaxis] + plane.ny[i] * position[yaxis] + plane.nz[i] * position[zaxis] - plane.distance[i];
+			wrong += ((f >= 0) != (bool)plane.sense[i]) && (plane.surfaces[i] != skip);
+		}
+		double r2 = dot(position, position);
+		for(size_t i = 0 ; i < spheres.surfaces.size() ; ++i)
+			wrong += ((r2 - spheres.radius2[i] >= 0) != (bool)spheres.sense[i]) && (spheres.surfaces[i] != skip);
+		return (wrong == 0);
+	}
+
+	inline void SurfacePack::intersect(const Coordinate& position, const Direction& direction, Surface*& surface, bool& sense, double& distance) const {
+		const double inf = std::numeric_limits<double>::infinity();
+		double distances[max_surfaces];
+		for(int axis = 0 ; axis < 3 ; ++axis) {
+			/* Planes, only the ones the particle is headed to are crossed */
+			const Planes& plane = planes[axis];
+			size_t nplanes = plane.surfaces.size();
+			if(nplanes) {
+				double p = position[axis];
+				double u = direction[axis];
+				for(size_t i = 0 ; i < nplanes ; ++i) {
+					bool hit = plane.sense[i] ? (u < 0) : (u > 0);
+					distances[i] = hit ? std::max(0.0, (plane.coordinate[i] - p) / u) : inf;
+				}
+				size_t index = nplanes;
+				nearest(distances, nplanes, distance, index);
+				if(index < nplanes) {
+					surface = plane.surfaces[index];
+					sense = plane.sense[index];
+				}
+			}
+
+			/* Cylinders */
+			const Cylinders& cylinder = cylinders[axis];
+			size_t ncylinders = cylinder.surfaces.size();
+			if(ncylinders) {
+				double a = 1 - direction[axis] * direction[axis];
+				double pu = position[first(axis)];
+				double pv = position[second(axis)];
+				double du = direction[first(axis)];
+				double dv = direction[second(axis)];
+				for(size_t i = 0 ; i < ncylinders ; ++i) {
+					double x = pu - cylinder.u[i];
+					double y = pv - cylinder.v[i];
+					double k = du * x + dv * y;
+					double c = x*x + y*y - cylinder.radius2[i];
+					distances[i] = quadraticDistance(a, k, c, cylinder.sense[i]);
+				}
+				size_t index = ncylinders;
+				nearest(distances, ncylinders, distance, index);
+				if(index < ncylinders) {
+					surface = cylinder.surfaces[index];
+					sense = cylinder.sense[index];
+				}
+			}
+		}
+
+		/* Planes with any orientation */
+		const GeneralPlanes& plane = general_planes;
+		size_t nplanes = plane.surfaces.size();
+		if(nplanes) {
+			for(size_t i = 0 ; i < nplanes ; ++i) {
+				double u = plane.nx[i] * direction[xaxis] + plane.ny[i] * direction[yaxis] + plane.nz[i] * direction[zaxis];
+				double p = plane.nx[i] * position[xaxis] + plane.ny[i] * position[yaxis] + plane.nz[i] * position[zaxis];
+				bool hit = plane.sense[i] ? (u < 0) : (u > 0);
+				distances[i] = hit ? std::max(0.0, (plane.distance[i] - p) / u) : inf;
+			}
+			size_t index = nplanes;
+			nearest(distances, nplanes, distance, index);
+			if(index < nplanes) {
+				surface = plane.surfaces[index];
+				sense = plane.sense[index];
+			}
+		}
+
+		/* Spheres */
+		size_t nspheres = spheres.surfaces.size();
+		if(nspheres) {
+			double k = dot(position, direction);
+			double r2 = dot(position, position);
+			for(size_t i = 0 ; i < nspheres ; ++i)
+				distances[i] = quadraticDistance(1.0, k, r2 - spheres.radius2[i], spheres.sense[i]);
+			size_t index = nspheres;
+			nearest(distances, nspheres, distance, index);
+			if(index < nspheres) {
+				surface = spheres.surfaces[index];
+				sense = spheres.sense[index];
+			}
+		}
+	}
+
+} /* namespace Helios */
+#endif /* SURFACEPACK_HPP_ */
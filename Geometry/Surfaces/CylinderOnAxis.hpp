@@ -31,6 +31,7 @@
 #include <cmath>
 
 #include "../Surface.hpp"
+#include "../SurfacePack.hpp"
 #include "SurfaceUtils.hpp"
 
 namespace Helios {
@@ -70,6 +71,7 @@ namespace Helios {
 		void normal(const Coordinate& point, Direction& vnormal) const;
 		bool intersect(const Coordinate& pos, const Direction& dir, const bool& sense, double& distance) const;
 		Surface* transformate(const Direction& trans) const;
+		bool pack(SurfacePack& surface_pack, const bool& sense);
 		/* Name of the surface */
 		std::string getName() const;
 
@@ -172,5 +174,10 @@ namespace Helios {
 		return new CylinderOnAxis<axis>(this->getUserId(),this->getFlags(),this->radius,new_point);
 	}
 
+	template<int axis>
+	bool CylinderOnAxis<axis>::pack(SurfacePack& surface_pack, const bool& sense) {
+		return surface_pack.pushCylinder(this, axis, point, radius, sense);
+	}
+
 } /* namespace Helios */
 #endif /* CYLINDERONAXIS_HPP_ */
@@ -29,6 +29,7 @@
 #define CYLINDERONAXISORIGIN_HPP_
 
 #include "../Surface.hpp"
+#include "../SurfacePack.hpp"
 #include "SurfaceUtils.hpp"
 #include "CylinderOnAxis.hpp"
 
@@ -67,6 +68,7 @@ namespace Helios {
 		void normal(const Coordinate& point, Direction& vnormal) const;
 		bool intersect(const Coordinate& pos, const Direction& dir, const bool& sense, double& distance) const;
 		Surface* transformate(const Direction& trans) const;
+		bool pack(SurfacePack& surface_pack, const bool& sense);
 		/* Name of the surface */
 		std::string getName() const;
 		/* Evaluate function */
@@ -158,5 +160,10 @@ namespace Helios {
 		}
 	}
 
+	template<int axis>
+	bool CylinderOnAxisOrigin<axis>::pack(SurfacePack& surface_pack, const bool& sense) {
+		return surface_pack.pushCylinder(this, axis, Coordinate(0.0,0.0,0.0), radius, sense);
+	}
+
 } /* namespace Helios */
 #endif /* CYLINDERONAXISORIGIN_HPP_ */
@@ -0,0 +1,258 @@
+/*
+ Copyright (c) 2012, Esteban Pellegrino
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright
+ notice, this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+ * Neither the name of the <organization> nor the
+ names of its contributors may be used to endorse or promote products
+ derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <limits>
+#include <cmath>
+
+#include "MacroBody.hpp"
+
+using namespace std;
+
+namespace Helios {
+
+void MacroBody::pushSlab(const Direction& normal, double min, double max) {
+	slab_normal[nslabs] = normal;
+	slab_min[nslabs] = min;
+	slab_max[nslabs] = max;
+	nslabs++;
+}
+
+void MacroBody::setLateral(const Coordinate& center, const Direction& axis, double radius) {
+	lateral = true;
+	lateral_center = center;
+	lateral_axis = axis;
+	lateral_radius = radius;
+}
+
+bool MacroBody::chord(const Coordinate& pos, const Direction& dir, double& entry, double& exit) const {
+	entry = -std::numeric_limits<double>::infinity();
+	exit = std::numeric_limits<double>::infinity();
+
+	/* Slabs */
+	for(int i = 0 ; i < nslabs ; ++i) {
+		double s = dot(pos, slab_normal[i]);
+		double v = dot(dir, slab_normal[i]);
+		if(v == 0.0) {
+			/* Parallel to the planes */
+			if(s < slab_min[i] || s > slab_max[i]) return false;
+			continue;
+		}
+		double t1 = (slab_min[i] - s) / v;
+		double t2 = (slab_max[i] - s) / v;
+		entry = max(entry, min(t1, t2));
+		exit = min(exit, max(t1, t2));
+	}
+
+	/* Lateral cylinder */
+	if(lateral) {
+		Direction w = radial(pos - lateral_center);
+		Direction d = radial(dir);
+		double a = dot(d, d);
+		double k = dot(w, d);
+		double c = dot(w, w) - lateral_radius * lateral_radius;
+		if(a == 0.0) {
+			/* Parallel to the axis */
+			if(c > 0.0) return false;
+		} else {
+			double disc = k*k - a*c;
+			if(disc < 0.0) return false;
+			double root = std::sqrt(disc);
+			entry = max(entry, (-k - root) / a);
+			exit = min(exit, (-k + root) / a);
+		}
+	}
+
+	return entry <= exit;
+}
+
+bool MacroBody::intersect(const Coordinate& pos, const Direction& dir, const bool& sense, double& distance) const {
+	double entry, exit;
+	if(chord(pos, dir, entry, exit)) {
+		if(!sense) {
+			/* Inside the body, we leave it on the exit point */
+			distance = max(0.0, exit);
+			return true;
+		} else if(entry + exit > 0.0) {
+			/*
+			 * Outside the body and headed towards it (the middle of the chord is ahead). The exit
+			 * distance alone is not enough, it could be a rounding off of zero just after leaving.
+			 */
+			distance = max(0.0, entry);
+			return true;
+		}
+	}
+	distance = 0.0;
+	return false;
+}
+
+double MacroBody::facetFunction(const Coordinate& pos, int& near_facet) const {
+	double value = -std::numeric_limits<double>::infinity();
+	near_facet = 0;
+
+	/* Slabs */
+	for(int i = 0 ; i < nslabs ; ++i) {
+		double s = dot(pos, slab_normal[i]);
+		double lower = slab_min[i] - s;
+		double upper = s - slab_max[i];
+		if(lower > value) {
+			value = lower;
+			near_facet = 2 * i;
+		}
+		if(upper > value) {
+			value = upper;
+			near_facet = 2 * i + 1;
+		}
+	}
+
+	/* Lateral cylinder */
+	if(lateral) {
+		Direction w = radial(pos - lateral_center);
+		double side = std::sqrt(dot(w, w)) - lateral_radius;
+		if(side > value) {
+			value = side;
+			near_facet = 2 * nslabs;
+		}
+	}
+
+	return value;
+}
+
+double MacroBody::function(const Coordinate& pos) const {
+	int near_facet;
+	return facetFunction(pos, near_facet);
+}
+
+int MacroBody::facet(const Coordinate& point) const {
+	int near_facet;
+	facetFunction(point, near_facet);
+	return near_facet;
+}
+
+void MacroBody::normal(const Coordinate& point, Direction& vnormal) const {
+	int near_facet = facet(point);
+	if(near_facet < 2 * nslabs) {
+		/* Planes of a slab */
+		const Direction& n = slab_normal[near_facet / 2];
+		vnormal = (near_facet % 2) ? n : Direction(-n);
+	} else {
+		/* Lateral cylinder */
+		Direction w = radial(point - lateral_center);
+		vnormal = w / std::sqrt(dot(w, w));
+	}
+}
+
+/* Unit vector */
+static inline Direction unit(const Direction& vector) {
+	return vector / std::sqrt(dot(vector, vector));
+}
+
+/* Number of coefficients of a macrobody */
+static inline void checkCoeffs(const SurfaceObject* definition, size_t ncoeffs, const std::string& expected) {
+	if(definition->getCoeffs().size() != ncoeffs)
+		throw Surface::BadSurfaceCreation(definition->getUserSurfaceId(),
+			  "Bad number of coefficients. Expected " + toString(ncoeffs) + " values : " + expected);
+}
+
+BoxOnAxis::BoxOnAxis(const SurfaceObject* definition) : MacroBody(definition) {
+	checkCoeffs(definition, 6, "xmin xmax ymin ymax zmin zmax");
+	vector<double> coeffs = definition->getCoeffs();
+	lower = Coordinate(coeffs[0], coeffs[2], coeffs[4]);
+	upper = Coordinate(coeffs[1], coeffs[3], coeffs[5]);
+	for(int i = 0 ; i < 3 ; ++i)
+		if(lower[i] >= upper[i])
+			throw Surface::BadSurfaceCreation(definition->getUserSurfaceId(),"Lower limits should be smaller than the upper ones");
+	setup();
+}
+
+void BoxOnAxis::setup() {
+	pushSlab(Direction(1.0,0.0,0.0), lower[xaxis], upper[xaxis]);
+	pushSlab(Direction(0.0,1.0,0.0), lower[yaxis], upper[yaxis]);
+	pushSlab(Direction(0.0,0.0,1.0), lower[zaxis], upper[zaxis]);
+}
+
+Surface* BoxOnAxis::transformate(const Direction& trans) const {
+	return new BoxOnAxis(this->getUserId(),this->getFlags(),lower + trans,upper + trans);
+}
+
+CircularCylinder::CircularCylinder(const SurfaceObject* definition) : MacroBody(definition) {
+	checkCoeffs(definition, 7, "vx vy vz hx hy hz radius");
+	vector<double> coeffs = definition->getCoeffs();
+	base = Coordinate(coeffs[0], coeffs[1], coeffs[2]);
+	height = Direction(coeffs[3], coeffs[4], coeffs[5]);
+	radius = coeffs[6];
+	if(dot(height, height) == 0.0 || radius <= 0.0)
+		throw Surface::BadSurfaceCreation(definition->getUserSurfaceId(),"Height and radius should be different from zero");
+	setup();
+}
+
+void CircularCylinder::setup() {
+	Direction axis = unit(height);
+	double bottom = dot(base, axis);
+	pushSlab(axis, bottom, bottom + std::sqrt(dot(height, height)));
+	setLateral(base, axis, radius);
+}
+
+Surface* CircularCylinder::transformate(const Direction& trans) const {
+	return new CircularCylinder(this->getUserId(),this->getFlags(),base + trans,height,radius);
+}
+
+HexagonalPrism::HexagonalPrism(const SurfaceObject* definition) : MacroBody(definition) {
+	checkCoeffs(definition, 9, "vx vy vz hx hy hz rx ry rz");
+	vector<double> coeffs = definition->getCoeffs();
+	base = Coordinate(coeffs[0], coeffs[1], coeffs[2]);
+	height = Direction(coeffs[3], coeffs[4], coeffs[5]);
+	facet_vector = Direction(coeffs[6], coeffs[7], coeffs[8]);
+	if(dot(height, height) == 0.0 || dot(facet_vector, facet_vector) == 0.0)
+		throw Surface::BadSurfaceCreation(definition->getUserSurfaceId(),"Height and facet vectors should be different from zero");
+	double cosine = dot(height, facet_vector) / std::sqrt(dot(height, height) * dot(facet_vector, facet_vector));
+	if(std::abs(cosine) > 1e-10)
+		throw Surface::BadSurfaceCreation(definition->getUserSurfaceId(),"Facet vector should be perpendicular to the height");
+	setup();
+}
+
+void HexagonalPrism::setup() {
+	Direction axis = unit(height);
+	double bottom = dot(base, axis);
+	pushSlab(axis, bottom, bottom + std::sqrt(dot(height, height)));
+
+	/* Facets normals, rotated by 60 degrees around the axis */
+	double apothem = std::sqrt(dot(facet_vector, facet_vector));
+	Direction u = facet_vector / apothem;
+	Direction w(axis[1]*u[2] - axis[2]*u[1], axis[2]*u[0] - axis[0]*u[2], axis[0]*u[1] - axis[1]*u[0]);
+	double sine = std::sqrt(3.0) / 2.0;
+	Direction normals[3] = {u, 0.5 * u + sine * w, -0.5 * u + sine * w};
+	for(int i = 0 ; i < 3 ; ++i) {
+		double center = dot(base, normals[i]);
+		pushSlab(normals[i], center - apothem, center + apothem);
+	}
+}
+
+Surface* HexagonalPrism::transformate(const Direction& trans) const {
+	return new HexagonalPrism(this->getUserId(),this->getFlags(),base + trans,height,facet_vector);
+}
+
+} /* namespace Helios */
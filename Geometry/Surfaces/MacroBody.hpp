@@ -0,0 +1,237 @@
+/*
+ Copyright (c) 2012, Esteban Pellegrino
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright
+ notice, this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+ * Neither the name of the <organization> nor the
+ names of its contributors may be used to endorse or promote products
+ derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef MACROBODY_HPP_
+#define MACROBODY_HPP_
+
+#include "../Surface.hpp"
+
+namespace Helios {
+
+	/*
+	 * Base class of the macrobodies. A macrobody is a closed convex body defined as the
+	 * intersection of slabs (pair of parallel planes) and, optionally, a lateral cylinder.
+	 * The whole body is a single surface with one routine to get the intersections, the
+	 * negative sense is the inside of the body.
+	 *
+	 * The facets are numbered as 2*i (lower plane of the slab i), 2*i + 1 (upper plane of
+	 * the slab i) and 2*nslabs (lateral cylinder).
+	 */
+	class MacroBody: public Helios::Surface {
+
+	protected:
+		/* Maximum number of slabs of a body */
+		static const int max_slabs = 4;
+
+		/* Slabs (unit normal and limits of the projection of the points on the normal) */
+		int nslabs;
+		Direction slab_normal[max_slabs];
+		double slab_min[max_slabs];
+		double slab_max[max_slabs];
+
+		/* Lateral cylinder */
+		bool lateral;
+		Coordinate lateral_center;
+		Direction lateral_axis;
+		double lateral_radius;
+
+		/* Default, used only on factory */
+		MacroBody() : nslabs(0), lateral(false), lateral_radius(0) {/* */};
+		MacroBody(const SurfaceId& surid, const SurfaceInfo& flags) : Surface(surid,flags), nslabs(0), lateral(false), lateral_radius(0) {/* */};
+		MacroBody(const SurfaceObject* definition) : Surface(definition), nslabs(0), lateral(false), lateral_radius(0) {/* */};
+
+		/* Add a slab */
+		void pushSlab(const Direction& normal, double min, double max);
+		/* Set the lateral cylinder */
+		void setLateral(const Coordinate& center, const Direction& axis, double radius);
+
+		/* Distances where a line enters and leaves the body, returns false if the line misses it */
+		bool chord(const Coordinate& pos, const Direction& dir, double& entry, double& exit) const;
+
+		/* Radial component of a vector respect the lateral cylinder axis */
+		Direction radial(const Direction& vector) const {
+			return vector - dot(vector, lateral_axis) * lateral_axis;
+		}
+
+	public:
+		/* Facet of the body where the point is (or the nearest one) */
+		int facet(const Coordinate& point) const;
+
+		/* Outward normal of the facet where the point is */
+		void normal(const Coordinate& point, Direction& vnormal) const;
+		bool intersect(const Coordinate& pos, const Direction& dir, const bool& sense, double& distance) const;
+
+		/* Largest distance of the point outside the facets (negative inside the body) */
+		double function(const Coordinate& pos) const;
+
+		virtual ~MacroBody() {/* */};
+
+	private:
+		/* Evaluate the function and get the facet */
+		double facetFunction(const Coordinate& pos, int& near_facet) const;
+	};
+
+	/* Rectangular parallelepiped aligned with the axes */
+	class BoxOnAxis: public MacroBody {
+		/* Static constructor functions */
+		static Surface* Constructor(const SurfaceObject* definition) {
+			return new BoxOnAxis(definition);
+		}
+		/* Print surface internal data */
+		void print(std::ostream& out) const {
+			out << "lower = " << lower << " ; upper = " << upper;
+		}
+		/* Return constructor function */
+		Surface::Constructor constructor() const {
+			return BoxOnAxis::Constructor;
+		}
+
+		/* Lower and upper corners */
+		Coordinate lower;
+		Coordinate upper;
+
+		/* Set the slabs */
+		void setup();
+	public:
+		/* Default, used only on factory */
+		BoxOnAxis() : lower(0.0,0.0,0.0), upper(0.0,0.0,0.0) {/* */};
+		BoxOnAxis(const SurfaceId& surid, const SurfaceInfo& flags, const Coordinate& lower, const Coordinate& upper)
+                  : MacroBody(surid,flags), lower(lower), upper(upper) {setup();};
+		BoxOnAxis(const SurfaceObject* definition);
+
+		Surface* transformate(const Direction& trans) const;
+
+		/* Name of the surface */
+		std::string getName() const {
+			return "rpp";
+		}
+
+		/* Comparison */
+		bool compare(const Surface& sur) const {
+	        /* safe to static cast because Surface::== already confirmed the type */
+	        const BoxOnAxis& box = static_cast<const BoxOnAxis&>(sur);
+	        return compareTinyVector(lower,box.lower) && compareTinyVector(upper,box.upper);
+		}
+
+		virtual ~BoxOnAxis() {/* */};
+	};
+
+	/* Right circular cylinder, closed by two planes */
+	class CircularCylinder: public MacroBody {
+		/* Static constructor functions */
+		static Surface* Constructor(const SurfaceObject* definition) {
+			return new CircularCylinder(definition);
+		}
+		/* Print surface internal data */
+		void print(std::ostream& out) const {
+			out << "base = " << base << " ; height = " << height << " ; radius = " << radius;
+		}
+		/* Return constructor function */
+		Surface::Constructor constructor() const {
+			return CircularCylinder::Constructor;
+		}
+
+		/* Center of the base, height vector and radius */
+		Coordinate base;
+		Direction height;
+		double radius;
+
+		/* Set the slabs */
+		void setup();
+	public:
+		/* Default, used only on factory */
+		CircularCylinder() : base(0.0,0.0,0.0), height(0.0,0.0,0.0), radius(0) {/* */};
+		CircularCylinder(const SurfaceId& surid, const SurfaceInfo& flags, const Coordinate& base, const Direction& height, double radius)
+                         : MacroBody(surid,flags), base(base), height(height), radius(radius) {setup();};
+		CircularCylinder(const SurfaceObject* definition);
+
+		Surface* transformate(const Direction& trans) const;
+
+		/* Name of the surface */
+		std::string getName() const {
+			return "rcc";
+		}
+
+		/* Comparison */
+		bool compare(const Surface& sur) const {
+	        /* safe to static cast because Surface::== already confirmed the type */
+	        const CircularCylinder& cyl = static_cast<const CircularCylinder&>(sur);
+	        return compareTinyVector(base,cyl.base) && compareTinyVector(height,cyl.height) && compareFloating(radius,cyl.radius);
+		}
+
+		virtual ~CircularCylinder() {/* */};
+	};
+
+	/* Right hexagonal prism */
+	class HexagonalPrism: public MacroBody {
+		/* Static constructor functions */
+		static Surface* Constructor(const SurfaceObject* definition) {
+			return new HexagonalPrism(definition);
+		}
+		/* Print surface internal data */
+		void print(std::ostream& out) const {
+			out << "base = " << base << " ; height = " << height << " ; facet = " << facet_vector;
+		}
+		/* Return constructor function */
+		Surface::Constructor constructor() const {
+			return HexagonalPrism::Constructor;
+		}
+
+		/* Center of the base, height vector and vector from the axis to the center of the first facet */
+		Coordinate base;
+		Direction height;
+		Direction facet_vector;
+
+		/* Set the slabs */
+		void setup();
+	public:
+		/* Default, used only on factory */
+		HexagonalPrism() : base(0.0,0.0,0.0), height(0.0,0.0,0.0), facet_vector(0.0,0.0,0.0) {/* */};
+		HexagonalPrism(const SurfaceId& surid, const SurfaceInfo& flags, const Coordinate& base, const Direction& height, const Direction& facet_vector)
+                       : MacroBody(surid,flags), base(base), height(height), facet_vector(facet_vector) {setup();};
+		HexagonalPrism(const SurfaceObject* definition);
+
+		Surface* transformate(const Direction& trans) const;
+
+		/* Name of the surface */
+		std::string getName() const {
+			return "rhp";
+		}
+
+		/* Comparison */
+		bool compare(const Surface& sur) const {
+	        /* safe to static cast because Surface::== already confirmed the type */
+	        const HexagonalPrism& hex = static_cast<const HexagonalPrism&>(sur);
+	        return compareTinyVector(base,hex.base) && compareTinyVector(height,hex.height) &&
+	        	   compareTinyVector(facet_vector,hex.facet_vector);
+		}
+
+		virtual ~HexagonalPrism() {/* */};
+	};
+
+} /* namespace Helios */
+#endif /* MACROBODY_HPP_ */
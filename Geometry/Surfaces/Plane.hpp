@@ -0,0 +1,124 @@
+/*
+ Copyright (c) 2012, Esteban Pellegrino
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright
+ notice, this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+ * Neither the name of the <organization> nor the
+ names of its contributors may be used to endorse or promote products
+ derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PLANE_HPP_
+#define PLANE_HPP_
+
+#include <cmath>
+
+#include "../Surface.hpp"
+#include "../SurfacePack.hpp"
+
+namespace Helios {
+
+	/* General plane a*x + b*y + c*z - d = 0 (the coefficients are normalized) */
+	class Plane: public Helios::Surface {
+		/* Static constructor functions */
+		static Surface* Constructor(const SurfaceObject* definition) {
+			return new Plane(definition);
+		}
+		/* Print surface internal data */
+		void print(std::ostream& out) const {
+			out << "normal = " << plane_normal << " ; distance = " << distance;
+		}
+		/* Return constructor function */
+		Surface::Constructor constructor() const {
+			return Plane::Constructor;
+		}
+
+		/* Unit normal and distance to the origin */
+		Direction plane_normal;
+		double distance;
+
+		/* Normalize the coefficients */
+		void setup() {
+			double norm = std::sqrt(dot(plane_normal, plane_normal));
+			plane_normal = plane_normal / norm;
+			distance = distance / norm;
+		}
+	public:
+		/* Default, used only on factory */
+		Plane() : plane_normal(0.0,0.0,0.0), distance(0) {/* */};
+		Plane(const SurfaceId& surid, const SurfaceInfo& flags, const Direction& plane_normal, const double& distance)
+              : Surface(surid,flags), plane_normal(plane_normal), distance(distance) {setup();};
+		Plane(const SurfaceObject* definition) : Surface(definition) {
+			/* Check number of parameters */
+			if(definition->getCoeffs().size() == 4) {
+				std::vector<double> coeffs = definition->getCoeffs();
+				plane_normal = Direction(coeffs[0], coeffs[1], coeffs[2]);
+				distance = coeffs[3];
+			} else {
+				throw Surface::BadSurfaceCreation(definition->getUserSurfaceId(),
+					  "Bad number of coefficients. Expected 4 values : a b c d ");
+			}
+			if(dot(plane_normal, plane_normal) == 0.0)
+				throw Surface::BadSurfaceCreation(definition->getUserSurfaceId(),"The normal of the plane is zero");
+			setup();
+		}
+
+		void normal(const Coordinate& point, Direction& vnormal) const {
+			vnormal = plane_normal;
+		}
+		bool intersect(const Coordinate& pos, const Direction& dir, const bool& sense, double& distance) const {
+			double u = dot(dir, plane_normal);
+		    if (((sense == false) && (u > 0)) || ((sense == true)  && (u < 0))) {
+		        /* Headed towards surface */
+		        distance = std::max(0.0, (this->distance - dot(pos, plane_normal)) / u);
+		        return true;
+		    }
+		    distance = 0.0;
+		    return false;
+		}
+		Surface* transformate(const Direction& trans) const {
+			return new Plane(this->getUserId(),this->getFlags(),plane_normal,distance + dot(trans, plane_normal));
+		}
+		bool pack(SurfacePack& surface_pack, const bool& sense) {
+			return surface_pack.pushGeneralPlane(this, plane_normal, distance, sense);
+		}
+
+		/* Evaluate function */
+		double function(const Coordinate& pos) const {
+			return dot(pos, plane_normal) - distance;
+		}
+
+		/* Name of the surface */
+		std::string getName() const {
+			return "p";
+		}
+
+		/* Comparison */
+		bool compare(const Surface& sur) const {
+	        /* safe to static cast because Surface::== already confirmed the type */
+	        const Plane& plane = static_cast<const Plane&>(sur);
+	        return compareTinyVector(plane_normal,plane.plane_normal) && compareFloating(distance,plane.distance);
+		}
+
+		virtual ~Plane() {/* */};
+	};
+
+} /* namespace Helios */
+#endif /* PLANE_HPP_ */
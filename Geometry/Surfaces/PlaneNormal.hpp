@@ -29,6 +29,7 @@
 #define PLANENORMAL_HPP_
 
 #include "../Surface.hpp"
+#include "../SurfacePack.hpp"
 
 namespace Helios {
 
@@ -65,6 +66,7 @@ namespace Helios {
 		void normal(const Coordinate& point, Direction& vnormal) const;
 		bool intersect(const Coordinate& pos, const Direction& dir, const bool& sense, double& distance) const;
 		Surface* transformate(const Direction& trans) const;
+		bool pack(SurfacePack& surface_pack, const bool& sense);
 		/* Name of the surface */
 		std::string getName() const;
 		/* Evaluate function */
@@ -152,5 +154,10 @@ namespace Helios {
 		return new PlaneNormal<axis>(this->getUserId(),this->getFlags(),(this->coordinate + trans[axis]));
 	}
 
+	template<int axis>
+	bool PlaneNormal<axis>::pack(SurfacePack& surface_pack, const bool& sense) {
+		return surface_pack.pushPlane(this, axis, coordinate, sense);
+	}
+
 } /* namespace Helios */
 #endif /* PLANENORMAL_HPP_ */
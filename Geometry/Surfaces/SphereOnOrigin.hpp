@@ -29,6 +29,7 @@
 #define SPHEREONORIGIN_HPP_
 
 #include "../Surface.hpp"
+#include "../SurfacePack.hpp"
 
 namespace Helios {
 
@@ -58,6 +59,9 @@ public:
 	void normal(const Coordinate& point, Direction& vnormal) const;
 	bool intersect(const Coordinate& pos, const Direction& dir, const bool& sense, double& distance) const;
 	Surface* transformate(const Direction& trans) const;
+	bool pack(SurfacePack& surface_pack, const bool& sense) {
+		return surface_pack.pushSphere(this, radius, sense);
+	}
 
 	/* Evaluate function */
 	double function(const Coordinate& pos) const;
@@ -32,5 +32,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "CylinderOnAxisOrigin.hpp"
 #include "CylinderOnAxis.hpp"
 #include "PlaneNormal.hpp"
+#include "Plane.hpp"
+#include "MacroBody.hpp"
 
 #endif /* SURFACETYPES_HPP_ */
@@ -43,6 +43,8 @@ public:
 	Transformation(const Direction& translation = Direction(0,0,0), const Direction& rotation = Direction(0,0,0))
 					: translation(translation), rotation(rotation) {/* */}
 
+	/* Get the translation */
+	const Direction& getTranslation() const {return translation;}
 	/* Returns a new instance of a cloned transformed surface */
 	Surface* operator()(const Surface* surface) const { return surface->transformate(translation); }
 
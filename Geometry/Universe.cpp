@@ -34,7 +34,7 @@ namespace Helios {
 
 const UniverseId Universe::BASE = "0";
 
-Universe::Universe(const UniverseId& user_id, Cell* parent) : user_id(user_id), parent(parent) {/* */}
+Universe::Universe(const UniverseId& user_id, Cell* parent) : user_id(user_id), parent(parent), lookup(0) {/* */}
 
 void Universe::addCell(Cell* cell) {
 	/* Link the cell to this universe */
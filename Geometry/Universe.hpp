@@ -32,6 +32,7 @@
 
 #include "Cell.hpp"
 #include "Surface.hpp"
+#include "GeometricFeature.hpp"
 
 #include "../Common/Common.hpp"
 
@@ -56,6 +57,9 @@ namespace Helios {
 		 */
 		Cell* parent;
 
+		/* Arithmetic lookup of the cells, when the universe is a lattice or a pin (NULL otherwise) */
+		const FeatureLookup* lookup;
+
 	protected:
 
 		/* Prevent copy */
@@ -94,6 +98,14 @@ namespace Helios {
 
 		/* Find cell inside the universe */
 		const Cell* findCell(const Coordinate& position, const Surface* skip = 0) const {
+			/* On a lattice or a pin, check first the cell where the point should be */
+			if(lookup) {
+				int index = lookup->getIndex(position);
+				if(index >= 0) {
+					const Cell* in_cell = cells[index]->findCell(position,skip);
+					if (in_cell) return in_cell;
+				}
+			}
 			/* loop through all cells in problem */
 			for (std::vector<Cell*>::const_iterator it_cell = cells.begin(); it_cell != cells.end(); ++it_cell) {
 				const Cell* in_cell = (*it_cell)->findCell(position,skip);
@@ -102,6 +114,16 @@ namespace Helios {
 			return 0;
 		}
 
+		/* Set the lookup of the feature cells (the universe takes the ownership) */
+		void setLookup(const FeatureLookup* feature_lookup) {
+			delete lookup;
+			lookup = feature_lookup;
+			/* The index of the lookup is the position of the cell */
+			if(lookup)
+				for(size_t i = 0 ; i < cells.size() ; ++i)
+					cells[i]->setFeatureIndex(i);
+		}
+
 		/* Set a parent for this universe */
 		void setParent(Cell* cell) {parent = cell;};
 		/* Get parent cell */
@@ -114,7 +136,7 @@ namespace Helios {
 		/* Return the internal ID associated with the universe. */
 		const InternalUniverseId& getInternalId() const {return internal_id;}
 
-		virtual ~Universe() {/* */};
+		virtual ~Universe() {delete lookup;};
 	};
 
 
@@ -170,6 +170,10 @@ int main(int argc, char **argv) {
 		Log::fout() << endl << endl << "[#] General settings" << endl << endl;
 		environment.getModule<Settings>()->print(Log::fout());
 
+		Log::printLine(Log::fout(), "*");
+		Log::fout() << endl << endl << "[#] Memory" << endl << endl;
+		environment.printMemory(Log::fout());
+
 		/* Launch simulation */
 		environment.simulate();
 
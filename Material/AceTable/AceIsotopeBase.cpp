@@ -32,6 +32,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "AceReader/Ace.hpp"
 #include "AceReaction/AceReactionBase.hpp"
 #include "AceReaction/FissionReaction.hpp"
+#include "AceReaction/ElasticScattering.hpp"
+#include "DopplerBroadening.hpp"
 #include "../../Common/XsSampler.hpp"
 #include "../../Environment/McEnvironment.hpp"
 
@@ -44,6 +46,23 @@ using namespace Ace;
 namespace Helios {
 
 AceIsotopeBase* AceIsotopeFactory::createIsotope(const Ace::NeutronTable& table) const {
+	/* All the sampling tables of the isotope are stored on the same arena */
+	Arena* arena = new Arena;
+	AceIsotopeBase* isotope(0);
+	try {
+		Arena::Scope scope(arena);
+		isotope = buildIsotope(table);
+	} catch(...) {
+		delete arena;
+		throw;
+	}
+	/* The arena is not modified anymore */
+	arena->shrink();
+	isotope->arena = arena;
+	return isotope;
+}
+
+AceIsotopeBase* AceIsotopeFactory::buildIsotope(const Ace::NeutronTable& table) const {
 	/* Create child grid */
 	const ChildGrid* child_grid = master_grid->pushGrid(table.getEnergyGrid().begin(), table.getEnergyGrid().end());
 
@@ -101,10 +120,11 @@ AceIsotopeBase* AceIsotopeFactory::createIsotope(const Ace::NeutronTable& table)
 
 double AceIsotopeBase::energy_freegas_threshold = 400.0; /* By default, 400.0 kT*/
 double AceIsotopeBase::awr_freegas_threshold = 1.0;      /* By default, only H */
+AceReaction::FreeGasTable AceIsotopeBase::freegas_table;  /* By default, rejection sampling */
 
 AceIsotopeBase::AceIsotopeBase(const Ace::NeutronTable& _table, const ChildGrid* _child_grid) : Isotope(_table.getReactions().name()),
 	reactions(_table.getReactions()), aweight(reactions.awr()), temperature(reactions.temp()), child_grid(_child_grid),
-	secondary_sampler(0) {
+	secondary_sampler(0), arena(0), compacted(false) {
 
 	/* Total microscopic cross section of this isotope */
 	total_xs = reactions.get_xs(1);
@@ -217,6 +237,9 @@ Reaction* AceIsotopeBase::getReaction(InternalId mt) {
 		reaction_map[mt] = reaction;
 		/* And return it... */
 		return reaction;
+	} else if(compacted) {
+		/* The data of the reaction was released */
+		throw(AceModule::AceError(reactions.name(),"Reaction mt = " + toString(mt) + " is not available after the ACE data was compacted"));
 	} else {
 		/* Reaction can't be found */
 		throw(AceModule::AceError(reactions.name(),"Reaction mt = " + toString(mt) + " does not exist"));
@@ -224,9 +247,110 @@ Reaction* AceIsotopeBase::getReaction(InternalId mt) {
 
 }
 
+size_t AceIsotopeBase::getMemory() const {
+	size_t memory = sizeof(*this) + reactions.getMemory();
+	memory += total_xs.getMemory() + absorption_xs.getMemory() + elastic_xs.getMemory() + inelastic_xs.getMemory();
+	if(arena) memory += arena->bytes();
+	if(secondary_sampler) memory += secondary_sampler->getMemory();
+	return memory;
+}
+
+void AceIsotopeBase::compact() {
+	reactions.release();
+	compacted = true;
+}
+
 void AceIsotopeBase::print(std::ostream& out) const {
 	out << "isotope = " <<  setw(9) << reactions.name()
-		<< " ; awr = " << setw(9) << aweight << " ; temperature = " << temperature / Constant::boltz << " K ";
+		<< " ; awr = " << setw(9) << aweight << " ; temperature = " << temperature / Constant::boltz << " K "
+		<< " ; memory = " << getMemory() / 1024 << " kB ";
+}
+
+/* Elastic scattering with the target at a fixed temperature */
+class ElasticTemperature : public Reaction {
+	const AceReaction::FreeGasScattering* elastic;
+	double temperature;
+public:
+	ElasticTemperature(const AceReaction::FreeGasScattering* elastic, double temperature) :
+		Reaction(elastic->getId()), elastic(elastic), temperature(temperature) {/* */}
+	void operator()(Particle& particle, Random& random) const {
+		elastic->scatter(particle, random, temperature);
+	}
+	void print(std::ostream& out) const {
+		elastic->print(out);
+		out << "  - broadened to " << temperature / Constant::boltz << " K" << endl;
+	}
+	~ElasticTemperature() {/* */}
+};
+
+AceIsotopeTemperature::AceIsotopeTemperature(const AceIsotopeBase* isotope, double temperature) : Isotope(isotope->getUserId()),
+	isotope(isotope), temperature(temperature), elastic_scattering(0) {
+	fissile = isotope->isFissile();
+	setInternalId(isotope->getInternalId());
+	/* Elastic reaction sampling the target motion at this temperature */
+	const AceReaction::FreeGasScattering* elastic = dynamic_cast<const AceReaction::FreeGasScattering*>(isotope->elastic());
+	if(elastic)
+		elastic_scattering = new ElasticTemperature(elastic, temperature);
+
+	/* Cross sections of the data on the grid of the isotope */
+	const ChildGrid* child_grid = isotope->child_grid;
+	size_t npoints = child_grid->size();
+	vector<double> energies(npoints);
+	vector<vector<double> > data(fissile ? 4 : 3, vector<double>(npoints, 0.0));
+	for(size_t i = 0 ; i < npoints ; ++i) {
+		energies[i] = (*child_grid)[i];
+		data[0][i] = isotope->total_xs[i];
+		data[1][i] = isotope->absorption_xs[i];
+		data[2][i] = isotope->elastic_xs[i];
+		if(fissile) {
+			Energy energy(0, energies[i]);
+			data[3][i] = isotope->getFissionXs(energy);
+		}
+	}
+
+	/* Broaden all of them at once */
+	vector<const vector<double>*> values;
+	for(size_t n = 0 ; n < data.size() ; ++n)
+		values.push_back(&data[n]);
+	vector<vector<double> > broadened;
+	DopplerBroadening kernel(energies, isotope->getAwr() / (temperature - isotope->getTemperature()));
+	kernel.broaden(values, broadened);
+	total_xs.swap(broadened[0]);
+	absorption_xs.swap(broadened[1]);
+	elastic_xs.swap(broadened[2]);
+	if(fissile) fission_xs.swap(broadened[3]);
+}
+
+double AceIsotopeTemperature::getXs(Energy& energy, const vector<double>& xs) const {
+	double factor;
+	size_t idx = isotope->child_grid->index(energy, factor);
+	return factor * (xs[idx + 1] - xs[idx]) + xs[idx];
+}
+
+double AceIsotopeTemperature::getAbsorptionProb(Energy& energy) const {
+	return getXs(energy, absorption_xs) / getXs(energy, total_xs);
+}
+
+double AceIsotopeTemperature::getElasticProb(Energy& energy) const {
+	return getXs(energy, elastic_xs) / getXs(energy, total_xs);
+}
+
+double AceIsotopeTemperature::getFissionProb(Energy& energy) const {
+	return getFissionXs(energy) / getXs(energy, total_xs);
+}
+
+size_t AceIsotopeTemperature::getMemory() const {
+	size_t memory = sizeof(*this);
+	memory += (total_xs.capacity() + absorption_xs.capacity() + elastic_xs.capacity() + fission_xs.capacity()) * sizeof(double);
+	return memory;
+}
+
+void AceIsotopeTemperature::print(std::ostream& out) const {
+	out << *isotope << " ; broadened to " << temperature / Constant::boltz << " K ";
+}
+
+AceIsotopeTemperature::~AceIsotopeTemperature() {
+	delete elastic_scattering;
 }
 
 AceIsotopeBase::~AceIsotopeBase() {
@@ -235,6 +359,8 @@ AceIsotopeBase::~AceIsotopeBase() {
 		delete (*it).second;
 	/* Delete sampler */
 	delete secondary_sampler;
+	/* Delete the storage of the tables */
+	delete arena;
 };
 
 }
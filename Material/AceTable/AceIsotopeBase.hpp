@@ -31,8 +31,10 @@
 #include "AceReader/ReactionContainer.hpp"
 #include "AceReader/NeutronTable.hpp"
 #include "AceReaction/NuSampler.hpp"
+#include "AceReaction/FreeGasTable.hpp"
 #include "../../Environment/McModule.hpp"
 #include "../../Common/Common.hpp"
+#include "../../Common/Arena.hpp"
 #include "../Grid/MasterGrid.hpp"
 #include "../Isotope.hpp"
 
@@ -89,11 +91,22 @@ template<typename TypeReaction> class XsSampler;
 		/* Secondary particle reaction sampler (using an interpolation factor) */
 		XsSampler<Reaction*>* secondary_sampler;
 
+		/* Storage of the sampling tables of the reactions */
+		Arena* arena;
+
+		/* Flag if the reactions of the ACE table were released */
+		bool compacted;
+
+		/* The cross sections are broadened from the data of this isotope */
+		friend class AceIsotopeTemperature;
+
 	public:
 
 		/* Threshold values */
 		static double energy_freegas_threshold;
 		static double awr_freegas_threshold;
+		/* Target velocity table for the free gas treatment (empty for rejection sampling) */
+		static AceReaction::FreeGasTable freegas_table;
 
 		AceIsotopeBase(const Ace::NeutronTable& _table, const ChildGrid* child_grid);
 
@@ -137,9 +150,78 @@ template<typename TypeReaction> class XsSampler;
 		 */
 		Reaction* getReaction(InternalId mt);
 
+		/* Get storage of the sampling tables */
+		const Arena* getArena() const {return arena;}
+
+		/* Approximate memory used by the isotope (in bytes) */
+		virtual size_t getMemory() const;
+
+		/*
+		 * Release the reactions of the ACE table, only the sampling objects are kept. After this call
+		 * only reactions already created can be requested with getReaction.
+		 */
+		void compact();
+
 		~AceIsotopeBase();
 	};
 
+	/*
+	 * ACE isotope at a temperature higher than the one of the data. The cross sections are Doppler
+	 * broadened once, on the energy grid of the isotope, when the object is created. The target
+	 * motion on elastic collisions is sampled at this temperature. The reactions are shared with
+	 * the original isotope.
+	 */
+	class AceIsotopeTemperature : public Isotope {
+		/* Isotope with the nuclear data */
+		const AceIsotopeBase* isotope;
+		/* Temperature (in MeV) */
+		double temperature;
+		/* Elastic reaction at this temperature */
+		Reaction* elastic_scattering;
+
+		/* Broadened cross sections (on the child grid of the isotope) */
+		std::vector<double> total_xs;
+		std::vector<double> absorption_xs;
+		std::vector<double> elastic_xs;
+		std::vector<double> fission_xs;
+
+		/* Interpolate a broadened cross section */
+		double getXs(Energy& energy, const std::vector<double>& xs) const;
+
+		/* Print isotope information */
+		void print(std::ostream& out) const;
+
+	public:
+
+		AceIsotopeTemperature(const AceIsotopeBase* isotope, double temperature);
+
+		/* Get temperature (in MeVs) */
+		double getTemperature() const {return temperature;}
+
+		/* Get isotope with the nuclear data */
+		const AceIsotopeBase* getIsotope() const {return isotope;}
+
+		/* Broadened cross sections */
+		double getTotalXs(Energy& energy) const {return getXs(energy, total_xs);}
+		double getFissionXs(Energy& energy) const {return fission_xs.empty() ? 0.0 : getXs(energy, fission_xs);}
+
+		/* Reaction probabilities */
+		double getAbsorptionProb(Energy& energy) const;
+		double getFissionProb(Energy& energy) const;
+		double getElasticProb(Energy& energy) const;
+		double getNuBar(const Energy& energy) const {return isotope->getNuBar(energy);}
+
+		/* Reactions */
+		Reaction* fission(Energy& energy, Random& random) const {return isotope->fission(energy, random);}
+		Reaction* elastic() const {return elastic_scattering ? elastic_scattering : isotope->elastic();}
+		Reaction* inelastic(Energy& energy, Random& random) const {return isotope->inelastic(energy, random);}
+
+		/* Memory used by the broadened cross sections (in bytes) */
+		size_t getMemory() const;
+
+		~AceIsotopeTemperature();
+	};
+
 	/*
 	 * Ace factory, this should create an ACE isotope with information obtained
 	 * from an ACE table.
@@ -147,6 +229,8 @@ template<typename TypeReaction> class XsSampler;
 	class AceIsotopeFactory {
 		/* Master grid */
 		MasterGrid* master_grid;
+		/* Create the isotope (the arena of the tables should be active) */
+		AceIsotopeBase* buildIsotope(const Ace::NeutronTable& table) const;
 	public:
 		AceIsotopeFactory(MasterGrid* master_grid) : master_grid(master_grid) {/* */}
 
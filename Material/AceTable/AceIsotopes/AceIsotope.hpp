@@ -54,6 +54,11 @@ public:
 		return FissionPolicy::getNuBar(energy);
 	}
 
+	/* Memory used by the isotope, including the fission data (in bytes) */
+	size_t getMemory() const {
+		return AceIsotopeBase::getMemory() + FissionPolicy::getMemory();
+	}
+
 	virtual ~AceIsotope() {};
 };
 
@@ -56,6 +56,9 @@ namespace Helios {
 		/* Get fission cross section */
 		double getFissionXs(Energy& energy) const;
 
+		/* Memory used by the fission cross section (in bytes) */
+		size_t getMemory() const {return fission_xs.getMemory();}
+
 		~FissilePolicyBase() {}
 	};
 
@@ -177,7 +180,15 @@ namespace Helios {
 	public:
 		/* Constructor from table */
 		NonFissile(AceIsotopeBase* _isotope, const Ace::NeutronTable& _table, const ChildGrid* _child_grid) :
-			FissilePolicyBase(_isotope, _table, _child_grid) {/* */};
+			FissilePolicyBase(_isotope, _table, _child_grid) {
+			/* There is no need to keep an array of zeros */
+			fission_xs = Ace::CrossSection();
+		};
+
+		/* Get fission cross section */
+		double getFissionXs(Energy& energy) const {
+			return 0.0;
+		}
 
 		/* Fission reaction */
 		Reaction* fission(Energy& energy, Random& random) const {
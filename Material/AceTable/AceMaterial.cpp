@@ -102,9 +102,25 @@ double AceMaterial::setIsotopeMap(string& type, map<string,double> isotopes_frac
 	return average_atomic;
 }
 
+/* Temperature of an isotope on this material */
+double AceMaterial::getIsotopeTemperature(const AceIsotopeBase* isotope) const {
+	/* Temperature of the data */
+	double data_temperature = isotope->getTemperature();
+	if(temperature <= 0.0) return data_temperature;
+	/* Small differences are considered as the same temperature */
+	double tolerance = 1.0e-3 * data_temperature;
+	if(temperature < data_temperature - tolerance)
+		throw(Material::BadMaterialCreation(getUserId(),"Temperature lower than the one of the data of isotope " + isotope->getUserId()));
+	if(temperature <= data_temperature + tolerance) return data_temperature;
+	return temperature;
+}
+
 AceMaterial::AceMaterial(const AceMaterialObject* definition) : Material(definition)
 		,master_grid(definition->getEnvironment()->getModule<AceModule>()->getMasterGrid())
-		,total_xs(master_grid->size(),0.0) {
+		,total_xs(master_grid->size(),0.0), temperature(definition->temperature) {
+
+	/* ACE module with the isotopes */
+	AceModule* ace_module = definition->getEnvironment()->getModule<AceModule>();
 
 	/* Type of isotope fractions */
 	string type = definition->fraction;
@@ -115,7 +131,7 @@ AceMaterial::AceMaterial(const AceMaterialObject* definition) : Material(definit
 		throw(Material::BadMaterialCreation(getUserId(),"Material does not contain any isotope"));
 
 	/* Get isotope map from the ACE module */
-	map<string,AceIsotopeBase*> isotopes = definition->getEnvironment()->getModule<AceModule>()->getIsotopeMap();
+	map<string,AceIsotopeBase*> isotopes = ace_module->getIsotopeMap();
 
 	/* Get average atomic number and set the isotope map */
 	double average_atomic = setIsotopeMap(type, isotope_fraction, isotopes);
@@ -136,9 +152,11 @@ AceMaterial::AceMaterial(const AceMaterialObject* definition) : Material(definit
 	/* -- Setup the isotope sampler and the mean free path of the material */
 
 	/* Array for the isotope sampler */
-	vector<AceIsotopeBase*> isotope_array(isotope_map.size());
+	vector<Isotope*> isotope_array(isotope_map.size());
 	/* Container of fissile isotopes */
 	vector<AceIsotopeBase*> fissile_isotopes;
+	/* Broadened view of each fissile isotope (null at the temperature of the data) */
+	vector<const AceIsotopeTemperature*> fissile_broadened;
 	/* Arrays of XS of each isotope*/
 	vector<vector<double> > xs_array(isotope_map.size(), vector<double>(master_grid->size(),0.0));
 
@@ -149,24 +167,32 @@ AceMaterial::AceMaterial(const AceMaterialObject* definition) : Material(definit
 	for(; iso != isotope_map.end() ; ++iso) {
 		/* Get isotope */
 		AceIsotopeBase* ace_isotope = (*iso).second.isotope;
+		/* Temperature of the cross sections of this isotope on the material */
+		double isotope_temperature = getIsotopeTemperature(ace_isotope);
+		/* Push isotope to the array (broadened to the temperature of the material if necessary) */
+		AceIsotopeTemperature* broadened = 0;
+		if(isotope_temperature > ace_isotope->getTemperature()) {
+			broadened = ace_module->getBroadenedIsotope(ace_isotope, isotope_temperature);
+			isotope_array[counter] = broadened;
+		} else
+			isotope_array[counter] = ace_isotope;
 		/* Check if there are fissile isotopes */
 		if(ace_isotope->isFissile()) {
 			/* Set the flag as true */
 			fissile = true;
 			/* Push the isotope in the container */
 			fissile_isotopes.push_back(ace_isotope);
+			fissile_broadened.push_back(broadened);
 		}
 		/* Get atomic density */
 		double density = (*iso).second.atomic_fraction * atom;
-		/* Push isotope to the array*/
-		isotope_array[counter] = ace_isotope;
 		/* Set the XS array for this isotope */
 		Energy energy(0,0.0);
 		for(size_t i = 0 ; i < master_grid->size() ; ++i) {
 			/* Set the energy and leave the index alone (faster interpolation) */
 			energy.second = (*master_grid)[i];
 			/* Set isotope cross section on this material */
-			double total = density * ace_isotope->getTotalXs(energy);
+			double total = density * (broadened ? broadened->getTotalXs(energy) : ace_isotope->getTotalXs(energy));
 			xs_array[counter][i] = total;
 			/* Contribution to the mean free path */
 			total_xs[i] += total;
@@ -176,7 +202,7 @@ AceMaterial::AceMaterial(const AceMaterialObject* definition) : Material(definit
 	}
 
 	/* Set the isotope sampler */
-	isotope_sampler = new FactorSampler<AceIsotopeBase*>(isotope_array, xs_array, false);
+	isotope_sampler = new FactorSampler<Isotope*>(isotope_array, xs_array, false);
 
 	/* If the material is fissile, we should construct the related cross sections */
 	if(isFissile()) {
@@ -191,11 +217,14 @@ AceMaterial::AceMaterial(const AceMaterialObject* definition) : Material(definit
 			/* Accumulated total NU-fission cross section */
 			double nu_fission = 0.0;
 			/* Loop over the fissile isotopes */
-			for(vector<AceIsotopeBase*>::const_iterator iso = fissile_isotopes.begin() ; iso != fissile_isotopes.end() ; ++iso) {
+			for(size_t j = 0 ; j < fissile_isotopes.size() ; ++j) {
+				AceIsotopeBase* iso = fissile_isotopes[j];
 				/* Get density (atomic) */
-				double density = (*isotope_map.find((*iso)->getUserId())).second.atomic_fraction * atom;
+				double density = (*isotope_map.find(iso->getUserId())).second.atomic_fraction * atom;
 				/* Accumulate NU-fission */
-				nu_fission += density * (*iso)->getNuBar(energy) * (*iso)->getFissionXs(energy);
+				const AceIsotopeTemperature* broadened = fissile_broadened[j];
+				double fission = broadened ? broadened->getFissionXs(energy) : iso->getFissionXs(energy);
+				nu_fission += density * iso->getNuBar(energy) * fission;
 			}
 			/* Setup NU-fission cross section */
 			nu_sigma_fission[i] = nu_fission;
@@ -233,6 +262,12 @@ const Isotope* AceMaterial::getIsotope(Energy& energy, Random& random) const {
 	return isotope_sampler->sample(idx,total * random.uniform(), factor);
 }
 
+size_t AceMaterial::getMemory() const {
+	size_t memory = (total_xs.capacity() + nu_sigma_fission.capacity() + nu_bar.capacity()) * sizeof(double);
+	memory += isotope_sampler->getMemory();
+	return memory;
+}
+
 AceMaterial::~AceMaterial() {
 	delete isotope_sampler;
 };
@@ -242,6 +277,9 @@ void AceMaterial::print(std::ostream& out) const {
 	/* Print material information */
 	out << Log::ident(1) << " - density = " << setw(9) << rho << " g/cm3 " << endl;
 	out << Log::ident(1) << " - density = " << setw(9) << atom << " atom/b-cm " << endl;
+	if(temperature > 0.0)
+		out << Log::ident(1) << " - temperature = " << setw(9) << temperature / Constant::boltz << " K " << endl;
+	out << Log::ident(1) << " - memory  = " << setw(9) << getMemory() / 1024 << " kB " << endl;
 	/* Print isotope information */
 	std::map<std::string,IsotopeData>::const_iterator iso = isotope_map.begin();
 	for(; iso != isotope_map.end() ; ++iso)
@@ -51,12 +51,15 @@ namespace Helios {
 		std::vector<double> nu_bar;
 
 		/* Isotope sampler */
-		FactorSampler<AceIsotopeBase*>* isotope_sampler;
+		FactorSampler<Isotope*>* isotope_sampler;
 
 		/* Density of the material */
 		double atom;   /* atom/b-cm*/
 		double rho;    /* g/cm3 */
 
+		/* Temperature of the material in MeVs (zero to use the temperature of the data) */
+		double temperature;
+
 		/* Data of an isotope contained in the material */
 		struct IsotopeData {
 			/* Mass fraction */
@@ -74,6 +77,9 @@ namespace Helios {
 		/* Set isotope map */
 		double setIsotopeMap(string& type, map<string,double> isotopes_fraction, const std::map<std::string,AceIsotopeBase*>& isotopes);
 
+		/* Temperature of the cross sections of an isotope on this material */
+		double getIsotopeTemperature(const AceIsotopeBase* isotope) const;
+
 		/* Map of isotopes with their respective data in this material */
 		std::map<std::string,IsotopeData> isotope_map;
 
@@ -109,6 +115,9 @@ namespace Helios {
 		/* Print material information */
 		void print(std::ostream& out) const;
 
+		/* Memory used by the tables of the material (in bytes) */
+		size_t getMemory() const;
+
 		~AceMaterial();
 	};
 
@@ -121,18 +130,21 @@ namespace Helios {
 		std::string fraction;
 		/* Map of isotopes and each percentage */
 		std::map<std::string,double> isotopes;
+		/* Temperature (in MeVs, zero to use the one of the data) */
+		double temperature;
 	public:
 		friend class AceMaterial;
 		friend class AceMaterialFactory;
 
 		AceMaterialObject(const std::string& id, const double& density, const std::string& units,
-				const std::string& fraction, const std::map<std::string,double>& isotopes) :
+				const std::string& fraction, const std::map<std::string,double>& isotopes, double temperature = 0.0) :
 			 MaterialObject(AceMaterial::name(),id)
 			,id(id)
 			,density(density)
 			,units(units)
 			,fraction(fraction)
 			,isotopes(isotopes)
+			,temperature(temperature)
 		{/* */}
 		~AceMaterialObject() {/* */};
 	};
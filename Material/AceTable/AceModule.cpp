@@ -31,6 +31,7 @@
 #include "AceReader/Conf.hpp"
 #include "AceReaction/AceReactionBase.hpp"
 #include "AceReaction/FissionReaction.hpp"
+#include "AceReaction/EnergyLaws/AceEnergyLaw.hpp"
 #include "../../Common/XsSampler.hpp"
 #include "../../Environment/McEnvironment.hpp"
 
@@ -48,6 +49,23 @@ AceModule::AceModule(const std::vector<McObject*>& aceObjects, const McEnvironme
 	/* Print information about the Ace reader */
 	Log::msg() << left << Log::ident(1) << " - Using xsdir from directory " << Ace::Conf::DATAPATH << Log::endl;
 
+	/* Sampling of the Maxwell, evaporation and Watt spectra */
+	if(environment->isSet("spectrum_points"))
+		AceReaction::AceEnergyLaw::spectrum_points = environment->getSetting<size_t>("spectrum_points","value");
+	if(AceReaction::AceEnergyLaw::spectrum_points)
+		Log::msg() << left << Log::ident(1) << " - Tabulated spectra of laws 7, 9 and 11 with "
+		           << AceReaction::AceEnergyLaw::spectrum_points << " points" << Log::endl;
+
+	/* Sampling of the target velocity on the free gas treatment */
+	if(environment->isSet("freegas_points")) {
+		size_t freegas_points = environment->getSetting<size_t>("freegas_points","value");
+		if(freegas_points)
+			AceIsotopeBase::freegas_table = AceReaction::FreeGasTable(freegas_points);
+	}
+	if(!AceIsotopeBase::freegas_table.empty())
+		Log::msg() << left << Log::ident(1) << " - Tabulated free gas target velocity with "
+		           << AceIsotopeBase::freegas_table.size() << " points" << Log::endl;
+
 	/* Create master grid */
 	master_grid = new MasterGrid();
 	/* Ace isotope factory */
@@ -79,6 +97,16 @@ AceModule::AceModule(const std::vector<McObject*>& aceObjects, const McEnvironme
 	/* Setup master grid */
 	master_grid->setup();
 
+	/* Remove points of the master grid where the cross sections of all isotopes are linear */
+	double tolerance = 0.0;
+	if(environment->isSet("grid_thinning"))
+		tolerance = environment->getSetting<double>("grid_thinning","value");
+	if(tolerance > 0.0) {
+		size_t removed = master_grid->thin(getGridValues(), tolerance);
+		Log::msg() << left << Log::ident(1) << " - Thinned master grid with a tolerance of " << tolerance
+				   << " (" << removed << " points removed, " << master_grid->size() << " left)" << Log::endl;
+	}
+
 	/* Update maps */
 	for(size_t i = 0; i < isotopes.size() ; ++i) {
 		/* Set internal / unique index */
@@ -90,6 +118,35 @@ AceModule::AceModule(const std::vector<McObject*>& aceObjects, const McEnvironme
 
 }
 
+vector<vector<double> > AceModule::getGridValues() const {
+	/*
+	 * Rows of each isotope on the container. The materials tabulate the total cross section and, for
+	 * fissile isotopes, the NU-fission cross section (the fission one is kept too). The average NU of a
+	 * material is the ratio of those two and is not checked by itself, it is not used on the transport.
+	 */
+	vector<size_t> rows(isotopes.size());
+	size_t nrows = 0;
+	for(size_t i = 0 ; i < isotopes.size() ; ++i) {
+		rows[i] = nrows;
+		nrows += isotopes[i]->isFissile() ? 3 : 1;
+	}
+
+	vector<vector<double> > values(nrows, vector<double>(master_grid->size()));
+	#pragma omp parallel for
+	for(int i = 0 ; i < (int)isotopes.size() ; ++i) {
+		for(size_t j = 0 ; j < master_grid->size() ; ++j) {
+			Energy energy(j, (*master_grid)[j]);
+			values[rows[i]][j] = isotopes[i]->getTotalXs(energy);
+			if(isotopes[i]->isFissile()) {
+				double fission = isotopes[i]->getFissionXs(energy);
+				values[rows[i] + 1][j] = fission;
+				values[rows[i] + 2][j] = isotopes[i]->getNuBar(energy) * fission;
+			}
+		}
+	}
+	return values;
+}
+
 template<>
 std::vector<AceIsotopeBase*> AceModule::getObject<AceIsotopeBase>(const UserId& id) const {
 	map<std::string,AceIsotopeBase*>::const_iterator iso = isotope_map.find(id);
@@ -102,14 +159,53 @@ std::vector<AceIsotopeBase*> AceModule::getObject<AceIsotopeBase>(const UserId&
 	}
 }
 
+AceIsotopeTemperature* AceModule::getBroadenedIsotope(const AceIsotopeBase* isotope, double temperature) {
+	AceIsotopeTemperature* broadened = 0;
+	/* The materials are created on parallel */
+	#pragma omp critical(broadened_isotopes)
+	{
+		BroadenedKey key(isotope->getUserId(), temperature);
+		map<BroadenedKey,AceIsotopeTemperature*>::const_iterator it = broadened_map.find(key);
+		if(it == broadened_map.end()) {
+			broadened = new AceIsotopeTemperature(isotope, temperature);
+			broadened_map[key] = broadened;
+		} else
+			broadened = (*it).second;
+	}
+	return broadened;
+}
+
+size_t AceModule::getMemory() const {
+	size_t memory = master_grid->getMemory();
+	for(vector<AceIsotopeBase*>::const_iterator it = isotopes.begin() ; it != isotopes.end() ; ++it)
+		memory += (*it)->getMemory();
+	for(map<BroadenedKey,AceIsotopeTemperature*>::const_iterator it = broadened_map.begin() ; it != broadened_map.end() ; ++it)
+		memory += (*it).second->getMemory();
+	return memory;
+}
+
+void AceModule::compact() {
+	size_t memory = getMemory();
+	for(vector<AceIsotopeBase*>::iterator it = isotopes.begin() ; it != isotopes.end() ; ++it)
+		(*it)->compact();
+	Log::msg() << left << Log::ident(1) << " - Compacted ACE data from " << memory / 1024 << " kB to "
+			   << getMemory() / 1024 << " kB" << Log::endl;
+}
+
 void AceModule::print(std::ostream& out) const {
 	out << " - Master grid size :" << master_grid->size() << endl;
+	out << " - Master grid memory :" << master_grid->getMemory() / 1024 << " kB" << endl;
 	for(map<IsotopeId,AceIsotopeBase*>::const_iterator it = isotope_map.begin() ; it != isotope_map.end() ; ++it)
 		out << " - " << *(*it).second << endl;
+	for(map<BroadenedKey,AceIsotopeTemperature*>::const_iterator it = broadened_map.begin() ; it != broadened_map.end() ; ++it)
+		out << " - " << *(*it).second << endl;
 	out << endl;
 }
 
 AceModule::~AceModule() {
+	/* Delete broadened isotopes (they refer to the data of the isotopes) */
+	for(map<BroadenedKey,AceIsotopeTemperature*>::iterator it = broadened_map.begin() ; it != broadened_map.end() ; ++it)
+		delete (*it).second;
 	/* Delete isotopes */
 	for(map<IsotopeId,AceIsotopeBase*>::iterator it = isotope_map.begin() ; it != isotope_map.end() ; ++it)
 		delete (*it).second;
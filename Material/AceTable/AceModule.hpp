@@ -52,6 +52,13 @@ namespace Helios {
 		/* Container of isotopes */
 		std::vector<AceIsotopeBase*> isotopes;
 
+		/* Isotopes broadened to a temperature, shared by all the materials at that temperature */
+		typedef std::pair<IsotopeId,double> BroadenedKey;
+		std::map<BroadenedKey,AceIsotopeTemperature*> broadened_map;
+
+		/* Cross sections of each isotope interpolated on the master grid by the materials */
+		std::vector<std::vector<double> > getGridValues() const;
+
 	public:
 		/* Name of the module */
 		static std::string name() {return "ace-table";}
@@ -85,6 +92,21 @@ namespace Helios {
 		/* Get master grid */
 		const MasterGrid* getMasterGrid() const {return master_grid;};
 
+		/*
+		 * Get an isotope broadened to a temperature (in MeV) higher than the one of the data. The
+		 * cross sections are broadened the first time a (isotope, temperature) pair is requested.
+		 */
+		AceIsotopeTemperature* getBroadenedIsotope(const AceIsotopeBase* isotope, double temperature);
+
+		/* Memory used by the master grid and the isotopes (in bytes) */
+		size_t getMemory() const;
+
+		/*
+		 * Release the data read from the ACE tables that is not needed to sample reactions. This
+		 * should be called once all the modules that request reactions to the isotopes are setup.
+		 */
+		void compact();
+
 		virtual ~AceModule();
 	};
 
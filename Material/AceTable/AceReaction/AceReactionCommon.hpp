@@ -32,6 +32,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "../AceModule.hpp"
 #include "../../../Common/Interpolate.hpp"
+#include "../../../Common/Arena.hpp"
 
 namespace Helios {
 
@@ -41,13 +42,17 @@ namespace AceReaction {
 
 	struct TabularDistribution {
 
+		/* Interpolation schemes */
+		enum Interpolation {histogram = 1, linlin = 2};
+
 		int iflag;                 /* 1 = histogram, 2 = lin-lin */
-		std::vector<double> out;   /* Outgoing values grid */
-		std::vector<double> pdf;   /* Probability density function */
-		std::vector<double> cdf;   /* Cumulative density function */
+		ArenaArray out;            /* Outgoing values grid */
+		ArenaArray pdf;            /* Probability density function */
+		ArenaArray cdf;            /* Cumulative density function */
+		GuideTable cdf_guide;      /* Guide table over the cumulative */
 
 		TabularDistribution(int iflag, const std::vector<double>& out, const std::vector<double>& pdf, const std::vector<double>& cdf) :
-			 iflag(iflag) ,out(out),pdf(pdf), cdf(cdf)
+			 iflag(iflag) ,out(out),pdf(pdf), cdf(cdf), cdf_guide(this->cdf.begin(), this->cdf.end())
 		{
 			/* Sanity check */
 			assert(out.size() == pdf.size());
@@ -58,7 +63,7 @@ namespace AceReaction {
 			/* Get random number */
 			double chi = random.uniform();
 			/* Sample the bin on the cumulative */
-			size_t idx = std::upper_bound(cdf.begin(), cdf.end(), chi) - cdf.begin() - 1;
+			size_t idx = cdf_guide.index(cdf.begin(), cdf.end(), chi);
 			/* Return outgoing value */
 			return getOutgoing(chi, idx);
 		}
@@ -67,18 +72,27 @@ namespace AceReaction {
 			/* Get random number */
 			double chi = random.uniform();
 			/* Sample the bin on the cumulative */
-			idx = std::upper_bound(cdf.begin(), cdf.end(), chi) - cdf.begin() - 1;
+			idx = cdf_guide.index(cdf.begin(), cdf.end(), chi);
 			/* Return outgoing value */
 			return getOutgoing(chi, idx);
 		}
 
 		double operator()(double chi, size_t& idx) const {
 			/* Sample the bin on the cumulative */
-			idx = std::upper_bound(cdf.begin(), cdf.end(), chi) - cdf.begin() - 1;
+			idx = cdf_guide.index(cdf.begin(), cdf.end(), chi);
 			/* Return outgoing value */
 			return getOutgoing(chi, idx);
 		}
 
+		/* Same as above, with the interpolation scheme known at compile time */
+		template<int Interpolation>
+		double sample(double chi, size_t& idx) const {
+			/* Sample the bin on the cumulative */
+			idx = cdf_guide.index(cdf.begin(), cdf.end(), chi);
+			/* Return outgoing value */
+			return getOutgoing<Interpolation>(chi, idx);
+		}
+
 		void print(std::ostream& sout) const {
 			sout << setw(15) << "out" << setw(15) << "pdf" << setw(15) << "cdf" << endl;
 			for(size_t i = 0 ; i < out.size() ; ++i)
@@ -88,29 +102,44 @@ namespace AceReaction {
 		virtual ~TabularDistribution() {/* */}
 
 	private:
+		/* Return outgoing value (for some interpolation scheme) */
+		template<int Interpolation>
+		double getOutgoing(double chi, size_t idx) const;
+
 		/* Return outgoing value */
-		double getOutgoing(double chi, size_t idx) const {
-			/* Histogram interpolation */
-			if(iflag == 1) {
-				/* Return cosine */
-				return out[idx] + (chi - cdf[idx]) / pdf[idx];
-			/* Linear-Linear interpolation */
-			} else if(iflag == 2) {
-				/* Auxiliary variables */
-				double g = (pdf[idx + 1] - pdf[idx]) / (out[idx + 1] - out[idx]);
-				double h = sqrt(pdf[idx] * pdf[idx] + 2*g*(chi - cdf[idx]));
-				/* Solve for cosine */
-				if(g == 0.0)
-					/* Just like the histogram distribution */
-					return out[idx] + (chi - cdf[idx]) / pdf[idx];
-				else
-					/* Interpolation */
-					return out[idx] + (1/g) * (h - pdf[idx]);
-			}
-			return 0.0;
-		}
+		double getOutgoing(double chi, size_t idx) const;
 	};
 
+	/* Histogram interpolation */
+	template<>
+	inline double TabularDistribution::getOutgoing<TabularDistribution::histogram>(double chi, size_t idx) const {
+		/* Return cosine */
+		return out[idx] + (chi - cdf[idx]) / pdf[idx];
+	}
+
+	/* Linear-Linear interpolation */
+	template<>
+	inline double TabularDistribution::getOutgoing<TabularDistribution::linlin>(double chi, size_t idx) const {
+		/* Auxiliary variables */
+		double g = (pdf[idx + 1] - pdf[idx]) / (out[idx + 1] - out[idx]);
+		double h = sqrt(pdf[idx] * pdf[idx] + 2*g*(chi - cdf[idx]));
+		/* Solve for cosine */
+		if(g == 0.0)
+			/* Just like the histogram distribution */
+			return out[idx] + (chi - cdf[idx]) / pdf[idx];
+		else
+			/* Interpolation */
+			return out[idx] + (1/g) * (h - pdf[idx]);
+	}
+
+	inline double TabularDistribution::getOutgoing(double chi, size_t idx) const {
+		if(iflag == histogram)
+			return getOutgoing<histogram>(chi, idx);
+		else if(iflag == linlin)
+			return getOutgoing<linlin>(chi, idx);
+		return 0.0;
+	}
+
 	/*
 	 * Class to sample a table using an energy grid. Table's *kind* is
 	 * arbitrary and should be specified as a template parameter.
@@ -130,22 +159,29 @@ namespace AceReaction {
 		}
 	protected:
 		/* A table contains an energy grid... */
-		std::vector<double> energies;
+		ArenaArray energies;
 		/* ... and a Table container */
 		std::vector<TableType> tables;
+		/* Guide table over the energy grid */
+		GuideTable energy_guide;
+		/* Set the energy grid (of incident energies) */
+		void setEnergies(const std::vector<double>& ein) {
+			energies = ArenaArray(ein);
+			energy_guide = GuideTable(energies.begin(), energies.end(), true);
+		}
 	public:
 		TableSampler() {/* */}
 		/* Sample table */
 		TableType sample(double energy, Random& random) const {
 			/* Get interpolation data */
-			std::pair<size_t,double> res = interpolate(energies.begin(), energies.end(), energy);
+			std::pair<size_t,double> res = interpolate(energies.begin(), energies.end(), energy, energy_guide);
 			/* Get table */
 			return getTable(energy, random, res);
 		}
 		/* Sample table and set interpolation data */
 		TableType sample(double energy, Random& random, std::pair<size_t,double>& res) const {
 			/* Get interpolation data */
-			res = interpolate(energies.begin(), energies.end(), energy);
+			res = interpolate(energies.begin(), energies.end(), energy, energy_guide);
 			/* Get table */
 			return getTable(energy, random, res);
 		}
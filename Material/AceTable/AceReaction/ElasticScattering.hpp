@@ -34,25 +34,48 @@ namespace Helios {
 
 namespace AceReaction {
 
+	/* Elastic scattering on a target with thermal motion */
+	class FreeGasScattering : public Reaction {
+	public:
+		FreeGasScattering(InternalId internal_id) : Reaction(internal_id) {/* */}
+
+		/* Change particle state, with the target at some temperature (in MeVs) */
+		virtual void scatter(Particle& particle, Random& random, double temperature) const = 0;
+
+		virtual ~FreeGasScattering() {/* */}
+	};
+
 	/*
 	 * Elastic scattering using free gas treatment
 	 *
+	 * The target velocity is sampled from the free gas table when it is available, otherwise
+	 * the rejection algorithm is used.
+	 *
 	 * The scattering cosine is always sampled on the CM system
 	 */
 	template<class MuSampling>
-	class ElasticScattering : public Reaction, public MuSampling {
+	class ElasticScattering : public FreeGasScattering, public MuSampling {
 		/* Atomic weight ratio */
 		double awr;
 		/* Temperature (in MeVs) */
 		double temperature;
 		/* Sample target velocity. */
-		void targetVelocity(double energy, Direction direction, Direction& velocity, Random& random) const;
+		void targetVelocity(double energy, double temperature, Direction direction, Direction& velocity, Random& random) const;
 	public:
-		ElasticScattering(const AceIsotopeBase* isotope, const Ace::NeutronReaction& ace_reaction) : Reaction(ace_reaction.getMt()),
+		ElasticScattering(const AceIsotopeBase* isotope, const Ace::NeutronReaction& ace_reaction) : FreeGasScattering(ace_reaction.getMt()),
 			MuSampling(ace_reaction.getAngular()), awr(isotope->getAwr()), temperature(isotope->getTemperature()) {/* */};
 
+		/* Construct from raw data, without an isotope (i.e. for benchmarks) */
+		ElasticScattering(double awr, double temperature, const Ace::AngularDistribution& ace_angular) : FreeGasScattering(2),
+			MuSampling(ace_angular), awr(awr), temperature(temperature) {/* */};
+
 		/* Change particle state */
-		void operator()(Particle& particle, Random& random) const;
+		void operator()(Particle& particle, Random& random) const {
+			scatter(particle, random, temperature);
+		}
+
+		/* Change particle state, with the target at some temperature (in MeVs) */
+		void scatter(Particle& particle, Random& random, double temperature) const;
 
 		void print(std::ostream& out) const;
 
@@ -60,7 +83,7 @@ namespace AceReaction {
 	};
 
 	template<class MuSampling>
-	void ElasticScattering<MuSampling>::targetVelocity(double energy, Direction direction, Direction& velocity, Random& random) const {
+	void ElasticScattering<MuSampling>::targetVelocity(double energy, double temperature, Direction direction, Direction& velocity, Random& random) const {
 		/* Compare to threshold criteria */
 		if ((energy > AceIsotopeBase::energy_freegas_threshold*temperature) && (awr > AceIsotopeBase::awr_freegas_threshold)) {
 			/* Target velocity insignificant, set components to zero */
@@ -68,41 +91,20 @@ namespace AceReaction {
 			return;
 		}
 
-		/*
-		 * Rejection algorithm extracted from MCNP5 manual. Samples target
-		 * energy z2/ar, cosine between target and neutron velocity c.
-		 */
+		/* Neutron speed (on units of the most probable speed of the target) */
 		double ar = awr/temperature;
 		double ycn = sqrt(energy*ar);
 
-		/* Auxiliary variables */
-		double r1, z2, rnd1, rnd2, s, x2, c;
-
-		/* Rejection sampling */
-		do {
-			if (random.uniform()*(ycn + 1.12837917) > ycn) {
-				r1 = random.uniform();
-				z2 = -log(r1*random.uniform());
-			}
-			else {
-				do {
-					rnd1 = random.uniform();
-					rnd2 = random.uniform();
-
-					r1 = rnd1*rnd1;
-					s = r1 + rnd2*rnd2;
-				}
-				while (s > 1.0);
-
-				z2 = -r1*log(s)/s - log(random.uniform());
-			}
-
-			double z = sqrt(z2);
-			c = 2.0*random.uniform() - 1.0;
-			x2 = ycn*ycn + z2 - 2*ycn*z*c;
-			rnd1 = random.uniform()*(ycn + z);
+		/* Sample target energy z2/ar, cosine between target and neutron velocity c */
+		double z2, c;
+		const FreeGasTable& table = AceIsotopeBase::freegas_table;
+		if (table.inside(ycn)) {
+			double z;
+			table.sample(ycn, random, z, c);
+			z2 = z*z;
 		}
-		while (rnd1*rnd1 > x2);
+		else
+			FreeGasTable::sampleRejection(ycn, random, z2, c);
 
 		/* Rotate direction cosines */
 		azimutalRotation(c, direction, random);
@@ -113,7 +115,7 @@ namespace AceReaction {
 	}
 
 	template<class MuSampling>
-	void ElasticScattering<MuSampling>::operator()(Particle& particle, Random& random) const {
+	void ElasticScattering<MuSampling>::scatter(Particle& particle, Random& random, double temperature) const {
 		/* Get initial energy on LAB system */
 		double particle_energy = particle.erg().second;
 
@@ -125,7 +127,7 @@ namespace AceReaction {
 
 		/* Sample initial target velocity */
 		Direction vt;
-		targetVelocity(particle_energy, particle.dir(), vt, random);
+		targetVelocity(particle_energy, temperature, particle.dir(), vt, random);
 
 		/* Calculate velocity of CM */
 		Direction vc = (vp + awr * vt) / (awr + 1.0);
@@ -161,6 +163,8 @@ namespace AceReaction {
 		out << " Elastic ACE reaction" << endl;
 		out << "  - awr = " << awr << endl;
 		out << "  - tmp = " << temperature << endl;
+		if (!AceIsotopeBase::freegas_table.empty())
+			out << "  - tabulated free gas (" << AceIsotopeBase::freegas_table.size() << " points)" << endl;
 	};
 
 }
@@ -30,6 +30,8 @@
 namespace Helios {
 namespace AceReaction {
 
+size_t AceEnergyLaw::spectrum_points = 0; /* By default, rejection sampling */
+
 std::ostream& operator<<(std::ostream& out, const AceEnergyLaw& q) {
 	out << " - " << q.name << endl;
 	q.print(out);
@@ -54,6 +54,9 @@ namespace AceReaction {
 		typedef Ace::EnergyDistribution::EnergyLaw Law;
 
 	public:
+		/* Points of the inverse cumulative of the spectrum laws (zero to use rejection sampling) */
+		static size_t spectrum_points;
+
 		AceEnergyLaw(const Law* energy_law) : name(energy_law->getLawName()) {/* */};
 
 		/* Get name of the law */
@@ -39,7 +39,7 @@ namespace AceReaction {
 	/* Sample outgoing energy using EquiProbable energy bins */
 	struct EnergyEquiBins  {
 		/* Outgoing energy values */
-		std::vector<double> out;
+		ArenaArray out;
 
 		EnergyEquiBins(const std::vector<double>& out) : out(out) {/* */}
 
@@ -66,6 +66,8 @@ namespace AceReaction {
 	class EnergyLaw1 : public EnergyOutgoingTabular<EnergyEquiBins> {
 		typedef Ace::EnergyDistribution::Law1 Law1;
 	public:
+		/* Number of the law */
+		static int number() {return 1;}
 		EnergyLaw1(const Law* ace_data);
 		~EnergyLaw1() {/* */}
 	};
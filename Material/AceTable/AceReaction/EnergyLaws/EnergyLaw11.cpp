@@ -34,6 +34,8 @@ namespace AceReaction {
 
 void EnergyLaw11::print(std::ostream& out) const {
 	out << " * Energy Dependent Watt Spectrum  " << endl;
+	if(!inverse_spectrum.empty())
+		out << "   (tabulated inverse cumulative, " << inverse_spectrum.size() << " points)" << endl;
 	out << "   a = " << endl;
 	for(size_t i = 0 ; i < eina.size() ; ++i)
 		out << eina[i] << " " << a[i] << endl;
@@ -28,8 +28,11 @@
 #ifndef ENERGYLAW11_HPP_
 #define ENERGYLAW11_HPP_
 
+#include <iterator>
+
 #include "../../../../Common/EndfInterpolate.hpp"
 #include "AceEnergyLaw.hpp"
+#include "InverseSpectrum.hpp"
 
 namespace Helios {
 namespace AceReaction {
@@ -46,29 +49,55 @@ namespace AceReaction {
 		/* Incident energy */
         std::vector<double> eina;
         std::vector<double> einb;
+        GuideTable eina_guide;
+        GuideTable einb_guide;
         /* Coefficients */
         std::vector<double> a;
         std::vector<double> b;
         /* Restriction energy */
         double u;
+        /* Inverse cumulative of the spectrum (optional) */
+        InverseSpectrum inverse_spectrum;
 	public:
+		/* Number of the law */
+		static int number() {return 11;}
         EnergyLaw11(const Law* ace_data) : AceEnergyLaw(ace_data),
         	endf_interpolate_a(cast(ace_data)->inta.nbt, cast(ace_data)->inta.aint),
         	endf_interpolate_b(cast(ace_data)->intb.nbt, cast(ace_data)->intb.aint),
         	eina(cast(ace_data)->eina), einb(cast(ace_data)->einb),
+        	eina_guide(eina.begin(), eina.end(), true), einb_guide(einb.begin(), einb.end(), true),
 			a(cast(ace_data)->a), b(cast(ace_data)->b), u(cast(ace_data)->u) {
 			/* Sanity check */
 			assert(eina.size() == a.size());
 			assert(einb.size() == b.size());
+			/* Tabulate the spectrum on the union of both incident grids */
+			if(spectrum_points) {
+				std::vector<double> ein;
+				std::set_union(eina.begin(), eina.end(), einb.begin(), einb.end(), std::back_inserter(ein));
+				inverse_spectrum = InverseSpectrum(ein, *this, spectrum_points);
+			}
         }
 
+		/* Spectrum on some incident energy */
+		double getMaxEnergy(double ienergy) const {return ienergy - u;}
+		double getPdf(double ienergy, double energy) const {
+			double acoeff = endf_interpolate_a.interpolate(eina.begin(), eina.end(), a.begin(), a.end(), ienergy, eina_guide);
+			double bcoeff = endf_interpolate_b.interpolate(einb.begin(), einb.end(), b.begin(), b.end(), ienergy, einb_guide);
+			return exp(-energy/acoeff) * sinh(sqrt(bcoeff*energy));
+		}
+
 		/* Sample scattering outgoing energy */
 		void setEnergy(const Particle& particle, Random& random, double& energy, double& mu) const {
 			/* Incident energy */
 			double ienergy(particle.getEnergy().second);
+			/* Sample from the table */
+			if(!inverse_spectrum.empty()) {
+				energy = inverse_spectrum.sample(ienergy, getMaxEnergy(ienergy), random.uniform());
+				return;
+			}
 			/* Get coefficients */
-			double acoeff = endf_interpolate_a.interpolate(eina.begin(), eina.end(), a.begin(), a.end(), ienergy);
-			double bcoeff = endf_interpolate_b.interpolate(einb.begin(), einb.end(), b.begin(), b.end(), ienergy);
+			double acoeff = endf_interpolate_a.interpolate(eina.begin(), eina.end(), a.begin(), a.end(), ienergy, eina_guide);
+			double bcoeff = endf_interpolate_b.interpolate(einb.begin(), einb.end(), b.begin(), b.end(), ienergy, einb_guide);
 
 		    /* Calculate constants */
 		    double c = 1.0 + acoeff*bcoeff/8.0;
@@ -40,6 +40,8 @@ namespace AceReaction {
 		double ldat1;
 		double ldat2;
 	public:
+		/* Number of the law */
+		static int number() {return 3;}
 		EnergyLaw3(const Law* ace_data) : AceEnergyLaw(ace_data) {
 			const Law3* law_data = dynamic_cast<const Law3*>(ace_data);
 			ldat1 = law_data->ldat1;
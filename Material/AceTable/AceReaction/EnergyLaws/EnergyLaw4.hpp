@@ -60,6 +60,8 @@ namespace AceReaction {
 	class EnergyLaw4 : public EnergyOutgoingTabular<EnergyTabular> {
 		typedef Ace::EnergyDistribution::Law4 Law4;
 	public:
+		/* Number of the law */
+		static int number() {return 4;}
 		EnergyLaw4(const Law* ace_data);
 		~EnergyLaw4() {/* */}
 	};
@@ -39,9 +39,9 @@ namespace AceReaction {
 	/* Sample outgoing energy using a tabular distribution */
 	class KalbachTabular : public TabularDistribution /* defined on AceReactionCommon.hpp */ {
 		/* Precompound fraction */
-		std::vector<double> r;
+		ArenaArray r;
 		/* Angular distribution slope */
-		std::vector<double> a;
+		ArenaArray a;
 	public:
 
 		KalbachTabular(const Ace::EnergyDistribution::Law44::EnergyData& ace_energy) :
@@ -90,6 +90,8 @@ namespace AceReaction {
 	class EnergyLaw44 : public EnergyOutgoingTabular<KalbachTabular> /* Defined on EnergyTabular.hpp */ {
 		typedef Ace::EnergyDistribution::Law44 Law44;
 	public:
+		/* Number of the law */
+		static int number() {return 44;}
 		EnergyLaw44(const Law* ace_data);
 		~EnergyLaw44() {/* */}
 	};
@@ -74,7 +74,7 @@ namespace AceReaction {
 					cosine = cosine_table[idx + 1];
 			}
 			/* Once we got the table, sample the scattering cosine */
-			mu = (*cosine)(random);
+			mu = cosine->sample(random);
 		}
 
 		void print(std::ostream& sout) const {
@@ -92,6 +92,8 @@ namespace AceReaction {
 	class EnergyLaw61 : public EnergyOutgoingTabular<AngularTabular> {
 		typedef Ace::EnergyDistribution::Law61 Law61;
 	public:
+		/* Number of the law */
+		static int number() {return 61;}
 		EnergyLaw61(const Law* ace_data);
 		~EnergyLaw61() {/* */}
 	};
@@ -49,6 +49,8 @@ namespace AceReaction {
 		/* Atomic weight ratio of the original target nucleus */
 		double awr;
 	public:
+		/* Number of the law */
+		static int number() {return 66;}
         EnergyLaw66(const Law* ace_data, double q, double awr) : AceEnergyLaw(ace_data),
         	npxs(cast(ace_data)->npxs), ap(cast(ace_data)->ap), q(q), awr(awr) {/* */}
 
@@ -32,6 +32,8 @@ namespace AceReaction {
 
 void EnergyLaw7::print(std::ostream& out) const {
 	out << " * Maxwell Spectrum " << endl;
+	if(!inverse_spectrum.empty())
+		out << "   (tabulated inverse cumulative, " << inverse_spectrum.size() << " points)" << endl;
 	for(size_t i = 0 ; i < ein.size() ; ++i)
 		cout << ein[i] << " " << t[i] << endl;
 }
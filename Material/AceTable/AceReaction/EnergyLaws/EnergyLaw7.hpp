@@ -30,6 +30,7 @@
 
 #include "../../../../Common/EndfInterpolate.hpp"
 #include "AceEnergyLaw.hpp"
+#include "InverseSpectrum.hpp"
 
 namespace Helios {
 namespace AceReaction {
@@ -44,24 +45,44 @@ namespace AceReaction {
         EndfInterpolate endf_interpolate;
 		/* Incident energy */
         std::vector<double> ein;
+        GuideTable ein_guide;
         /* Temperature */
         std::vector<double> t;
         /* Restriction energy */
         double u;
+        /* Inverse cumulative of the spectrum (optional) */
+        InverseSpectrum inverse_spectrum;
 	public:
+		/* Number of the law */
+		static int number() {return 7;}
 		EnergyLaw7(const Law* ace_data) : AceEnergyLaw(ace_data),
 			endf_interpolate(cast(ace_data)->int_sch.nbt, cast(ace_data)->int_sch.aint), ein(cast(ace_data)->ein),
-			t(cast(ace_data)->t), u(cast(ace_data)->u) {
+			ein_guide(ein.begin(), ein.end(), true), t(cast(ace_data)->t), u(cast(ace_data)->u) {
 			/* Sanity check */
 			assert(ein.size() == t.size());
+			/* Tabulate the spectrum */
+			if(spectrum_points)
+				inverse_spectrum = InverseSpectrum(ein, *this, spectrum_points);
+		}
+
+		/* Spectrum on some incident energy */
+		double getMaxEnergy(double ienergy) const {return ienergy - u;}
+		double getPdf(double ienergy, double energy) const {
+			double temp = endf_interpolate.interpolate(ein.begin(), ein.end(), t.begin(), t.end(), ienergy, ein_guide);
+			return sqrt(energy) * exp(-energy/temp);
 		}
 
 		/* Sample scattering outgoing energy */
 		void setEnergy(const Particle& particle, Random& random, double& energy, double& mu) const {
 			/* Incident energy */
 			double ienergy(particle.getEnergy().second);
+			/* Sample from the table */
+			if(!inverse_spectrum.empty()) {
+				energy = inverse_spectrum.sample(ienergy, getMaxEnergy(ienergy), random.uniform());
+				return;
+			}
 			/* Get temperature */
-			double temp = endf_interpolate.interpolate(ein.begin(), ein.end(), t.begin(), t.end(), ienergy);
+			double temp = endf_interpolate.interpolate(ein.begin(), ein.end(), t.begin(), t.end(), ienergy, ein_guide);
 			/* Auxiliary variables */
 			double rnd1(0.0), rnd2(0.0), c(0.0);
 			/* Sample outgoing energy */
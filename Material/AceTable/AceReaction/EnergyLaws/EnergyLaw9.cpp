@@ -34,6 +34,8 @@ namespace AceReaction {
 
 void EnergyLaw9::print(std::ostream& out) const {
 	out << " * Evaporation Spectrum " << endl;
+	if(!inverse_spectrum.empty())
+		out << "   (tabulated inverse cumulative, " << inverse_spectrum.size() << " points)" << endl;
 	for(size_t i = 0 ; i < ein.size() ; ++i)
 		out << ein[i] << " " << t[i] << endl;
 }
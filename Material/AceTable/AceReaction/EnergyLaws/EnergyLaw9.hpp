@@ -30,6 +30,7 @@
 
 #include "../../../../Common/EndfInterpolate.hpp"
 #include "AceEnergyLaw.hpp"
+#include "InverseSpectrum.hpp"
 
 namespace Helios {
 namespace AceReaction {
@@ -44,16 +45,31 @@ namespace AceReaction {
         EndfInterpolate endf_interpolate;
 		/* Incident energy */
         std::vector<double> ein;
+        GuideTable ein_guide;
         /* Temperature */
         std::vector<double> t;
         /* Restriction energy */
         double u;
+        /* Inverse cumulative of the spectrum (optional) */
+        InverseSpectrum inverse_spectrum;
 	public:
+		/* Number of the law */
+		static int number() {return 9;}
 		EnergyLaw9(const Law* ace_data) : AceEnergyLaw(ace_data),
 			endf_interpolate(cast(ace_data)->int_sch.nbt, cast(ace_data)->int_sch.aint), ein(cast(ace_data)->ein),
-			t(cast(ace_data)->t), u(cast(ace_data)->u) {
+			ein_guide(ein.begin(), ein.end(), true), t(cast(ace_data)->t), u(cast(ace_data)->u) {
 			/* Sanity check */
 			assert(ein.size() == t.size());
+			/* Tabulate the spectrum */
+			if(spectrum_points)
+				inverse_spectrum = InverseSpectrum(ein, *this, spectrum_points);
+		}
+
+		/* Spectrum on some incident energy */
+		double getMaxEnergy(double ienergy) const {return ienergy - u;}
+		double getPdf(double ienergy, double energy) const {
+			double temp = endf_interpolate.interpolate(ein.begin(), ein.end(), t.begin(), t.end(), ienergy, ein_guide);
+			return energy * exp(-energy/temp);
 		}
 
 		/* Sample scattering outgoing energy */
@@ -61,12 +77,17 @@ namespace AceReaction {
 			/* Incident energy */
 			double ienergy(particle.getEnergy().second);
 			/* Get temperature */
-			double temp = endf_interpolate.interpolate(ein.begin(), ein.end(), t.begin(), t.end(), ienergy);
+			double temp = endf_interpolate.interpolate(ein.begin(), ein.end(), t.begin(), t.end(), ienergy, ein_guide);
 		    /* Check for low sampling efficiency */
 		    if (ienergy - u < 0.01*temp) {
 				energy = ienergy - u;
 				return;
 		    }
+			/* Sample from the table */
+			if(!inverse_spectrum.empty()) {
+				energy = inverse_spectrum.sample(ienergy, getMaxEnergy(ienergy), random.uniform());
+				return;
+			}
 		    /* Sample energy (p. 2-44 in MCNP4C manual) */
 		    do {
 		    	energy = -temp*log(random.uniform()*random.uniform());
@@ -46,10 +46,6 @@ namespace AceReaction {
 		using TableSampler<Table*>::tables;
 		using TableSampler<Table*>::energies;
 	protected:
-		/* Set the energy grid (of incident energies) */
-		void setEnergies(const std::vector<double>& ein) {
-			energies = ein;
-		}
 		/* Push data on the outgoing table */
 		template<class TableData>
 		void pushTable(const TableData& table_data) {
@@ -0,0 +1,211 @@
+/*
+ Copyright (c) 2012, Esteban Pellegrino
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright
+ notice, this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+ * Neither the name of the <organization> nor the
+ names of its contributors may be used to endorse or promote products
+ derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef INVERSESPECTRUM_HPP_
+#define INVERSESPECTRUM_HPP_
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include "../../../../Common/Interpolate.hpp"
+
+namespace Helios {
+
+namespace AceReaction {
+
+	/*
+	 * Tabulated inverse cumulative of a continuous outgoing energy spectrum (i.e. Maxwell,
+	 * evaporation or Watt) on an incident energy grid. A sample is a linear interpolation on
+	 * (incident energy, random number) using one random number, instead of a rejection loop.
+	 *
+	 * The rows are kept on the scaled variable E'/Emax(E), which changes slowly with the incident
+	 * energy (the raw outgoing energy does not, i.e. close to the threshold of the reaction), and
+	 * the grid of the law is refined until the linear interpolation between two rows agrees with
+	 * the row computed on the middle point.
+	 *
+	 * The Spectrum class should define the following methods :
+	 *  - double getMaxEnergy(double ienergy) const : Upper bound of the outgoing energy
+	 *  - double getPdf(double ienergy, double energy) const : Spectrum (non normalized)
+	 */
+	class InverseSpectrum {
+		/* Incident energies */
+		std::vector<double> ein;
+		GuideTable ein_guide;
+		/* Number of points on each inverse cumulative */
+		size_t npoints;
+		/* Scaled outgoing energies (one row of npoints for each incident energy) */
+		std::vector<double> table;
+
+		/* Number of points used to integrate the spectrum */
+		static const size_t nfine = 8192;
+		/* Maximum number of bisections of an interval of the original grid */
+		static const size_t max_depth = 8;
+
+		/* Interpolate a row of the table */
+		double getOutgoing(size_t nerg, size_t k, double t) const {
+			const double* row = &table[nerg * npoints];
+			return row[k] + t * (row[k + 1] - row[k]);
+		}
+
+		/* Inverse cumulative of the spectrum on some incident energy (zero below the threshold) */
+		template<class Spectrum>
+		void setRow(const Spectrum& spectrum, double energy, std::vector<double>& row) const {
+			row.assign(npoints, 0.0);
+			double emax = spectrum.getMaxEnergy(energy);
+			if(emax <= 0.0) return;
+
+			/* Cumulative (trapezoidal rule) on a grid that gets finer near zero, where the spectra peak */
+			std::vector<double> xout(nfine), cdf(nfine);
+			xout[0] = 0.0;
+			cdf[0] = 0.0;
+			double last_pdf = spectrum.getPdf(energy, 0.0);
+			for(size_t j = 1 ; j < nfine ; ++j) {
+				double x = (double)j / (double)(nfine - 1);
+				xout[j] = x * x * x;
+				double pdf = spectrum.getPdf(energy, emax * xout[j]);
+				cdf[j] = cdf[j - 1] + 0.5 * (pdf + last_pdf) * (xout[j] - xout[j - 1]);
+				last_pdf = pdf;
+			}
+			double total = cdf[nfine - 1];
+			if(total <= 0.0) return;
+
+			/* Invert the cumulative, the points are closer near one (on the tail of the spectrum) */
+			for(size_t k = 0 ; k < npoints ; ++k) {
+				double s = 1.0 - (double)k / (double)(npoints - 1);
+				double chi = total * (1.0 - s * s);
+				size_t j = std::upper_bound(cdf.begin(), cdf.end(), chi) - cdf.begin() - 1;
+				j = std::min(j, nfine - 2);
+				double delta = cdf[j + 1] - cdf[j];
+				row[k] = xout[j];
+				if(delta > 0.0)
+					row[k] += (chi - cdf[j]) * (xout[j + 1] - xout[j]) / delta;
+			}
+		}
+
+		/* Append the rows between two incident energies (the upper one is not included) */
+		template<class Spectrum>
+		void refine(const Spectrum& spectrum, double low, const std::vector<double>& row_low,
+				    double high, const std::vector<double>& row_high, size_t depth) {
+			double middle = 0.5 * (low + high);
+			bool split = false;
+			std::vector<double> row_middle;
+			if(depth < max_depth && middle > low && middle < high) {
+				setRow(spectrum, middle, row_middle);
+				for(size_t k = 0 ; k < npoints ; ++k) {
+					double linear = 0.5 * (row_low[k] + row_high[k]);
+					if(fabs(row_middle[k] - linear) > 1e-3 * row_middle[k] + 1e-9) {
+						split = true;
+						break;
+					}
+				}
+			}
+			if(split) {
+				refine(spectrum, low, row_low, middle, row_middle, depth + 1);
+				refine(spectrum, middle, row_middle, high, row_high, depth + 1);
+			} else {
+				ein.push_back(low);
+				table.insert(table.end(), row_low.begin(), row_low.end());
+			}
+		}
+
+	public:
+		InverseSpectrum() : npoints(0) {/* */}
+
+		template<class Spectrum>
+		InverseSpectrum(const std::vector<double>& grid, const Spectrum& spectrum, size_t npoints) :
+			npoints(std::max(npoints, (size_t)2)) {
+			if(grid.empty()) return;
+			std::vector<double> row_low, row_high;
+			setRow(spectrum, grid[0], row_low);
+			for(size_t i = 1 ; i < grid.size() ; ++i) {
+				double low = grid[i - 1];
+				double high = grid[i];
+				setRow(spectrum, high, row_high);
+				if(spectrum.getMaxEnergy(low) <= 0.0 && spectrum.getMaxEnergy(high) > 0.0) {
+					/* The threshold is inside the interval, put a point just above it */
+					double threshold = high;
+					double below = low;
+					for(size_t n = 0 ; n < 64 ; ++n) {
+						double middle = 0.5 * (below + threshold);
+						if(middle <= below || middle >= threshold) break;
+						if(spectrum.getMaxEnergy(middle) > 0.0) threshold = middle;
+						else below = middle;
+					}
+					ein.push_back(low);
+					table.insert(table.end(), row_low.begin(), row_low.end());
+					low = threshold;
+					setRow(spectrum, low, row_low);
+				}
+				if(spectrum.getMaxEnergy(high) > 0.0)
+					refine(spectrum, low, row_low, high, row_high, 0);
+				else {
+					ein.push_back(low);
+					table.insert(table.end(), row_low.begin(), row_low.end());
+				}
+				row_low.swap(row_high);
+			}
+			ein.push_back(grid.back());
+			table.insert(table.end(), row_low.begin(), row_low.end());
+			ein_guide = GuideTable(ein.begin(), ein.end(), true);
+		}
+
+		/* Check if the table was built */
+		bool empty() const {return table.empty();}
+
+		/*
+		 * Sample an outgoing energy with an uniform random number on [0,1], the maximum energy
+		 * of the spectrum on the incident energy rescales the row of the table.
+		 */
+		double sample(double energy, double emax, double chi) const {
+			/* Position on the rows of the table */
+			double s = (1.0 - sqrt(1.0 - chi)) * (double)(npoints - 1);
+			size_t k = std::min((size_t)s, npoints - 2);
+			double t = s - (double)k;
+			if(ein.size() == 1)
+				return emax * getOutgoing(0, k, t);
+			/* Interpolate between the incident energies */
+			std::pair<size_t,double> res = interpolate(ein.begin(), ein.end(), energy, ein_guide);
+			double low = getOutgoing(res.first, k, t);
+			double high = getOutgoing(res.first + 1, k, t);
+			return emax * (low + res.second * (high - low));
+		}
+
+		/* Number of points on each inverse cumulative */
+		size_t size() const {return npoints;}
+
+		/* Number of incident energies on the table */
+		size_t energies() const {return ein.size();}
+
+		~InverseSpectrum() {/* */}
+	};
+
+} /* namespace AceReaction */
+
+} /* namespace Helios */
+
+#endif /* INVERSESPECTRUM_HPP_ */
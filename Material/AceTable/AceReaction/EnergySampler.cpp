@@ -26,7 +26,6 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "EnergySampler.hpp"
-#include "EnergyLaws/EnergyLaws.hpp"
 
 using namespace std;
 
@@ -34,16 +34,22 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "../../../Transport/Particle.hpp"
 #include "../AceReader/EnergyDistribution.hpp"
 #include "../AceModule.hpp"
+#include "EnergyLaws/EnergyLaws.hpp"
 
 namespace Helios {
 
 namespace AceReaction {
 	/*
-	 * Base class to deal with energy samplers
+	 * Base class to deal with energy samplers.
+	 *
+	 * Each sampler is tagged with the number of the ACE law (zero if is not a single law), so the
+	 * sample method could switch on the law and call the (inlined) kernel instead of a virtual function.
 	 */
 	class EnergySamplerBase {
+		/* Number of the law */
+		int law;
 	public:
-		EnergySamplerBase() {/* */}
+		EnergySamplerBase(int law = 0) : law(law) {/* */}
 
 		/* Exception */
 		class BadEnergySamplerCreation : public std::exception {
@@ -61,6 +67,9 @@ namespace AceReaction {
 		/* Sample energy (and MU if information exists) using particle's information */
 		virtual void setEnergy(const Particle& particle, Random& random, double& energy, double& mu) const = 0;
 
+		/* Same as above (dispatch using the number of the law) */
+		inline void sample(const Particle& particle, Random& random, double& energy, double& mu) const;
+
 		/* Print internal data of the energy sampler */
 		virtual void print(std::ostream& out) const = 0;
 
@@ -85,16 +94,17 @@ namespace AceReaction {
 	public:
 		/* Constructor for using multiple laws */
 		template<class PolicyData>
-		EnergySampler(PolicyData ace_data) : LawPolicy(ace_data) {/* */}
+		EnergySampler(PolicyData ace_data) : EnergySamplerBase(LawPolicy::number()), LawPolicy(ace_data) {/* */}
 
 		/* Constructor for using multiple laws (and additional parameters) */
 		template<class PolicyData, class Additional>
-		EnergySampler(PolicyData ace_data, Additional additional) : LawPolicy(ace_data, additional) {/* */}
+		EnergySampler(PolicyData ace_data, Additional additional) :
+			EnergySamplerBase(LawPolicy::number()), LawPolicy(ace_data, additional) {/* */}
 
 		/* Constructor for using multiple laws (and additional parameters) */
 		template<class PolicyData, class Additional1, class Additional2>
 		EnergySampler(PolicyData ace_data, Additional1 additional1, Additional2 additional2) :
-			LawPolicy(ace_data, additional1, additional2) {/* */}
+			EnergySamplerBase(LawPolicy::number()), LawPolicy(ace_data, additional1, additional2) {/* */}
 
 		/* -- Overload base classes of the energy sampler */
 
@@ -163,11 +173,11 @@ namespace AceReaction {
 			for( ; it != law_table.end() - 1 ; ++it) {
 				chi -= (*it).getProbability(particle.getEnergy().second);
 				if(chi <= 0.0) {
-					(*it).energy_law->setEnergy(particle, random, energy, mu);
+					(*it).energy_law->sample(particle, random, energy, mu);
 					return;
 				}
 			}
-			(*it).energy_law->setEnergy(particle, random, energy, mu);
+			(*it).energy_law->sample(particle, random, energy, mu);
 		}
 
 		/* Print internal data of the energy sampler */
@@ -175,6 +185,27 @@ namespace AceReaction {
 
 		~MultipleLawsSampler() {/* */}
 	};
+
+	/* Call the kernel of a single law sampler */
+	template<class LawPolicy>
+	static inline void sampleLaw(const EnergySamplerBase* sampler, const Particle& particle, Random& random, double& energy, double& mu) {
+		static_cast<const EnergySampler<LawPolicy>*>(sampler)->LawPolicy::setEnergy(particle, random, energy, mu);
+	}
+
+	inline void EnergySamplerBase::sample(const Particle& particle, Random& random, double& energy, double& mu) const {
+		switch(law) {
+		case 1: sampleLaw<EnergyLaw1>(this, particle, random, energy, mu); break;
+		case 3: sampleLaw<EnergyLaw3>(this, particle, random, energy, mu); break;
+		case 4: sampleLaw<EnergyLaw4>(this, particle, random, energy, mu); break;
+		case 7: sampleLaw<EnergyLaw7>(this, particle, random, energy, mu); break;
+		case 9: sampleLaw<EnergyLaw9>(this, particle, random, energy, mu); break;
+		case 11: sampleLaw<EnergyLaw11>(this, particle, random, energy, mu); break;
+		case 44: sampleLaw<EnergyLaw44>(this, particle, random, energy, mu); break;
+		case 61: sampleLaw<EnergyLaw61>(this, particle, random, energy, mu); break;
+		case 66: sampleLaw<EnergyLaw66>(this, particle, random, energy, mu); break;
+		default: setEnergy(particle, random, energy, mu); break;
+		}
+	}
 }
 
 }
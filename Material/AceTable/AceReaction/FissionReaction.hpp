@@ -113,17 +113,18 @@ namespace AceReaction {
 			EndfInterpolate endf_scheme; /* ENDF interpolate scheme */
 			std::vector<double> energy;  /* Energy points */
 			std::vector<double> prob;    /* Tabulated probability */
+			GuideTable energy_guide;     /* Guide table over the energy points */
 
 			/* Initialize from data obtained from ACE table */
 			PrecursorProbability(const Ace::DLYBlock::BasicData& data) : endf_scheme(data.nbt, data.aint),
-					energy(data.energies), prob(data.prob) {
+					energy(data.energies), prob(data.prob), energy_guide(energy.begin(), energy.end(), true) {
 				/* Sanity check */
 				assert(energy.size() == prob.size());
 			};
 
 			/* Interpolate and get probability */
 			double getProb(double ienergy) const {
-				return endf_scheme.interpolate(energy.begin(), energy.end(), prob.begin(), prob.end(), ienergy);
+				return endf_scheme.interpolate(energy.begin(), energy.end(), prob.begin(), prob.end(), ienergy, energy_guide);
 			}
 
 			~PrecursorProbability() {};
@@ -163,7 +164,7 @@ namespace AceReaction {
 		void operator()(Particle& particle, Random& random) const {
 			/* Sample new energy */
 			double energy, mu;
-			getSampler(particle.erg(), random)->setEnergy(particle, random, energy, mu);
+			getSampler(particle.erg(), random)->sample(particle, random, energy, mu);
 			/* Set new direction (assume isotropic) */
 			isotropicDirection(particle.dir(), random);
 			/* Set new energy */
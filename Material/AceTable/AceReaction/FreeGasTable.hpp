@@ -0,0 +1,243 @@
+/*
+ Copyright (c) 2012, Esteban Pellegrino
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright
+ notice, this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+ * Neither the name of the <organization> nor the
+ names of its contributors may be used to endorse or promote products
+ derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FREEGASTABLE_HPP_
+#define FREEGASTABLE_HPP_
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include "../../../Common/Common.hpp"
+
+namespace Helios {
+
+namespace AceReaction {
+
+	/*
+	 * Sampling of the target velocity on the free gas treatment. Speeds are on units of the most probable
+	 * speed of the target (sqrt(kT/awr)), y is the neutron speed and z the target speed.
+	 *
+	 * The joint distribution of (z,c), where c is the cosine between both velocities, only depends on y. The
+	 * table stores the inverse cumulative of the marginal on z for a grid of y values, so it is shared by
+	 * all isotopes and temperatures. The cosine is sampled exactly from the conditional, the relative
+	 * speed cubed is uniform between |y - z|^3 and (y + z)^3. Neutron speeds beyond the table use the
+	 * rejection algorithm.
+	 *
+	 * Near zero the cumulative goes like z^3 (or z^4 for a neutron at rest), so the first intervals of each
+	 * row interpolate z^p instead of z (which is exact for a power law).
+	 */
+	class FreeGasTable {
+		/* Number of rows (neutron speeds) */
+		size_t nrows;
+		/* Number of points on each inverse cumulative */
+		size_t npoints;
+		/* Target speeds (one row of npoints for each neutron speed) */
+		std::vector<double> table;
+		/* Exponent of the cumulative on the first intervals of each row */
+		std::vector<double> power;
+
+		/* Largest neutron speed on the table (the rejection is efficient beyond it) */
+		static double ymax() {return 100.0;}
+		/* Maximum target speed (the tail beyond is negligible) */
+		static double zmax() {return 6.0;}
+		/* Number of points used to integrate the marginal */
+		static const size_t nfine = 8192;
+		/* Number of intervals near zero interpolated with the power law */
+		static const size_t nlow = 4;
+
+		/* Rows are uniform on y / (1 + y) */
+		static double getSpeed(size_t nrow, size_t nrows) {
+			double u = (ymax() / (1.0 + ymax())) * (double)nrow / (double)(nrows - 1);
+			return u / (1.0 - u);
+		}
+
+		/* Marginal distribution of the target speed (non normalized) */
+		static double getPdf(double y, double z) {
+			if(z == 0.0) return 0.0;
+			double rel = (y < z) ? 6.0 * z * z + 2.0 * y * y : (6.0 * y * y * z + 2.0 * z * z * z) / y;
+			return z * exp(-z * z) * rel;
+		}
+
+		/* Linear interpolation of the cumulative on the fine grid */
+		static double getCumulative(const std::vector<double>& cdf, double value) {
+			double r = value / zmax() * (double)(nfine - 1);
+			size_t j = std::min((size_t)r, nfine - 2);
+			double t = r - (double)j;
+			return cdf[j] + t * (cdf[j + 1] - cdf[j]);
+		}
+
+		/* Interpolate a row of the table */
+		double getTarget(size_t nrow, size_t k, double t) const {
+			const double* row = &table[nrow * npoints];
+			return row[k] + t * (row[k + 1] - row[k]);
+		}
+
+		/* Power law interpolation of a row (u is the fraction of the cumulative on the interval) */
+		double getLow(size_t nrow, size_t k, double u) const {
+			const double* row = &table[nrow * npoints];
+			double p = power[nrow];
+			double low = pow(row[k], p);
+			return pow(low + u * (pow(row[k + 1], p) - low), 1.0 / p);
+		}
+
+	public:
+		FreeGasTable() : nrows(0), npoints(0) {/* */}
+
+		/* Table with npoints neutron speeds and npoints on each inverse cumulative */
+		FreeGasTable(size_t npoints) : nrows(std::max(npoints, (size_t)2)), npoints(std::max(npoints, (size_t)2)),
+			table(nrows * this->npoints, 0.0), power(nrows, 1.0) {
+			std::vector<double> z(nfine), cdf(nfine);
+			for(size_t j = 0 ; j < nfine ; ++j)
+				z[j] = zmax() * (double)j / (double)(nfine - 1);
+			for(size_t i = 0 ; i < nrows ; ++i) {
+				double* row = &table[i * this->npoints];
+				double y = getSpeed(i, nrows);
+
+				/* Cumulative (trapezoidal rule) */
+				cdf[0] = 0.0;
+				double last_pdf = getPdf(y, z[0]);
+				for(size_t j = 1 ; j < nfine ; ++j) {
+					double pdf = getPdf(y, z[j]);
+					cdf[j] = cdf[j - 1] + 0.5 * (pdf + last_pdf) * (z[j] - z[j - 1]);
+					last_pdf = pdf;
+				}
+				double total = cdf[nfine - 1];
+
+				/* Invert the cumulative, the points are closer near one (on the tail of the distribution) */
+				for(size_t k = 0 ; k < this->npoints ; ++k) {
+					double s = 1.0 - (double)k / (double)(this->npoints - 1);
+					double chi = total * (1.0 - s * s);
+					size_t j = std::upper_bound(cdf.begin(), cdf.end(), chi) - cdf.begin() - 1;
+					j = std::min(j, nfine - 2);
+					double delta = cdf[j + 1] - cdf[j];
+					row[k] = z[j];
+					if(delta > 0.0)
+						row[k] += (chi - cdf[j]) * (z[j + 1] - z[j]) / delta;
+				}
+
+				/* Local exponent of the cumulative, from its values at the first point and half of it */
+				double first = getCumulative(cdf, row[1]);
+				double half = getCumulative(cdf, 0.5 * row[1]);
+				if(first > 0.0 && half > 0.0 && first > half)
+					power[i] = log(first / half) / log(2.0);
+			}
+		}
+
+		/* Check if the table was built */
+		bool empty() const {return table.empty();}
+
+		/* Check if a neutron speed is inside the table */
+		bool inside(double y) const {return !table.empty() && y < ymax();}
+
+		/* Number of points on each inverse cumulative */
+		size_t size() const {return npoints;}
+
+		/*
+		 * Sample target speed (z) and cosine (c) for a neutron speed y inside the table. Two random
+		 * numbers are used, no matter the value of y.
+		 */
+		void sample(double y, Random& random, double& z, double& c) const {
+			/* Position on the neutron speeds */
+			double r = (y / (1.0 + y)) / (ymax() / (1.0 + ymax())) * (double)(nrows - 1);
+			size_t i = std::min((size_t)r, nrows - 2);
+			double f = r - (double)i;
+			/* Position on the rows of the table */
+			double s = (1.0 - sqrt(1.0 - random.uniform())) * (double)(npoints - 1);
+			size_t k = std::min((size_t)s, npoints - 2);
+			double t = s - (double)k;
+			/* Interpolate between the neutron speeds */
+			double low, high;
+			if(k < nlow) {
+				/* Fraction of the cumulative on the interval */
+				double m = (double)(npoints - 1);
+				double a = 1.0 - (double)k / m, b = 1.0 - (double)(k + 1) / m, w = 1.0 - s / m;
+				double u = (a * a - w * w) / (a * a - b * b);
+				low = getLow(i, k, u);
+				high = getLow(i + 1, k, u);
+			} else {
+				low = getTarget(i, k, t);
+				high = getTarget(i + 1, k, t);
+			}
+			z = low + f * (high - low);
+			/* Sample the cosine from the relative speed */
+			double rnd = random.uniform();
+			if(y * z <= 0.0) {
+				c = 2.0 * rnd - 1.0;
+				return;
+			}
+			double rmin = fabs(y - z);
+			double rmax = y + z;
+			double rmin3 = rmin * rmin * rmin;
+			double rel = pow(rmin3 + rnd * (rmax * rmax * rmax - rmin3), 1.0 / 3.0);
+			c = (y * y + z * z - rel * rel) / (2.0 * y * z);
+			c = std::max(-1.0, std::min(1.0, c));
+		}
+
+		/*
+		 * Rejection algorithm extracted from MCNP5 manual. Samples target speed squared z2 and cosine
+		 * between target and neutron velocity c, for a neutron speed y.
+		 */
+		static void sampleRejection(double y, Random& random, double& z2, double& c) {
+			/* Auxiliary variables */
+			double r1, rnd1, rnd2, s, x2;
+
+			/* Rejection sampling */
+			do {
+				if (random.uniform()*(y + 1.12837917) > y) {
+					r1 = random.uniform();
+					z2 = -log(r1*random.uniform());
+				}
+				else {
+					do {
+						rnd1 = random.uniform();
+						rnd2 = random.uniform();
+
+						r1 = rnd1*rnd1;
+						s = r1 + rnd2*rnd2;
+					}
+					while (s > 1.0);
+
+					z2 = -r1*log(s)/s - log(random.uniform());
+				}
+
+				double z = sqrt(z2);
+				c = 2.0*random.uniform() - 1.0;
+				x2 = y*y + z2 - 2*y*z*c;
+				rnd1 = random.uniform()*(y + z);
+			}
+			while (rnd1*rnd1 > x2);
+		}
+
+		~FreeGasTable() {/* */}
+	};
+
+} /* namespace AceReaction */
+
+} /* namespace Helios */
+
+#endif /* FREEGASTABLE_HPP_ */
@@ -69,14 +69,14 @@ namespace AceReaction {
 		void sampleCosine(const Particle& particle, Random& random, double& mu) const {
 			/* Sample MU */
 			if(mu_sampler)
-				mu_sampler->setCosine(particle, random, mu);
+				mu_sampler->sample(particle, random, mu);
 		}
 
 		/* Sample energy distribution (and MU if is available on the energy distribution) */
 		void sampleEnergy(const Particle& particle, Random& random, double& energy, double& mu) const {
 			/* Sample energy */
 			if(energy_sampler)
-				energy_sampler->setEnergy(particle, random, energy, mu);
+				energy_sampler->sample(particle, random, energy, mu);
 		}
 
 	public:
@@ -48,19 +48,31 @@ namespace AceReaction {
 	typedef Ace::AngularDistribution::EquiBins AceEquiBins;
 	typedef Ace::AngularDistribution::Tabular AceTabular;
 
-	/* Base sampling table */
+	/*
+	 * Base sampling table.
+	 *
+	 * The set of tables is closed, so each one is tagged with its kind. The sample method
+	 * switches on the kind and calls the (inlined) kernel of the table, the virtual operator
+	 * is only used for tables of an unknown kind.
+	 */
 	class CosineTable {
 	public:
-		CosineTable() {/* */}
+		/* Kind of table */
+		enum Kind {isotropic, equibins, tabular_histogram, tabular_linlin, other};
+		CosineTable(Kind kind = other) : kind(kind) {/* */}
 		virtual double operator()(Random& random) const = 0;
+		/* Sample the scattering cosine (dispatch using the kind of table) */
+		inline double sample(Random& random) const;
 		virtual void print(std::ostream& out) const = 0;
 		virtual ~CosineTable() {/* */}
+	private:
+		Kind kind;
 	};
 
 	/* Sample isotropic scattering cosine */
 	class Isotropic : public CosineTable {
 	public:
-		Isotropic() {/* */}
+		Isotropic() : CosineTable(isotropic) {/* */}
 
 		double operator()(Random& random) const {
 			/* Return value */
@@ -77,9 +89,9 @@ namespace AceReaction {
 	/* Sample scattering cosine using 32 equiprobable bins */
 	class EquiBins : public CosineTable {
 		/* Cosine bins */
-		std::vector<double> bins;
+		ArenaArray bins;
 	public:
-		EquiBins(const AceEquiBins* ace_angular) :
+		EquiBins(const AceEquiBins* ace_angular) : CosineTable(equibins),
 			bins(ace_angular->bins)
 		{
 			/* Sanity check */
@@ -108,14 +120,28 @@ namespace AceReaction {
 	class Tabular : public CosineTable, public TabularDistribution /* defined on AceReactionCommon.hpp */ {
 	public:
 
-		Tabular(const AceTabular* ace_angular) :
+		Tabular(const AceTabular* ace_angular) : CosineTable(getKind(ace_angular->iflag)),
 			TabularDistribution(ace_angular->iflag, ace_angular->csout, ace_angular->pdf,ace_angular->cdf)
 		{/* */}
 
+		/* Kind of table for some interpolation scheme */
+		static Kind getKind(int iflag) {
+			if(iflag == histogram) return tabular_histogram;
+			else if(iflag == linlin) return tabular_linlin;
+			return other;
+		}
+
 		double operator()(Random& random) const {
 			return TabularDistribution::operator()(random);
 		}
 
+		/* Sample with the interpolation scheme known at compile time */
+		template<int Interpolation>
+		double sample(Random& random) const {
+			size_t idx;
+			return TabularDistribution::sample<Interpolation>(random.uniform(), idx);
+		}
+
 		void print(std::ostream& out) const {
 			out << " * Tabular Cosine distribution " << endl;
 			TabularDistribution::print(out);
@@ -124,17 +150,38 @@ namespace AceReaction {
 		~Tabular() {/* */}
 	};
 
+	inline double CosineTable::sample(Random& random) const {
+		switch(kind) {
+		case isotropic:
+			return static_cast<const Isotropic*>(this)->Isotropic::operator()(random);
+		case equibins:
+			return static_cast<const EquiBins*>(this)->EquiBins::operator()(random);
+		case tabular_histogram:
+			return static_cast<const Tabular*>(this)->sample<TabularDistribution::histogram>(random);
+		case tabular_linlin:
+			return static_cast<const Tabular*>(this)->sample<TabularDistribution::linlin>(random);
+		default:
+			return (*this)(random);
+		}
+	}
+
 	/*
-	 * Base class to deal with cosine samplers
+	 * Base class to deal with cosine samplers (tagged with its kind, like the cosine tables)
 	 */
 	class MuSampler {
 	public:
-		MuSampler() {/* */}
+		/* Kind of sampler */
+		enum Kind {table, isotropic, other};
+		MuSampler(Kind kind = other) : kind(kind) {/* */}
 		/* Set the cosine with particle's information */
 		virtual void setCosine(const Particle& particle, Random& random, double& mu) const = 0;
+		/* Set the cosine (dispatch using the kind of sampler) */
+		inline void sample(const Particle& particle, Random& random, double& mu) const;
 		/* Print internal data of the sampler */
 		virtual void print(std::ostream& out) const = 0;
 		virtual ~MuSampler() {/* */}
+	private:
+		Kind kind;
 	};
 
 	/*
@@ -158,7 +205,7 @@ namespace AceReaction {
 			/* Sample cosine table */
 			CosineTable* cosine_table = TableSampler<CosineTable*>::sample(energy, random);
 			/* Once we got the table, sample the scattering cosine */
-			mu = (*cosine_table)(random);
+			mu = cosine_table->sample(random);
 			/* Make adjustment (sometimes numerics is a bitch) */
 			if (mu > 1.0) mu = 1.0;
 			else if (mu < -1.0) mu = -1.0;
@@ -178,7 +225,7 @@ namespace AceReaction {
 	class MuIsotropic : public MuSampler {
 		Isotropic isotropic;
 	public:
-		MuIsotropic(const Ace::AngularDistribution& ace_data) {/* */};
+		MuIsotropic(const Ace::AngularDistribution& ace_data) : MuSampler(MuSampler::isotropic) {/* */};
 
 		/* Sample scattering cosine */
 		void setCosine(const Particle& particle, Random& random, double& mu) const {
@@ -192,6 +239,20 @@ namespace AceReaction {
 		~MuIsotropic() {/* */}
 	};
 
+	inline void MuSampler::sample(const Particle& particle, Random& random, double& mu) const {
+		switch(kind) {
+		case table:
+			static_cast<const MuTable*>(this)->MuTable::setCosine(particle, random, mu);
+			break;
+		case isotropic:
+			static_cast<const MuIsotropic*>(this)->MuIsotropic::setCosine(particle, random, mu);
+			break;
+		default:
+			setCosine(particle, random, mu);
+			break;
+		}
+	}
+
 }
 
 }
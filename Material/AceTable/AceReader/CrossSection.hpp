@@ -55,6 +55,9 @@ public:
 	/* Size (real one) */
 	size_t size() const {return xs_data.size() + (ie - 1);}
 
+	/* Memory used by the stored values (in bytes) */
+	size_t getMemory() const {return xs_data.capacity() * sizeof(double);}
+
 	/* Get cross section data */
 	const std::vector<double>& getData() const {return xs_data;}
 	/* Get (FORTRAN) index */
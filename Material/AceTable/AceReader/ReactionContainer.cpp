@@ -232,3 +232,15 @@ void ReactionContainer::update_xs() {
 
 	}
 }
+
+size_t ReactionContainer::getMemory() const {
+	size_t words = energy.capacity();
+	for(const_iterator it = rea_cont.begin() ; it != rea_cont.end() ; ++it)
+		words += (*it).getXs().getSize() + (*it).getAngular().getSize() + (*it).getEnergy().getSize();
+	return words * sizeof(double) + rea_cont.capacity() * sizeof(NeutronReaction);
+}
+
+void ReactionContainer::release() {
+	vector<NeutronReaction>().swap(rea_cont);
+	vector<double>().swap(energy);
+}
@@ -131,6 +131,12 @@ public:
 	/* Get temperature (this is in Mevs) of the isotope */
 	double temp() const {return temperature;}
 
+	/* Approximate memory used by the grid and the reactions (in bytes) */
+	size_t getMemory() const;
+
+	/* Release the grid and the reactions, only the information about the isotope is kept */
+	void release();
+
 	virtual ~ReactionContainer() {/* */};
 };
 
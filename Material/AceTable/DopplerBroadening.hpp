@@ -0,0 +1,202 @@
+/*
+ Copyright (c) 2012, Esteban Pellegrino
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright
+ notice, this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+ * Neither the name of the <organization> nor the
+ names of its contributors may be used to endorse or promote products
+ derived from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DOPPLERBROADENING_HPP_
+#define DOPPLERBROADENING_HPP_
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+namespace Helios {
+
+	/*
+	 * Doppler broadening of a cross section using the free gas model of the target. The effective
+	 * cross section at a temperature T, from data evaluated at T0 < T, is
+	 *
+	 *   s(y) = 1 / (y^2 sqrt(pi)) int x^2 s0(x) [exp(-(x - y)^2) - exp(-(x + y)^2)] dx   (x on (0,inf))
+	 *
+	 * with speeds on units of the most probable speed of the target, y^2 = alpha * E and
+	 * alpha = awr / (k (T - T0)).
+	 *
+	 * The data is linear on energy between the points of the grid, so on each interval the cross section
+	 * is a + b x^2 and the integral is exact (as on the SIGMA1 method) with the moments of the gaussian,
+	 * no matter how narrow the resonances are. Below the grid the cross section goes like 1/v and above it
+	 * is constant. Only the points within a few thermal speeds of the neutron contribute.
+	 */
+	class DopplerBroadening {
+		/* Energy grid of the data and the corresponding speeds */
+		std::vector<double> energies;
+		std::vector<double> speeds;
+		/* Inverse of the energy of the target speed */
+		double alpha;
+
+		/* Half width of the kernel (on units of the target speed) */
+		static double width() {return 6.0;}
+
+		/* Values of the kernel on a point of the grid (for one sign of the neutron speed) */
+		struct Point {
+			double t;     /* Distance to the center of the gaussian */
+			double e;     /* exp(-t^2) */
+			double erfc;  /* erfc(|t|) */
+			Point() : t(0.0), e(0.0), erfc(0.0) {/* */}
+			Point(double t) : t(t), e(exp(-t * t)), erfc(::erfc(fabs(t))) {/* */}
+		};
+
+		/* Moments x^n exp(-(x - c)^2) between two points (n = 1, 2 and 4) */
+		static void getMoments(const Point& p1, const Point& p2, double c, double& m1, double& m2, double& m4) {
+			/* Integral of exp(-t^2) without cancellations on the tails */
+			double diff;
+			if(p1.t >= 0.0) diff = p1.erfc - p2.erfc;
+			else if(p2.t <= 0.0) diff = p2.erfc - p1.erfc;
+			else diff = 2.0 - p1.erfc - p2.erfc;
+			/* Integrals of t^k exp(-t^2) */
+			double f0 = 0.5 * sqrt(M_PI) * diff;
+			double f1 = 0.5 * (p1.e - p2.e);
+			double f2 = 0.5 * f0 + 0.5 * (p1.t * p1.e - p2.t * p2.e);
+			double f3 = f1 + 0.5 * (p1.t * p1.t * p1.e - p2.t * p2.t * p2.e);
+			double f4 = 1.5 * f2 + 0.5 * (p1.t * p1.t * p1.t * p1.e - p2.t * p2.t * p2.t * p2.e);
+			/* Binomial expansion of x = t + c */
+			double c2 = c * c;
+			m1 = c * f0 + f1;
+			m2 = c2 * f0 + 2.0 * c * f1 + f2;
+			m4 = c2 * c2 * f0 + 4.0 * c2 * c * f1 + 6.0 * c2 * f2 + 4.0 * c * f3 + f4;
+		}
+
+	public:
+		/* Kernel for the data on an energy grid */
+		DopplerBroadening(const std::vector<double>& energies, double alpha) : energies(energies), speeds(energies.size()), alpha(alpha) {
+			for(size_t i = 0 ; i < energies.size() ; ++i)
+				speeds[i] = sqrt(alpha * energies[i]);
+		}
+
+		/*
+		 * Broadened values of several cross sections (tabulated on the energy grid) at some energy, the
+		 * kernel is evaluated once for all of them.
+		 */
+		void operator()(double energy, const std::vector<const std::vector<double>*>& xs, std::vector<double>& broadened) const {
+			broadened.assign(xs.size(), 0.0);
+			size_t npoints = speeds.size();
+			if(npoints == 0) return;
+			double y = sqrt(alpha * energy);
+			if(y <= 0.0) {
+				for(size_t n = 0 ; n < xs.size() ; ++n)
+					broadened[n] = (*xs[n])[0];
+				return;
+			}
+
+			/* Points of the grid inside the kernel */
+			double low = std::max(0.0, y - width());
+			double high = y + width();
+			size_t first = std::upper_bound(speeds.begin(), speeds.end(), low) - speeds.begin();
+			first = (first > 0) ? first - 1 : 0;
+			size_t last = std::lower_bound(speeds.begin(), speeds.end(), high) - speeds.begin();
+			last = std::min(last, npoints - 1);
+
+			/* The second gaussian (negative speeds) only contributes near zero */
+			bool mirror = (y < width());
+			Point plus_low(speeds[first] - y), minus_low;
+			if(mirror) minus_low = Point(speeds[first] + y);
+			double m1, m2, m4, n1, n2, n4;
+
+			/* Below the grid the cross section goes like 1/v (x^2 s0(x) = s0(x0) x0 x) */
+			if(first == 0 && speeds[0] > 0.0 && speeds[0] > low) {
+				getMoments(Point(low - y), plus_low, y, m1, m2, m4);
+				if(mirror) {
+					getMoments(Point(low + y), minus_low, -y, n1, n2, n4);
+					m1 -= n1;
+				}
+				for(size_t n = 0 ; n < xs.size() ; ++n)
+					broadened[n] += (*xs[n])[0] * speeds[0] * m1;
+			}
+
+			/* Linear interpolation on energy, s0 = a + b x^2 */
+			for(size_t j = first ; j < last ; ++j) {
+				Point plus_high(speeds[j + 1] - y), minus_high;
+				getMoments(plus_low, plus_high, y, m1, m2, m4);
+				if(mirror) {
+					minus_high = Point(speeds[j + 1] + y);
+					getMoments(minus_low, minus_high, -y, n1, n2, n4);
+					m2 -= n2;
+					m4 -= n4;
+				}
+				double delta = energies[j + 1] - energies[j];
+				if(delta > 0.0) {
+					for(size_t n = 0 ; n < xs.size() ; ++n) {
+						const std::vector<double>& values = *xs[n];
+						double slope = (values[j + 1] - values[j]) / delta;
+						broadened[n] += (values[j] - slope * energies[j]) * m2 + (slope / alpha) * m4;
+					}
+				}
+				plus_low = plus_high;
+				minus_low = minus_high;
+			}
+
+			/* Above the grid the cross section is constant */
+			if(last == npoints - 1 && speeds[last] < high) {
+				/* Both exp(-t^2) and erfc(t) vanish at infinity */
+				Point infinity;
+				infinity.t = 1.0;
+				getMoments(plus_low, infinity, y, m1, m2, m4);
+				if(mirror) {
+					getMoments(minus_low, infinity, -y, n1, n2, n4);
+					m2 -= n2;
+				}
+				for(size_t n = 0 ; n < xs.size() ; ++n)
+					broadened[n] += (*xs[n])[last] * m2;
+			}
+
+			double norm = 1.0 / (y * y * sqrt(M_PI));
+			for(size_t n = 0 ; n < xs.size() ; ++n)
+				broadened[n] *= norm;
+		}
+
+		/* Broadened value of one cross section at some energy */
+		double operator()(double energy, const std::vector<double>& xs) const {
+			std::vector<const std::vector<double>*> values(1, &xs);
+			std::vector<double> broadened;
+			(*this)(energy, values, broadened);
+			return broadened[0];
+		}
+
+		/* Broaden several cross sections on each point of the energy grid */
+		void broaden(const std::vector<const std::vector<double>*>& xs, std::vector<std::vector<double> >& broadened) const {
+			broadened.assign(xs.size(), std::vector<double>(energies.size(), 0.0));
+			std::vector<double> values;
+			for(size_t i = 0 ; i < energies.size() ; ++i) {
+				(*this)(energies[i], xs, values);
+				for(size_t n = 0 ; n < xs.size() ; ++n)
+					broadened[n][i] = values[n];
+			}
+		}
+
+		~DopplerBroadening() {/* */}
+	};
+
+} /* namespace Helios */
+
+#endif /* DOPPLERBROADENING_HPP_ */
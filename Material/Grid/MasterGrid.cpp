@@ -25,7 +25,9 @@
  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 #include <algorithm>
+#include <functional>
 #include <cassert>
+#include <cmath>
 
 #include "MasterGrid.hpp"
 #include "../../Common/Common.hpp"
@@ -37,26 +39,72 @@ namespace Helios {
 /* By default, 10000 points are reserved for the grid */
 size_t MasterGrid::reserve_grid = 10000;
 
-MasterGrid::MasterGrid(){
+MasterGrid::MasterGrid() : thinned(false) {
 	/* Reserve space for the grids */
 	master_grid.reserve(reserve_grid);
 };
 
+/* Union of two sorted grids (without repeated points) */
+static void mergeGrids(const vector<double>& first, const vector<double>& second, vector<double>& merged) {
+	merged.resize(first.size() + second.size());
+	merge(first.begin(), first.end(), second.begin(), second.end(), merged.begin());
+	merged.resize(unique(merged.begin(), merged.end()) - merged.begin());
+}
+
 void MasterGrid::setup() {
-	/* Setup MASTER grid */
-	sort(master_grid.begin(), master_grid.end());
-	vector<double>::const_iterator it_master = unique(master_grid.begin(), master_grid.end());
-	master_grid.resize(it_master - master_grid.begin());
+	/* Sorted copy of the child grids that are not ordered (ACE grids are already sorted) */
+	vector<vector<double> > unsorted;
+	vector<const vector<double>*> grids;
+	for(vector<ChildGrid*>::const_iterator it = child_grids.begin() ; it != child_grids.end() ; ++it) {
+		const vector<double>& child_grid = (*it)->child_grid;
+		if(adjacent_find(child_grid.begin(), child_grid.end(), greater<double>()) == child_grid.end())
+			grids.push_back(&child_grid);
+		else
+			unsorted.push_back(child_grid);
+	}
+	for(vector<vector<double> >::iterator it = unsorted.begin() ; it != unsorted.end() ; ++it) {
+		sort(it->begin(), it->end());
+		grids.push_back(&(*it));
+	}
+
+	/* Setup MASTER grid, merging pairs of grids in parallel until only one is left */
+	vector<vector<double> > merged;
+	while(grids.size() > 1) {
+		vector<vector<double> > level(grids.size() / 2);
+		#pragma omp parallel for
+		for(int i = 0 ; i < (int)level.size() ; ++i)
+			mergeGrids(*grids[2 * i], *grids[2 * i + 1], level[i]);
+		/* The last grid goes to the next level without changes */
+		if(grids.size() % 2)
+			level.push_back(*grids.back());
+		merged.swap(level);
+		grids.clear();
+		for(vector<vector<double> >::const_iterator it = merged.begin() ; it != merged.end() ; ++it)
+			grids.push_back(&(*it));
+	}
+	master_grid.clear();
+	if(grids.size())
+		master_grid.insert(master_grid.end(), grids[0]->begin(), grids[0]->end());
+	master_grid.resize(unique(master_grid.begin(), master_grid.end()) - master_grid.begin());
 
 	/* Setup child grids */
-	for(vector<ChildGrid*>::const_iterator it = child_grids.begin() ; it != child_grids.end() ; ++it) {
+	setupChilds();
+}
+
+void MasterGrid::setupChilds() {
+	/* Each child is independent of the others */
+	#pragma omp parallel for
+	for(int n = 0 ; n < (int)child_grids.size() ; ++n) {
+		const vector<double>& child_grid = child_grids[n]->child_grid;
 		/* Create master array of pointers */
 		vector<size_t> master_pointers(size());
 
 		/* Energy limits on child grid */
-		double min_energy = (*it)->child_grid[0];
-		double max_energy = (*it)->child_grid[(*it)->size() - 1];
+		double min_energy = child_grid[0];
+		double max_energy = child_grid[child_grid.size() - 1];
 
+		/* Both grids are ordered, so the index on the child grid only moves forward */
+		size_t child_index = 0;
 		for(size_t i = 0 ; i < size() ; ++i) {
 			/* Energy value (on the master grid) */
 			double energy = master_grid[i];
@@ -66,17 +114,58 @@ void MasterGrid::setup() {
 				master_pointers[i] = 0;
 			else if(energy >= max_energy)
 				/* Set the pointer to the end of the grid */
-				master_pointers[i] = (*it)->size() - 2;
-			else
-				/* Get the index on the child grid */
-				master_pointers[i] = upper_bound((*it)->child_grid.begin(), (*it)->child_grid.end(), energy) - (*it)->child_grid.begin() - 1;
+				master_pointers[i] = child_grid.size() - 2;
+			else {
+				/* Get the index on the child grid (last point lower or equal than the energy) */
+				while(child_grid[child_index + 1] <= energy)
+					++child_index;
+				master_pointers[i] = child_index;
+			}
 		}
 
 		/* Setup master pointer */
-		(*it)->setup(master_pointers);
+		child_grids[n]->setup(master_pointers);
 	}
 }
 
+bool MasterGrid::isLinear(const vector<vector<double> >& values, size_t start, size_t end, double tolerance) const {
+	double delta = master_grid[end] - master_grid[start];
+	for(vector<vector<double> >::const_iterator it = values.begin() ; it != values.end() ; ++it) {
+		const vector<double>& value = *it;
+		for(size_t i = start + 1 ; i < end ; ++i) {
+			/* Value interpolated between the two points */
+			double factor = (master_grid[i] - master_grid[start]) / delta;
+			double inter = value[start] + factor * (value[end] - value[start]);
+			if(fabs(inter - value[i]) > tolerance * fabs(value[i]))
+				return false;
+		}
+	}
+	return true;
+}
+
+size_t MasterGrid::thin(const vector<vector<double> >& values, double tolerance) {
+	if(size() < 3) return 0;
+	/* Points kept on the grid */
+	vector<double> thin_grid;
+	thin_grid.push_back(master_grid[0]);
+	/* Extend the interval from the last point kept while the points inside are linear */
+	size_t start = 0;
+	for(size_t end = 2 ; end < size() ; ++end) {
+		if(end - start > thinning_span || !isLinear(values, start, end, tolerance)) {
+			start = end - 1;
+			thin_grid.push_back(master_grid[start]);
+		}
+	}
+	thin_grid.push_back(master_grid[size() - 1]);
+
+	/* Update grid and the pointers of the childs */
+	size_t removed = size() - thin_grid.size();
+	master_grid.swap(thin_grid);
+	thinned = thinned || removed > 0;
+	setupChilds();
+	return removed;
+}
+
 double MasterGrid::interpolate(pair<size_t,double>& pair_value) const {
 	/* Maximum and minimum values for energy */
 	double min_energy = master_grid[0];
@@ -202,9 +291,8 @@ MasterGrid::~MasterGrid() {
 };
 
 void ChildGrid::setup(const std::vector<size_t>& _master_pointers) {
-	master_pointers.reserve(_master_pointers.size());
-	/* Copy data */
-	master_pointers.insert(master_pointers.end(), _master_pointers.begin(), _master_pointers.end());
+	/* Replace the pointers and release the old storage (the master grid could have been thinned) */
+	vector<size_t>(_master_pointers).swap(master_pointers);
 }
 
 size_t ChildGrid::index(std::pair<size_t,double>& pair_value, double& factor) const {
@@ -227,6 +315,17 @@ size_t ChildGrid::index(std::pair<size_t,double>& pair_value, double& factor) co
 	/* Get index from master grid */
 	master_grid->setIndex(pair_value);
 	size_t child_index = master_pointers[pair_value.first];
+	/*
+	 * On a thinned master grid there could be several child points between two master points, all of them
+	 * are between the pointers of both master points (usually there is none)
+	 */
+	if(master_grid->isThinned()) {
+		size_t next_index = master_pointers[pair_value.first + 1];
+		if(next_index > child_index) {
+			vector<double>::const_iterator begin = child_grid.begin();
+			child_index = upper_bound(begin + child_index + 1, begin + next_index + 1, energy) - begin - 1;
+		}
+	}
 	/* Energy bounds */
 	double low_energy = child_grid[child_index];
 	double high_energy = child_grid[child_index + 1];
@@ -235,6 +334,13 @@ size_t ChildGrid::index(std::pair<size_t,double>& pair_value, double& factor) co
 	return child_index;
 }
 
+size_t MasterGrid::getMemory() const {
+	size_t memory = master_grid.capacity() * sizeof(double);
+	for(vector<ChildGrid*>::const_iterator it = child_grids.begin() ; it != child_grids.end() ; ++it)
+		memory += (*it)->getMemory();
+	return memory;
+}
+
 void ChildGrid::print(std::ostream& out) const {
 	out << Log::ident(1) << "Child grid" << endl;
 	out << Log::ident(2) << " - Size of the child grid : " << child_grid.size() << endl;
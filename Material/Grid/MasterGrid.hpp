@@ -49,6 +49,18 @@ namespace Helios {
 
 		/* Container of child */
 		std::vector<ChildGrid*> child_grids;
+
+		/* Flag if points were removed from the grid (a child could have several points between two master points) */
+		bool thinned;
+
+		/* Maximum number of consecutive points removed when the grid is thinned */
+		static const size_t thinning_span = 32;
+
+		/* Set the pointers of each child grid to the master grid */
+		void setupChilds();
+
+		/* Check if the values between two points on the grid are linear within some tolerance */
+		bool isLinear(const std::vector<std::vector<double> >& values, size_t start, size_t end, double tolerance) const;
 	public:
 		/* Number of elements to reserve for the grid */
 		static size_t reserve_grid;
@@ -75,6 +87,16 @@ namespace Helios {
 		 */
 		void setup();
 
+		/*
+		 * Remove points of the grid where all the functions tabulated on it (i.e. cross sections)
+		 * are linear within a relative tolerance. Each vector on <values> should have the size of the
+		 * master grid. Returns the number of points removed.
+		 */
+		size_t thin(const std::vector<std::vector<double> >& values, double tolerance);
+
+		/* Check if points were removed from the grid */
+		bool isThinned() const {return thinned;}
+
 		/* --- Interpolation */
 
 		/* Set index on the pair and return interpolation factor */
@@ -86,6 +108,9 @@ namespace Helios {
 		/* Given a pair of index-value, set the index on the master grid */
 		void setIndex(std::pair<size_t,double>& pair_value) const;
 
+		/* Memory used by the master grid and the child grids (in bytes) */
+		size_t getMemory() const;
+
 		/* Print grid information */
 		void print(std::ostream& out) const;
 
@@ -120,12 +145,20 @@ namespace Helios {
 		/* Size of the CHILD grid */
 		size_t size() const {return child_grid.size();}
 
+		/* Number of pointers to the MASTER grid (one for each point of the MASTER grid) */
+		size_t pointers() const {return master_pointers.size();}
+
 		/* Access value on the grid (constant reference because a client can't modify the grid from here). */
 		double operator[](size_t index) const {return child_grid[index];}
 
 		/* Set MASTER index on the pair, return the index and set interpolation factor on the child grid */
 		size_t index(std::pair<size_t,double>& pair_value, double& factor) const;
 
+		/* Memory used by the child grid and the pointers to the master grid (in bytes) */
+		size_t getMemory() const {
+			return child_grid.capacity() * sizeof(double) + master_pointers.capacity() * sizeof(size_t);
+		}
+
 		/* Print grid information */
 		void print(std::ostream& out) const;
 
@@ -134,10 +167,7 @@ namespace Helios {
 
 	template<class InputIterator>
 	ChildGrid* MasterGrid::pushGrid(InputIterator first, InputIterator last) {
-		/* Push data into the common grid */
-		master_grid.insert(master_grid.end(), first, last);
-
-		/* Create child grid */
+		/* Create child grid (the union is done when the master grid is setup) */
 		std::vector<double> child_grid;
 		child_grid.reserve(last - first);
 		child_grid.insert(child_grid.end(), first, last);
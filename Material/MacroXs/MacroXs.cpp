@@ -38,7 +38,7 @@ MacroXsReaction::Fission::Fission(const std::vector<double>& nu, const std::vect
 	std::map<int,double> m;
 	for(size_t i = 0 ; i < chi.size() ; ++i)
 		m[i] = chi[i];
-	spectrum = new Sampler<int>(m);
+	spectrum = new AliasSampler<int>(m);
 }
 
 MacroXsReaction::Fission::~Fission() {
@@ -56,7 +56,7 @@ MacroXsReaction::Scattering::Scattering(const std::vector<double>& sigma_scat, s
 			v[j] = sigma_scat[j * ngroups + i];
 		m[i] = v;
 	}
-	spectrum = new Sampler<int>(m);
+	spectrum = new AliasSampler<int>(m);
 }
 
 MacroXsReaction::Scattering::~Scattering() {
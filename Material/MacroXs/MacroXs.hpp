@@ -31,7 +31,7 @@
 #include <map>
 
 #include "../Material.hpp"
-#include "../../Common/Sampler.hpp"
+#include "../../Common/AliasSampler.hpp"
 
 namespace Helios {
 
@@ -51,7 +51,7 @@ namespace Helios {
 			/* NU value for each group */
 			std::vector<double> nu;
 			/* Spectrum sampler */
-			Sampler<int>* spectrum;
+			AliasSampler<int>* spectrum;
 		public:
 			Fission(const std::vector<double>& nu, const std::vector<double>& chi);
 			void operator() (Particle& particle, Random& r) const {
@@ -74,7 +74,7 @@ namespace Helios {
 		 */
 		class Scattering : public Reaction {
 			/* Spectrum sampler */
-			Sampler<int>* spectrum;
+			AliasSampler<int>* spectrum;
 		public:
 			Scattering(const std::vector<double>& sigma_scat, size_t ngroups);
 			void operator() (Particle& particle, Random& r) const{
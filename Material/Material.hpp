@@ -103,6 +103,9 @@ namespace Helios {
 		/* Check if the material is fissile */
 		bool isFissile() const {return fissile;}
 
+		/* Approximate memory used by the tables of the material (in bytes, isotopes are not included) */
+		virtual size_t getMemory() const {return 0;}
+
 		virtual ~Material() {/* */};
 
 	protected:
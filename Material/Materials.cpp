@@ -96,6 +96,14 @@ void Materials::print(std::ostream& out) const {
 	}
 }
 
+size_t Materials::getMemory() const {
+	size_t memory = 0;
+	vector<Material*>::const_iterator it_mat = materials.begin();
+	for(; it_mat != materials.end() ; it_mat++)
+		memory += (*it_mat)->getMemory();
+	return memory;
+}
+
 Materials::~Materials() {
 	/* Delete materials */
 	purgePointers(materials);
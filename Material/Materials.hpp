@@ -100,6 +100,9 @@ namespace Helios {
 		/* Print a list of materials on the container */
 		void print(std::ostream& out) const;
 
+		/* Memory used by the tables of all materials (in bytes) */
+		size_t getMemory() const;
+
 		virtual ~Materials();
 	};
 
@@ -54,6 +54,29 @@ static FeatureObject* latticeAttrib(TiXmlElement* pElement) {
 	return new LatticeObject(id,type,dimension,width,universes);
 }
 
+/* Parse pin attributes */
+static FeatureObject* pinAttrib(TiXmlElement* pElement) {
+	/* Initialize XML attribute checker */
+	static const string required[4] = {"id","type","radius","materials"};
+	static const string optional[1] = {"center"};
+	static XmlParser::XmlAttributes pinAttrib(vector<string>(required, required + 4), vector<string>(optional, optional + 1));
+	/* Center of the pin */
+	XmlParser::AttributeValue<string> inp_center("center","0 0");
+
+	XmlParser::AttribMap mapAttrib = dump_attribs(pElement);
+	/* Check user input */
+	pinAttrib.checkAttributes(mapAttrib,"pin");
+
+	/* Get attributes */
+	UniverseId id = fromString<UniverseId>(mapAttrib["id"]);
+	string type = mapAttrib["type"];
+	vector<double> center = getContainer<double>(inp_center.getString(mapAttrib));
+	vector<double> radius = getContainer<double>(mapAttrib["radius"]);
+	vector<MaterialId> materials = getContainer<MaterialId>(mapAttrib["materials"]);
+	/* Return pin definition */
+	return new PinObject(id,type,center,radius,materials);
+}
+
 /* Initialization of values on the surface flag */
 static map<string,Surface::SurfaceInfo> initSurfaceInfo() {
 	map<string,Surface::SurfaceInfo> values_map;
@@ -152,6 +175,8 @@ void XmlParser::geoNode(TiXmlNode* pParent) {
 				objects.push_back(cellAttrib(pChild->ToElement()));
 			else if (element_value == "lattice")
 				objects.push_back(latticeAttrib(pChild->ToElement()));
+			else if (element_value == "pin")
+				objects.push_back(pinAttrib(pChild->ToElement()));
 			else {
 				vector<string> keywords;
 				keywords.push_back(element_value);
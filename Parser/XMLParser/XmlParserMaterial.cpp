@@ -98,11 +98,13 @@ static map<string,string> initFraction() {
 static vector<McObject*> aceAttrib(TiXmlElement* pElement) {
 	/* Initialize XML attribute checker */
 	static const string required[2] = {"id","density"};
-	static const string optional[3] = {"dataset","units","fraction"};
-	static XmlParser::XmlAttributes matAttrib(vector<string>(required, required + 2), vector<string>(optional, optional + 3));
+	static const string optional[4] = {"dataset","units","fraction","temperature"};
+	static XmlParser::XmlAttributes matAttrib(vector<string>(required, required + 2), vector<string>(optional, optional + 4));
 
 	/* DataSet information */
 	XmlParser::AttributeValue<string> inp_dataset("dataset","");
+	/* Temperature of the material (in kelvin, by default the one of the data) */
+	XmlParser::AttributeValue<string> inp_temperature("temperature","");
 
 	/* Check flags */
 	XmlParser::AttributeValue<string> units_flag("units","atom/b-cm",initUnits());
@@ -121,6 +123,10 @@ static vector<McObject*> aceAttrib(TiXmlElement* pElement) {
 	string units = units_flag.getValue(mapAttrib);
 	string fraction = fraction_flag.getValue(mapAttrib);
 	string dataset = inp_dataset.getString(mapAttrib);
+	double temperature = 0.0;
+	string temperature_value = inp_temperature.getString(mapAttrib);
+	if(temperature_value != "")
+		temperature = fromString<double>(temperature_value) * Constant::boltz;
 
 	/* Push all the ACE objects (including the isotopes) */
 	vector<McObject*> ace_objects;
@@ -169,7 +175,7 @@ static vector<McObject*> aceAttrib(TiXmlElement* pElement) {
 		}
 	}
 	/* Return surface definition */
-	ace_objects.push_back(new AceMaterialObject(id, density, units, fraction, isotopes));
+	ace_objects.push_back(new AceMaterialObject(id, density, units, fraction, isotopes, temperature));
 	return ace_objects;
 }
 
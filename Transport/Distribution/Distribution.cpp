@@ -136,21 +136,21 @@ DistributionCustom::DistributionCustom(const DistributionBaseObject* definition,
 	/* Weights of each sampler */
 	std::vector<double> weights = distObject->getWeights();
 	/* Create sampler */
-	distribution_sampler = new Sampler<DistributionBase*>(distPtrs,weights);
+	distribution_sampler = new AliasSampler<DistributionBase*>(distPtrs,weights);
 }
 
 void DistributionCustom::print(std::ostream& out) const {
 	out << endl;
 	/* Get distributions */
 	vector<DistributionBase*> distributions = distribution_sampler->getReactions();
-	/* Reaction matrix */
-	const double* reaction_matrix = distribution_sampler->getReactionMatrix();
+	/* Probability of each distribution */
+	const double* probabilities = distribution_sampler->getProbabilities();
 	/* Print each distributions */
 	size_t i = 0;
 	for( ; i < distributions.size() - 1 ; ++i)
-		out << Log::ident(3) << " - ( cdf = " << fixed << reaction_matrix[i] << " ) " << *distributions[i] << endl;
+		out << Log::ident(3) << " - ( prob = " << fixed << probabilities[i] << " ) " << *distributions[i] << endl;
 	/* Last one... */
-	out << Log::ident(3) << " - ( cdf = " << 1.0 << " ) " << *distributions[i];
+	out << Log::ident(3) << " - ( prob = " << fixed << probabilities[i] << " ) " << *distributions[i];
 }
 
 DistributionCustomObject::DistributionCustomObject(const std::string& type, const DistributionId& distid,
@@ -29,7 +29,7 @@
 #define DISTRIBUTION_HPP_
 
 #include "../../Common/Common.hpp"
-#include "../../Common/Sampler.hpp"
+#include "../../Common/AliasSampler.hpp"
 #include "../SourceObject.hpp"
 #include "../Particle.hpp"
 
@@ -143,7 +143,7 @@ namespace Helios {
 		}
 		void print(std::ostream& out) const;
 		/* Sampler of ParticleSampler(s) */
-		Sampler<DistributionBase*>* distribution_sampler;
+		AliasSampler<DistributionBase*>* distribution_sampler;
 	};
 
 	std::ostream& operator<<(std::ostream& out, const DistributionBase& q);
@@ -153,20 +153,17 @@ ParticleSource::ParticleSource(const ParticleSourceObject* definition, const Sou
 	/* Get weight of each sampler */
 	std::vector<double> weights = definition->getWeights();
 	/* Create a sampler */
-	source_sampler = new Sampler<ParticleSampler*>(samplers,weights);
+	source_sampler = new AliasSampler<ParticleSampler*>(samplers,weights);
 }
 
 std::ostream& operator<<(std::ostream& out, const ParticleSource& q) {
 	/* Get distributions */
 	vector<ParticleSampler*> samplers = q.source_sampler->getReactions();
-	/* Reaction matrix */
-	const double* reaction_matrix = q.source_sampler->getReactionMatrix();
+	/* Probability of each sampler */
+	const double* probabilities = q.source_sampler->getProbabilities();
 	/* Print each distributions */
-	size_t i = 0;
-	for( ; i < samplers.size() - 1 ; ++i)
-		out << Log::ident(1) << " ( cdf = " << fixed << reaction_matrix[i] << " ) " << *samplers[i];
-	/* Last one... */
-	out << Log::ident(1) << " ( cdf = " << 1.0 << " ) " << *samplers[i];
+	for(size_t i = 0 ; i < samplers.size() ; ++i)
+		out << Log::ident(1) << " ( prob = " << fixed << probabilities[i] << " ) " << *samplers[i];
 	return out;
 }
 
@@ -31,7 +31,7 @@
 #include <vector>
 
 #include "../Common/Common.hpp"
-#include "../Common/Sampler.hpp"
+#include "../Common/AliasSampler.hpp"
 #include "../Geometry/Geometry.hpp"
 #include "SourceObject.hpp"
 #include "Distribution/Distribution.hpp"
@@ -173,7 +173,7 @@ namespace Helios {
 	private:
 
 		/* Sampler of ParticleSampler(s) */
-		Sampler<ParticleSampler*>* source_sampler;
+		AliasSampler<ParticleSampler*>* source_sampler;
 		/* Strength of this source */
 		double strength;
 		/* Geometry of the problem */
@@ -97,7 +97,7 @@ Source::Source(const vector<McObject*>& definitions, const McEnvironment* enviro
 	Log::msg() << left << Log::ident(1) << " - Total number of source        : " << sources.size() << Log::endl;
 
 	/* Once we got all the sources, we should create the sampler */
-	source_sampler = new Sampler<ParticleSource*>(sources,strengths);
+	source_sampler = new AliasSampler<ParticleSource*>(sources,strengths);
 }
 
 /* Sample a particle */
@@ -126,14 +126,11 @@ CellParticle Source::sample(Random& r) const {
 void Source::print(std::ostream& out) const {
 	/* Get distributions */
 	vector<ParticleSource*> samplers = source_sampler->getReactions();
-	/* Reaction matrix */
-	const double* reaction_matrix = source_sampler->getReactionMatrix();
+	/* Probability of each source */
+	const double* probabilities = source_sampler->getProbabilities();
 	/* Print each distributions */
-	size_t i = 0;
-	for( ; i < samplers.size() - 1 ; ++i)
-		out << " ( cdf = " << reaction_matrix[i] << " ) " << endl << *samplers[i];
-	/* Last one... */
-	out << " ( cdf =  1.0 ) "<< endl << *samplers[i];
+	for(size_t i = 0 ; i < samplers.size() ; ++i)
+		out << " ( prob = " << probabilities[i] << " ) " << endl << *samplers[i];
 }
 
 template<>
@@ -30,7 +30,7 @@
 
 #include <map>
 #include <vector>
-#include "../Common/Sampler.hpp"
+#include "../Common/AliasSampler.hpp"
 #include "SourceObject.hpp"
 #include "ParticleSource.hpp"
 
@@ -58,7 +58,7 @@ namespace Helios {
 		std::vector<ParticleSource*> sources;
 
 		/* A sampler of sources */
-		Sampler<ParticleSource*>* source_sampler;
+		AliasSampler<ParticleSource*>* source_sampler;
 
 		/* Once the definitions are dispatched, setup source with this function */
 		void setupSource(std::vector<DistributionBaseObject*>& distObject,